@@ -2,7 +2,7 @@
 
 unzip HiGHS-1.10.0.zip
 cd HiGHS-1.10.0
-cmake -S. -B build -DCMAKE_INSTALL_PREFIX=./
+cmake -S. -B build -DCMAKE_INSTALL_PREFIX=./ -DBUILD_SHARED_LIBS=OFF
 cmake --build build --parallel
 cd build
 make install
\ No newline at end of file
@@ -0,0 +1,300 @@
+/*=====================================================================================
+
+    Filename:     Bench.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "Bench.h"
+#include <csignal>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+Bench::Bench()
+    : usedCores_(0)
+{
+}
+
+bool Bench::ParseConfigs()
+{
+  stringstream configStream(OPT(config));
+  string item;
+  while (getline(configStream, item, ';'))
+  {
+    const size_t first = item.find(':');
+    const size_t last = item.rfind(':');
+    if (first == string::npos || first == last)
+    {
+      printf("c Bench: bad config \"%s\", expected name:binary:threads\n", item.c_str());
+      return false;
+    }
+    BenchConfig config;
+    config.name = item.substr(0, first);
+    config.binary = item.substr(first + 1, last - first - 1);
+    stringstream threadStream(item.substr(last + 1));
+    string threads;
+    while (getline(threadStream, threads, ','))
+      config.threads.push_back(stoi(threads));
+    if (!filesystem::exists(config.binary) || config.threads.empty())
+    {
+      printf("c Bench: config \"%s\" has no binary or no thread count\n", item.c_str());
+      return false;
+    }
+    configs_.push_back(config);
+  }
+  return !configs_.empty();
+}
+
+bool Bench::ReadInstances()
+{
+  ifstream list(OPT(list));
+  if (!list.is_open())
+  {
+    printf("c Bench: cannot read instance list %s\n", OPT(list).c_str());
+    return false;
+  }
+  string instance;
+  size_t missingNum = 0;
+  while (list >> instance)
+  {
+    if (filesystem::exists(filesystem::path(OPT(instanceDir)) / instance))
+      instances_.push_back(instance);
+    else
+      missingNum++;
+  }
+  printf("c Bench: %ld instances on disk; %ld listed instances missing\n",
+         instances_.size(), missingNum);
+  return !instances_.empty();
+}
+
+void Bench::Launch(BenchRun &_run)
+{
+  const string instancePath = (filesystem::path(OPT(instanceDir)) / _run.instance).string();
+  const string threads = to_string(_run.threads);
+  const string cutoff = to_string(OPT(cutoff));
+  // A solution file left by an earlier run must not pass for this one's.
+  filesystem::remove(_run.solutionPath);
+  _run.startTime = ElapsedTime();
+  _run.pid = fork();
+  if (_run.pid == 0)
+  {
+    const int fd = open(_run.logPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0)
+    {
+      dup2(fd, STDOUT_FILENO);
+      dup2(fd, STDERR_FILENO);
+      close(fd);
+    }
+    execl(_run.binary.c_str(), _run.binary.c_str(),
+          "-i", instancePath.c_str(), "-t", threads.c_str(), "-c", cutoff.c_str(),
+          "--profile", _run.profilePath.c_str(), "--solution", _run.solutionPath.c_str(),
+          (char *)nullptr);
+    _exit(127);
+  }
+  usedCores_ += _run.threads;
+  activeRuns_.push_back(_run);
+}
+
+/* Collect finished runs and kill the ones past the timeout; returns whether
+   any core was freed. */
+bool Bench::Reap()
+{
+  bool freed = false;
+  for (size_t idx = 0; idx < activeRuns_.size();)
+  {
+    BenchRun &run = activeRuns_[idx];
+    int status;
+    if (waitpid(run.pid, &status, WNOHANG) == 0)
+    {
+      if (ElapsedTime() - run.startTime > OPT(timeout))
+        kill(run.pid, SIGKILL);
+      idx++;
+      continue;
+    }
+    RunResult result = ParseRunLog(run.label, run.instance, run.logPath, run.profilePath, run.solutionPath);
+    printf("c %10.2lf    [%-10s]    %s %s %s %.2lf\n",
+           ElapsedTime(), "Done", run.label.c_str(), run.instance.c_str(),
+           RunStatusToString(result.status), ElapsedTime() - run.startTime);
+    results_[run.label].push_back(result);
+    usedCores_ -= run.threads;
+    activeRuns_.erase(activeRuns_.begin() + idx);
+    freed = true;
+  }
+  return freed;
+}
+
+void Bench::Execute()
+{
+  while (!pendingRuns_.empty() || !activeRuns_.empty())
+  {
+    // A run wider than the budget still gets the machine to itself.
+    while (!pendingRuns_.empty() &&
+           (usedCores_ + pendingRuns_.front().threads <= (size_t)OPT(cores) || usedCores_ == 0))
+    {
+      Launch(pendingRuns_.front());
+      pendingRuns_.pop_front();
+    }
+    if (!Reap())
+      usleep(100000);
+  }
+}
+
+bool Bench::Summarize()
+{
+  bool passed = true;
+  printf("c-----------------------summary----------------------\n");
+  printf("c %-24s %8s %8s %10s %8s %10s %8s %10s %8s %8s\n",
+         "Config", "Solved", "Runs", "SGM(s)", "Shared", "SSGM(s)", "BSolved", "BSGM(s)", "Speedup", "Util(%)");
+  for (auto &[label, results] : results_)
+  {
+    sort(results.begin(), results.end(),
+         [](const RunResult &_a, const RunResult &_b)
+         { return _a.instance < _b.instance; });
+    WriteResultFile((filesystem::path(OPT(outPath)) / (label + ".txt")).string(), results);
+
+    // Unsolved runs count as the cutoff, as in the paper's tables. The
+    // baseline is compared over the instances both runs have.
+    map<string, RunResult> baseline;
+    const bool haveBaseline = ReadResultFile(
+        (filesystem::path(OPT(baseline)) / (label + ".txt")).string(), baseline);
+    vector<double> times, sharedTimes, baseTimes;
+    vector<string> newInstances;
+    size_t solvedNum = 0, baseSolvedNum = 0;
+    double utilization = 0;
+    size_t profileNum = 0;
+    map<string, double> phaseTime;
+    for (const RunResult &result : results)
+    {
+      solvedNum += result.IsSolved();
+      times.push_back(result.IsSolved() ? result.time : OPT(cutoff));
+      if (haveBaseline && baseline.count(result.instance) > 0)
+      {
+        const RunResult &baseResult = baseline[result.instance];
+        baseSolvedNum += baseResult.IsSolved();
+        sharedTimes.push_back(times.back());
+        baseTimes.push_back(baseResult.IsSolved() ? baseResult.time : OPT(cutoff));
+        baseline.erase(result.instance);
+      }
+      else if (haveBaseline)
+        newInstances.push_back(result.instance);
+      if (result.utilization < INF)
+      {
+        utilization += result.utilization;
+        profileNum++;
+      }
+      for (auto &[phase, time] : result.phaseTime)
+        phaseTime[phase] += time;
+    }
+    const double sgm = ShiftedGeoMean(times, OPT(shift));
+    const double sharedSgm = ShiftedGeoMean(sharedTimes, OPT(shift));
+    const double baseSgm = ShiftedGeoMean(baseTimes, OPT(shift));
+    if (!baseTimes.empty())
+      printf("c %-24s %8ld %8ld %10.2lf %8ld %10.2lf %8ld %10.2lf %8.2lf %8.2lf\n",
+             label.c_str(), solvedNum, results.size(), sgm, sharedTimes.size(), sharedSgm,
+             baseSolvedNum, baseSgm, baseSgm / sharedSgm, profileNum > 0 ? utilization / profileNum : 0.0);
+    else
+      printf("c %-24s %8ld %8ld %10.2lf %8s %10s %8s %10s %8s %8.2lf\n",
+             label.c_str(), solvedNum, results.size(), sgm, "-", "-", "-", "-", "-",
+             profileNum > 0 ? utilization / profileNum : 0.0);
+    for (const string &instance : newInstances)
+      printf("c     %-20s not in the baseline\n", instance.c_str());
+    for (auto &[instance, baseResult] : baseline)
+      printf("c     %-20s only in the baseline\n", instance.c_str());
+    for (auto &[phase, time] : phaseTime)
+      printf("c     %-20s %12.2lf s\n", phase.c_str(), time);
+    if (OPT(maxSlowdown) > 0 && !baseTimes.empty() && sharedSgm > baseSgm * (1 + OPT(maxSlowdown)))
+    {
+      printf("c Bench: %s slowed down from %.2lf s to %.2lf s\n", label.c_str(), baseSgm, sharedSgm);
+      passed = false;
+    }
+  }
+  printf("c-----------------------------------------------------\n");
+  return passed;
+}
+
+static bool SameObjective(const double _obj, const double _otherObj)
+{
+  return fabs(_obj - _otherObj) <= 1e-6 * max(1.0, fabs(_otherObj));
+}
+
+bool Bench::CheckObjectives()
+{
+  map<string, double> reference;
+  if (!OPT(reference).empty())
+  {
+    ifstream file(OPT(reference));
+    string instance;
+    double obj;
+    while (file >> instance >> obj)
+      reference[instance] = obj;
+  }
+  bool passed = true;
+  map<string, pair<string, double>> firstOptimal;
+  for (const auto &[label, results] : results_)
+    for (const RunResult &result : results)
+    {
+      if (result.obj < INF && (result.solutionObj == INF || !SameObjective(result.solutionObj, result.obj)))
+      {
+        printf("c Bench: %s %s reports %lf, but its solution file holds %lf\n",
+               label.c_str(), result.instance.c_str(), result.obj, result.solutionObj);
+        passed = false;
+      }
+      if (result.status != RunStatus::Optimal && result.status != RunStatus::Infeasible)
+        continue;
+      auto known = reference.find(result.instance);
+      if (known != reference.end() &&
+          (result.status == RunStatus::Infeasible || !SameObjective(result.obj, known->second)))
+      {
+        printf("c Bench: %s %s reports %s %lf, reference %lf\n",
+               label.c_str(), result.instance.c_str(), RunStatusToString(result.status),
+               result.obj, known->second);
+        passed = false;
+      }
+      if (result.status != RunStatus::Optimal)
+        continue;
+      auto first = firstOptimal.find(result.instance);
+      if (first == firstOptimal.end())
+        firstOptimal[result.instance] = {label, result.obj};
+      else if (!SameObjective(result.obj, first->second.second))
+      {
+        printf("c Bench: %s %s optimal %lf, but %s found %lf\n",
+               label.c_str(), result.instance.c_str(), result.obj,
+               first->second.first.c_str(), first->second.second);
+        passed = false;
+      }
+    }
+  return passed;
+}
+
+bool Bench::Run()
+{
+  if (!ParseConfigs() || !ReadInstances())
+    return false;
+  filesystem::create_directories(OPT(outPath));
+  for (const BenchConfig &config : configs_)
+    for (const int threads : config.threads)
+    {
+      const string label = config.name + "_" + to_string(threads);
+      const filesystem::path runPath = filesystem::path(OPT(outPath)) / label;
+      filesystem::create_directories(runPath);
+      for (const string &instance : instances_)
+        pendingRuns_.push_back({label, config.binary, instance, threads,
+                                (runPath / (instance + ".log")).string(),
+                                (runPath / (instance + ".json")).string(),
+                                (runPath / (instance + ".sol")).string(), 0, 0});
+    }
+  printf("c Bench: %ld runs within %d cores\n", pendingRuns_.size(), OPT(cores));
+  Execute();
+  const bool fast = Summarize();
+  const bool correct = CheckObjectives();
+  return fast && correct;
+}
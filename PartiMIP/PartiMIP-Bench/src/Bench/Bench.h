@@ -0,0 +1,70 @@
+/*=====================================================================================
+
+    Filename:     Bench.h
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#pragma once
+#include "header.h"
+#include "../utils/paras.h"
+#include "RunResult.h"
+#include <sys/types.h>
+
+struct BenchConfig
+{
+  string name;
+  string binary;
+  vector<int> threads;
+};
+
+struct BenchRun
+{
+  string label;
+  string binary;
+  string instance;
+  int threads;
+  string logPath;
+  string profilePath;
+  string solutionPath;
+  pid_t pid;
+  double startTime;
+};
+
+/* Replaces the Evaluation/run scripts: every config runs on every listed
+   instance, and runs are packed so that their thread counts never exceed the
+   core budget. Nothing is downloaded; instances missing on disk are
+   skipped. A run fails when an optimal objective disagrees with the
+   reference or with another config, when its solution file does not hold
+   the objective it reported, or when a config got slower than its
+   baseline by more than --maxSlowdown. */
+class Bench
+{
+public:
+  Bench();
+  bool Run();
+
+private:
+  vector<BenchConfig> configs_;
+  vector<string> instances_;
+  deque<BenchRun> pendingRuns_;
+  vector<BenchRun> activeRuns_;
+  map<string, vector<RunResult>> results_;
+  size_t usedCores_;
+
+  bool ParseConfigs();
+  bool ReadInstances();
+  void Launch(BenchRun &_run);
+  void Execute();
+  bool Reap();
+  bool Summarize();
+  bool CheckObjectives();
+};
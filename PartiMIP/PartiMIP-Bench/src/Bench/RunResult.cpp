@@ -0,0 +1,165 @@
+/*=====================================================================================
+
+    Filename:     RunResult.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "RunResult.h"
+#include <regex>
+
+const char *RunStatusToString(const RunStatus &_status)
+{
+  switch (_status)
+  {
+  case RunStatus::Optimal:
+    return "Result.OPTIMAL";
+  case RunStatus::Infeasible:
+    return "Result.INFEASIBLE";
+  case RunStatus::Feasible:
+    return "Result.FEASIBLE";
+  default:
+    return "Result.UNKNOWN";
+  }
+}
+
+static string Trim(const string &_str)
+{
+  const size_t begin = _str.find_first_not_of(" \t\r\n");
+  if (begin == string::npos)
+    return "";
+  return _str.substr(begin, _str.find_last_not_of(" \t\r\n") - begin + 1);
+}
+
+static double ToValue(const string &_str)
+{
+  if (_str == "N/A" || _str.empty())
+    return INF;
+  return stod(_str);
+}
+
+static bool StartsWith(const string &_line, const string &_prefix)
+{
+  return _line.compare(0, _prefix.size(), _prefix) == 0;
+}
+
+/* The solver prints "OPTIMAL"/"INFEASIBLE" and "Solve Time" only when the run
+   finished, first as "o" lines and again, once the tree is settled, as "c"
+   lines; anything else with an objective counts as feasible. */
+RunResult ParseRunLog(const string &_label, const string &_instance,
+                      const string &_logPath, const string &_profilePath,
+                      const string &_solutionPath)
+{
+  RunResult result;
+  result.label = _label;
+  result.instance = _instance;
+  double solveTime = INF;
+  ifstream log(_logPath);
+  string line;
+  while (getline(log, line))
+  {
+    if (line.size() < 2 || (line[0] != 'o' && line[0] != 'c'))
+      continue;
+    const string body = line.substr(2);
+    if (StartsWith(body, "OPTIMAL"))
+      result.status = RunStatus::Optimal;
+    else if (StartsWith(body, "INFEASIBLE"))
+      result.status = RunStatus::Infeasible;
+    else if (StartsWith(body, "Solve Time:"))
+      solveTime = ToValue(Trim(body.substr(strlen("Solve Time:"))));
+    else if (StartsWith(body, "Best Found Objective Value:"))
+      result.obj = ToValue(Trim(body.substr(strlen("Best Found Objective Value:"))));
+  }
+  if (result.status == RunStatus::Unknown && result.obj < INF)
+    result.status = RunStatus::Feasible;
+  if (result.status == RunStatus::Optimal || result.status == RunStatus::Infeasible)
+    result.time = solveTime;
+
+  ifstream solution(_solutionPath);
+  string word;
+  if (solution >> word && word == "=obj=" && solution >> word)
+    result.solutionObj = ToValue(word);
+
+  ifstream profile(_profilePath);
+  const regex phaseRegex("\"(\\w+)\": \\{\"time\": ([-+.e0-9]+)");
+  const regex utilizationRegex("\"workerUtilization\": ([-+.e0-9]+)");
+  while (getline(profile, line))
+  {
+    smatch match;
+    if (regex_search(line, match, utilizationRegex))
+      result.utilization = stod(match[1]);
+    else if (line.find("\"phases\"") != string::npos)
+    {
+      // The merged phases come first; the per-thread ones follow.
+      for (sregex_iterator it(line.begin(), line.end(), phaseRegex), end; it != end; ++it)
+        result.phaseTime[(*it)[1]] = stod((*it)[2]);
+      break;
+    }
+  }
+  return result;
+}
+
+bool ReadResultFile(const string &_path, map<string, RunResult> &_results)
+{
+  ifstream file(_path);
+  if (!file.is_open())
+    return false;
+  string line;
+  while (getline(file, line))
+  {
+    vector<string> fields;
+    stringstream stream(line);
+    string field;
+    while (getline(stream, field, ','))
+      fields.push_back(Trim(field));
+    if (fields.size() < 5)
+      continue;
+    RunResult result;
+    result.label = fields[0];
+    result.instance = fields[1];
+    for (int status = (int)RunStatus::Optimal; status <= (int)RunStatus::Unknown; status++)
+      if (fields[2] == RunStatusToString((RunStatus)status))
+        result.status = (RunStatus)status;
+    result.obj = ToValue(fields[3]);
+    result.time = ToValue(fields[4]);
+    _results[result.instance] = result;
+  }
+  return true;
+}
+
+static string ValueToString(const double _value)
+{
+  if (_value == INF)
+    return "N/A";
+  ostringstream stream;
+  stream << setprecision(12) << _value;
+  return stream.str();
+}
+
+void WriteResultFile(const string &_path, const vector<RunResult> &_results)
+{
+  ofstream file(_path);
+  for (const RunResult &result : _results)
+    file << result.label << ",                 " << result.instance
+         << ",                 " << RunStatusToString(result.status)
+         << ",                 " << ValueToString(result.obj)
+         << ",                 " << ValueToString(result.time) << "\n";
+}
+
+double ShiftedGeoMean(const vector<double> &_times, const double _shift)
+{
+  if (_times.empty())
+    return INF;
+  double logSum = 0;
+  for (const double time : _times)
+    logSum += log(time + _shift);
+  return exp(logSum / _times.size()) - _shift;
+}
@@ -0,0 +1,54 @@
+/*=====================================================================================
+
+    Filename:     RunResult.h
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#pragma once
+#include "header.h"
+#include "../utils/paras.h"
+
+enum class RunStatus
+{
+  Optimal,
+  Infeasible,
+  Feasible,
+  Unknown
+};
+
+const char *RunStatusToString(const RunStatus &_status);
+
+/* One line of a Result/<name>.txt file, plus the phase timers of the run
+   when it wrote a profile and the objective of its solution file. Missing
+   values are INF and print as N/A. */
+struct RunResult
+{
+  string label;
+  string instance;
+  RunStatus status = RunStatus::Unknown;
+  double obj = INF;
+  double solutionObj = INF;
+  double time = INF;
+  double utilization = INF;
+  map<string, double> phaseTime;
+  inline bool IsSolved() const
+  {
+    return (status == RunStatus::Optimal || status == RunStatus::Infeasible) && time < INF;
+  }
+};
+
+RunResult ParseRunLog(const string &_label, const string &_instance,
+                      const string &_logPath, const string &_profilePath,
+                      const string &_solutionPath);
+bool ReadResultFile(const string &_path, map<string, RunResult> &_results);
+void WriteResultFile(const string &_path, const vector<RunResult> &_results);
+double ShiftedGeoMean(const vector<double> &_times, const double _shift);
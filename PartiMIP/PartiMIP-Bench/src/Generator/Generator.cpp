@@ -0,0 +1,241 @@
+/*=====================================================================================
+
+    Filename:     Generator.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "Generator.h"
+
+/* Optima of the instances written with the defaults and seed 1, from
+   HiGHS 1.9.0 run alone with zero gaps. An instance's name gives its seed
+   and size, but not the families drawn before it. */
+static const map<string, double> kPinnedOptima = {
+    {"setcover-150x600-s1.mps", 444},
+    {"mkp-60x5-s1.mps", -1937},
+    {"cfl-12x50-s1.mps", 3232.1},
+    {"mkpmax-60x5-s1.mps", 1867},
+    {"sweep1-40x5-s1.mps", -1194},
+    {"sweep2-50x5-s1.mps", -1466},
+    {"sweep3-60x5-s1.mps", -1812},
+    {"sweep4-70x5-s1.mps", -2252},
+    {"sweep5-80x5-s1.mps", -2562}};
+
+Generator::Generator(const string &_outPath, const unsigned long long _seed, const double _scale)
+    : outPath_(_outPath),
+      seed_(_seed),
+      scale_(_scale)
+{
+}
+
+bool Generator::Save(const MPSModel &_model, const string &_name)
+{
+  const string instance = _name + "-s" + to_string(seed_) + ".mps";
+  if (!_model.Write((filesystem::path(outPath_) / instance).string()))
+  {
+    printf("c Generator: cannot write %s\n", instance.c_str());
+    return false;
+  }
+  instances_.push_back(instance);
+  printf("c Generator: %s\n", instance.c_str());
+  return true;
+}
+
+/* min c x  s.t. every row is covered by a chosen column. */
+bool Generator::SetCover(const size_t _rowNum, const size_t _colNum, const double _density)
+{
+  MPSModel model("setcover");
+  vector<size_t> rows(_rowNum), cols(_colNum);
+  for (size_t row = 0; row < _rowNum; row++)
+    rows[row] = model.AddRow("r" + to_string(row), 'G', 1);
+  for (size_t col = 0; col < _colNum; col++)
+    cols[col] = model.AddVar("x" + to_string(col), 0, 1, true, Uniform(1, 100));
+  const long long threshold = (long long)(_density * 1000000);
+  vector<bool> covered(_rowNum, false);
+  for (size_t col = 0; col < _colNum; col++)
+    for (size_t row = 0; row < _rowNum; row++)
+      if (Uniform(0, 999999) < threshold)
+      {
+        model.AddCoef(rows[row], cols[col], 1);
+        covered[row] = true;
+      }
+  for (size_t row = 0; row < _rowNum; row++)
+    if (!covered[row])
+      model.AddCoef(rows[row], cols[Uniform(0, _colNum - 1)], 1);
+  return Save(model, "setcover-" + to_string(_rowNum) + "x" + to_string(_colNum));
+}
+
+/* max p x  s.t. W x <= tightness * row sums; profits correlate with weights.
+   Written as min -p x unless _maximize is set. */
+bool Generator::Knapsack(const size_t _itemNum, const size_t _dimNum, const double _tightness,
+                         const string &_family, const bool _maximize)
+{
+  MPSModel model("mkp", _maximize);
+  vector<vector<long long>> weights(_dimNum, vector<long long>(_itemNum));
+  vector<long long> weightSum(_dimNum, 0), itemWeight(_itemNum, 0);
+  for (size_t dim = 0; dim < _dimNum; dim++)
+    for (size_t item = 0; item < _itemNum; item++)
+    {
+      weights[dim][item] = Uniform(5, 60);
+      weightSum[dim] += weights[dim][item];
+      itemWeight[item] += weights[dim][item];
+    }
+  vector<size_t> rows(_dimNum);
+  for (size_t dim = 0; dim < _dimNum; dim++)
+    rows[dim] = model.AddRow("c" + to_string(dim), 'L', floor(weightSum[dim] * _tightness));
+  for (size_t item = 0; item < _itemNum; item++)
+  {
+    const long long profit = itemWeight[item] / _dimNum + Uniform(0, 40);
+    const size_t var = model.AddVar("x" + to_string(item), 0, 1, true, _maximize ? profit : -profit);
+    for (size_t dim = 0; dim < _dimNum; dim++)
+      model.AddCoef(rows[dim], var, weights[dim][item]);
+  }
+  return Save(model, _family + "-" + to_string(_itemNum) + "x" + to_string(_dimNum));
+}
+
+/* Capacitated facility location with the strong x_ij <= y_i links. */
+bool Generator::FacilityLocation(const size_t _facilityNum, const size_t _customerNum)
+{
+  MPSModel model("cfl");
+  vector<long long> demand(_customerNum);
+  long long demandSum = 0;
+  for (size_t customer = 0; customer < _customerNum; customer++)
+    demandSum += demand[customer] = Uniform(5, 35);
+  vector<size_t> open(_facilityNum), capacityRows(_facilityNum), assignRows(_customerNum);
+  for (size_t facility = 0; facility < _facilityNum; facility++)
+  {
+    const long long capacity = 3 * demandSum / _facilityNum + Uniform(0, 20);
+    open[facility] = model.AddVar("y" + to_string(facility), 0, 1, true, Uniform(300, 700));
+    capacityRows[facility] = model.AddRow("cap" + to_string(facility), 'L', 0);
+    model.AddCoef(capacityRows[facility], open[facility], -capacity);
+  }
+  for (size_t customer = 0; customer < _customerNum; customer++)
+    assignRows[customer] = model.AddRow("dem" + to_string(customer), 'E', 1);
+  for (size_t facility = 0; facility < _facilityNum; facility++)
+    for (size_t customer = 0; customer < _customerNum; customer++)
+    {
+      const string suffix = to_string(facility) + "_" + to_string(customer);
+      const size_t var = model.AddVar("x" + suffix, 0, 1, false, Uniform(1, 100) * demand[customer] / 10.0);
+      model.AddCoef(assignRows[customer], var, 1);
+      model.AddCoef(capacityRows[facility], var, demand[customer]);
+      const size_t link = model.AddRow("l" + suffix, 'L', 0);
+      model.AddCoef(link, var, 1);
+      model.AddCoef(link, open[facility], -1);
+    }
+  return Save(model, "cfl-" + to_string(_facilityNum) + "x" + to_string(_customerNum));
+}
+
+/* Items are cut from _binNum full bins, so exactly _binNum bins are needed;
+   the LP bound is tight and the optimum is recorded. */
+bool Generator::BinPacking(const size_t _binNum, const long long _capacity)
+{
+  MPSModel model("binpack");
+  vector<long long> items;
+  for (size_t bin = 0; bin < _binNum; bin++)
+  {
+    long long remaining = _capacity;
+    while (remaining > 0)
+    {
+      const long long piece = remaining <= _capacity / 5 ? remaining : Uniform(_capacity / 10, remaining / 2);
+      items.push_back(piece);
+      remaining -= piece;
+    }
+  }
+  for (size_t item = items.size(); item > 1; item--)
+    swap(items[item - 1], items[Uniform(0, item - 1)]);
+  const size_t slotNum = _binNum + max((size_t)2, _binNum / 4);
+  vector<size_t> used(slotNum), loadRows(slotNum);
+  for (size_t slot = 0; slot < slotNum; slot++)
+  {
+    used[slot] = model.AddVar("y" + to_string(slot), 0, 1, true, 1);
+    loadRows[slot] = model.AddRow("load" + to_string(slot), 'L', 0);
+    model.AddCoef(loadRows[slot], used[slot], -_capacity);
+    if (slot > 0)
+    {
+      // Symmetry breaking: bins are used in order.
+      const size_t order = model.AddRow("ord" + to_string(slot), 'L', 0);
+      model.AddCoef(order, used[slot], 1);
+      model.AddCoef(order, used[slot - 1], -1);
+    }
+  }
+  for (size_t item = 0; item < items.size(); item++)
+  {
+    const size_t assign = model.AddRow("a" + to_string(item), 'E', 1);
+    for (size_t slot = 0; slot < slotNum; slot++)
+    {
+      const size_t var = model.AddVar("x" + to_string(item) + "_" + to_string(slot), 0, 1, true, 0);
+      model.AddCoef(assign, var, 1);
+      model.AddCoef(loadRows[slot], var, items[item]);
+    }
+  }
+  if (!Save(model, "binpack-" + to_string(_binNum) + "x" + to_string(_capacity)))
+    return false;
+  references_.push_back({instances_.back(), (double)_binNum});
+  return true;
+}
+
+/* Knapsacks that get harder with the level. */
+bool Generator::Sweep(const size_t _level)
+{
+  return Knapsack(Scaled(30 + 10 * _level), 5, 0.5, "sweep" + to_string(_level));
+}
+
+bool Generator::Generate(const string &_family, const size_t _count, const size_t _levels)
+{
+  const bool all = _family == "all";
+  if (!all && _family != "setcover" && _family != "mkp" && _family != "cfl" &&
+      _family != "binpacking" && _family != "mkpmax" && _family != "sweep")
+  {
+    printf("c Generator: unknown family %s\n", _family.c_str());
+    return false;
+  }
+  rng_.seed(seed_);
+  for (size_t idx = 0; idx < _count; idx++)
+  {
+    if ((all || _family == "setcover") && !SetCover(Scaled(150), Scaled(600), 0.03))
+      return false;
+    if ((all || _family == "mkp") && !Knapsack(Scaled(60), 5, 0.5, "mkp"))
+      return false;
+    if ((all || _family == "cfl") && !FacilityLocation(Scaled(12), Scaled(50)))
+      return false;
+    if ((all || _family == "binpacking") && !BinPacking(Scaled(8), 100))
+      return false;
+    if ((all || _family == "mkpmax") && !Knapsack(Scaled(60), 5, 0.5, "mkpmax", true))
+      return false;
+  }
+  if (all || _family == "sweep")
+    for (size_t level = 1; level <= _levels; level++)
+      if (!Sweep(level))
+        return false;
+  // An instance is drawn from the generator state the families before it
+  // left, so the pinned optima only hold for one instance of every family
+  // at full scale. The sweep comes last, so its level count changes none
+  // of them.
+  if (all && _count == 1 && scale_ == 1)
+    for (const string &instance : instances_)
+    {
+      auto pinned = kPinnedOptima.find(instance);
+      if (pinned != kPinnedOptima.end())
+        references_.push_back(*pinned);
+    }
+  return true;
+}
+
+bool Generator::WriteLists() const
+{
+  ofstream list(filesystem::path(outPath_) / "list.txt");
+  for (const string &instance : instances_)
+    list << instance << "\n";
+  ofstream reference(filesystem::path(outPath_) / "reference.txt");
+  for (const auto &[instance, obj] : references_)
+    reference << instance << " " << obj << "\n";
+  return list.good() && reference.good();
+}
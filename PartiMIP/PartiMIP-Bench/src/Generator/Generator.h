@@ -0,0 +1,54 @@
+/*=====================================================================================
+
+    Filename:     Generator.h
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#pragma once
+#include "header.h"
+#include "MPSModel.h"
+#include <random>
+
+/* Seeded instance families for offline regression runs. Random numbers are
+   drawn straight from mt19937_64, whose sequence is fixed by the standard,
+   so the same seed writes the same file on every platform. Families whose
+   optimum is known by construction also record it in reference.txt, as do
+   the instances of all families written with the defaults and seed 1,
+   whose optima come from a pinned run. */
+class Generator
+{
+public:
+  Generator(const string &_outPath, const unsigned long long _seed, const double _scale);
+  bool Generate(const string &_family, const size_t _count, const size_t _levels);
+  bool WriteLists() const;
+
+private:
+  string outPath_;
+  unsigned long long seed_;
+  double scale_;
+  mt19937_64 rng_;
+  vector<string> instances_;
+  vector<pair<string, double>> references_;
+
+  inline long long Uniform(const long long _low, const long long _high)
+  {
+    return _low + (long long)(rng_() % (unsigned long long)(_high - _low + 1));
+  }
+  inline size_t Scaled(const size_t _size) const { return max((size_t)1, (size_t)(_size * scale_)); }
+  bool Save(const MPSModel &_model, const string &_name);
+  bool SetCover(const size_t _rowNum, const size_t _colNum, const double _density);
+  bool Knapsack(const size_t _itemNum, const size_t _dimNum, const double _tightness,
+                const string &_family, const bool _maximize = false);
+  bool FacilityLocation(const size_t _facilityNum, const size_t _customerNum);
+  bool BinPacking(const size_t _binNum, const long long _capacity);
+  bool Sweep(const size_t _level);
+};
@@ -0,0 +1,86 @@
+/*=====================================================================================
+
+    Filename:     MPSModel.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "MPSModel.h"
+
+size_t MPSModel::AddVar(const string &_name, const double _lower, const double _upper,
+                        const bool _integer, const double _cost)
+{
+  vars_.push_back({_name, _lower, _upper, _integer, {}});
+  costs_.push_back(_cost);
+  return vars_.size() - 1;
+}
+
+size_t MPSModel::AddRow(const string &_name, const char _sense, const double _rhs)
+{
+  rows_.push_back({_name, _sense, _rhs});
+  return rows_.size() - 1;
+}
+
+void MPSModel::AddCoef(const size_t _row, const size_t _var, const double _value)
+{
+  vars_[_var].coefs.push_back({_row, _value});
+}
+
+bool MPSModel::Write(const string &_path) const
+{
+  FILE *file = fopen(_path.c_str(), "w");
+  if (file == nullptr)
+    return false;
+  fprintf(file, "NAME %s\n", name_.c_str());
+  if (maximize_)
+    fprintf(file, "OBJSENSE\n    MAX\n");
+  fprintf(file, "ROWS\n N obj\n");
+  for (const MPSRow &row : rows_)
+    fprintf(file, " %c %s\n", row.sense, row.name.c_str());
+  fprintf(file, "COLUMNS\n");
+  bool inInteger = false;
+  for (size_t var = 0; var < vars_.size(); var++)
+  {
+    if (vars_[var].integer != inInteger)
+    {
+      fprintf(file, "    MARKER 'MARKER' '%s'\n", inInteger ? "INTEND" : "INTORG");
+      inInteger = vars_[var].integer;
+    }
+    if (costs_[var] != 0)
+      fprintf(file, "    %s obj %.12g\n", vars_[var].name.c_str(), costs_[var]);
+    for (const auto &[row, value] : vars_[var].coefs)
+      fprintf(file, "    %s %s %.12g\n", vars_[var].name.c_str(), rows_[row].name.c_str(), value);
+  }
+  if (inInteger)
+    fprintf(file, "    MARKER 'MARKER' 'INTEND'\n");
+  fprintf(file, "RHS\n");
+  for (const MPSRow &row : rows_)
+    if (row.rhs != 0)
+      fprintf(file, "    rhs %s %.12g\n", row.name.c_str(), row.rhs);
+  fprintf(file, "BOUNDS\n");
+  for (const MPSVar &var : vars_)
+  {
+    if (var.integer && var.lower == 0 && var.upper == 1)
+    {
+      fprintf(file, " BV bnd %s\n", var.name.c_str());
+      continue;
+    }
+    if (var.lower != 0)
+      fprintf(file, " %s bnd %s %.12g\n", var.integer ? "LI" : "LO", var.name.c_str(), var.lower);
+    if (var.upper < INF)
+      fprintf(file, " %s bnd %s %.12g\n", var.integer ? "UI" : "UP", var.name.c_str(), var.upper);
+    else if (var.integer)
+      fprintf(file, " PL bnd %s\n", var.name.c_str());
+  }
+  fprintf(file, "ENDATA\n");
+  fclose(file);
+  return true;
+}
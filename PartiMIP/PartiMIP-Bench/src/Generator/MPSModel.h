@@ -0,0 +1,53 @@
+/*=====================================================================================
+
+    Filename:     MPSModel.h
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#pragma once
+#include "header.h"
+
+struct MPSVar
+{
+  string name;
+  double lower;
+  double upper;
+  bool integer;
+  vector<pair<size_t, double>> coefs;
+};
+
+struct MPSRow
+{
+  string name;
+  char sense;
+  double rhs;
+};
+
+/* A MIP built column by column and written as free MPS; minimised unless
+   built as a maximisation. */
+class MPSModel
+{
+public:
+  MPSModel(const string &_name, const bool _maximize = false) : name_(_name), maximize_(_maximize) {}
+  size_t AddVar(const string &_name, const double _lower, const double _upper,
+                const bool _integer, const double _cost);
+  size_t AddRow(const string &_name, const char _sense, const double _rhs);
+  void AddCoef(const size_t _row, const size_t _var, const double _value);
+  bool Write(const string &_path) const;
+
+private:
+  string name_;
+  bool maximize_;
+  vector<MPSVar> vars_;
+  vector<double> costs_;
+  vector<MPSRow> rows_;
+};
@@ -0,0 +1,38 @@
+/*=====================================================================================
+
+    Filename:     main.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "Generator.h"
+#include "cmdline.h"
+
+std::chrono::steady_clock::time_point timeStart = std::chrono::steady_clock::now();
+
+int main(int argc, char **argv)
+{
+    cmdline::parser parser;
+    parser.add<string>("family", 'f', "setcover, mkp, cfl, binpacking, mkpmax, sweep or all", false, "all");
+    parser.add<string>("outPath", 'o', "Directory for the instances, list.txt and reference.txt", false, "synthetic/");
+    parser.add<int>("seed", 's', "Random seed", false, 1);
+    parser.add<int>("count", 'n', "Instances per family", false, 1, cmdline::range(1, 1000));
+    parser.add<int>("levels", '\0', "Difficulty levels of the sweep", false, 5, cmdline::range(1, 100));
+    parser.add<double>("scale", '\0', "Size multiplier", false, 1.0, cmdline::range(0.1, 100.0));
+    parser.parse_check(argc, argv);
+
+    filesystem::create_directories(parser.get<string>("outPath"));
+    Generator generator(parser.get<string>("outPath"), parser.get<int>("seed"), parser.get<double>("scale"));
+    if (!generator.Generate(parser.get<string>("family"), parser.get<int>("count"), parser.get<int>("levels")) ||
+        !generator.WriteLists())
+        return 1;
+    return 0;
+}
@@ -0,0 +1,136 @@
+/*=====================================================================================
+
+    Filename:     PostsolveTest.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "Test.h"
+#include "Presolve/PostsolveMap.h"
+
+namespace
+{
+  constexpr int kMaxDepth = 2;
+
+  struct LiftCount
+  {
+    size_t lifted = 0;
+    size_t infeasible = 0;
+  };
+
+  /* Solves a node's reduced model and lifts the optimum to the original
+     model, where it has to be feasible, keep every fixing of the node's
+     path and keep its objective. Then branches on the first and the last
+     unfixed integer column, each child presolved by HiGHS and by the
+     incremental presolve. _origCol is the original column of each reduced
+     column. */
+  bool CheckSubtree(const TestInstance &_instance, const HighsModel &_reduced,
+                    const shared_ptr<const PostsolveMap> &_map, const vector<HighsInt> &_origCol,
+                    vector<pair<HighsInt, double>> &_path, const int _depth, LiftCount &_count)
+  {
+    const HighsLp &original = _instance.model.lp_;
+    const HighsLp &lp = _reduced.lp_;
+    vector<double> colValue;
+    double obj = lp.offset_;
+    if (lp.num_col_ > 0 && !SolveMip(_reduced, colValue, obj))
+    {
+      _count.infeasible++;
+      return true;
+    }
+    CHECK(_map->Lift(colValue), "%s: no lift at depth %d", _instance.name.c_str(), _depth);
+    string what;
+    CHECK(!ViolatedBy(original, colValue, what), "%s: lifted solution at depth %d breaks %s",
+          _instance.name.c_str(), _depth, what.c_str());
+    for (const auto &[col, value] : _path)
+      CHECK(fabs(colValue[col] - value) < 1e-6, "%s: original column %d is %g, fixed to %g",
+            _instance.name.c_str(), (int)col, colValue[col], value);
+    const double liftedObj = (double)original.sense_ * ObjectiveOf(original, colValue);
+    const double reducedObj = (double)lp.sense_ * obj;
+    CHECK(fabs(liftedObj - reducedObj) < 1e-6 * max(1.0, fabs(reducedObj)),
+          "%s: objective %g lifted to %g at depth %d", _instance.name.c_str(), reducedObj, liftedObj, _depth);
+    _count.lifted++;
+    if (_depth == kMaxDepth)
+      return true;
+
+    vector<HighsInt> branchCols;
+    for (HighsInt col = 0; col < lp.num_col_; ++col)
+      if (lp.integrality_.size() == (size_t)lp.num_col_ && lp.integrality_[col] == HighsVarType::kInteger &&
+          lp.col_lower_[col] < lp.col_upper_[col] && !isinf(lp.col_upper_[col]))
+        branchCols.push_back(col);
+    if (branchCols.size() > 2)
+      branchCols.erase(branchCols.begin() + 1, branchCols.end() - 1);
+    for (const HighsInt col : branchCols)
+      for (const double value : {lp.col_lower_[col], lp.col_upper_[col]})
+        for (const bool incremental : {false, true})
+        {
+          Presolve presolve(true);
+          if (incremental)
+            presolve.PresolveIncremental(_reduced, {{col, value, value}}, 5);
+          else
+          {
+            presolve.LoadModel(_reduced, {{col, value, value}});
+            presolve.PresolveByHighs();
+          }
+          presolve.Detach();
+          if (presolve.CheckPresolveInfeas())
+          {
+            _count.infeasible++;
+            continue;
+          }
+          CHECK(presolve.CanLift(), "%s: child presolve cannot be lifted", _instance.name.c_str());
+          const HighsModel childReduced = presolve.GetReducedModel();
+          vector<HighsInt> childOrigCol;
+          for (const HighsInt stepCol : presolve.GetStepColIndex())
+            childOrigCol.push_back(_origCol[stepCol]);
+          shared_ptr<const PostsolveMap> childMap = PostsolveMap::Build(_map, presolve);
+          CHECK(childMap != nullptr, "%s: no map for a child", _instance.name.c_str());
+          _path.push_back({_origCol[col], value});
+          const bool ok = CheckSubtree(_instance, childReduced, childMap, childOrigCol, _path, _depth + 1, _count);
+          _path.pop_back();
+          childMap->CloseStep();
+          if (!ok)
+            return false;
+        }
+    return true;
+  }
+}
+
+/* Presolves each instance's root by HiGHS, then a two-level subtree below
+   it, and lifts every node's optimum through the composed maps. */
+bool TestPostsolve(const string &_dir)
+{
+  vector<TestInstance> instances;
+  if (!ReadInstances(_dir, instances))
+    return false;
+  for (const TestInstance &instance : instances)
+  {
+    Presolve root(true);
+    root.LoadModel(instance.model, {});
+    root.PresolveByHighs();
+    root.Detach();
+    CHECK(root.CanLift(), "%s: root presolve cannot be lifted", instance.name.c_str());
+    const HighsModel reduced = root.GetReducedModel();
+    const vector<HighsInt> origCol = root.GetStepColIndex();
+    shared_ptr<const PostsolveMap> map = PostsolveMap::Build(nullptr, root);
+    CHECK(map != nullptr, "%s: no map for the root", instance.name.c_str());
+    vector<pair<HighsInt, double>> path;
+    LiftCount count;
+    const bool ok = CheckSubtree(instance, reduced, map, origCol, path, 0, count);
+    map->CloseStep();
+    if (!ok)
+      return false;
+    printf("c Test: %s: %d of %d columns kept by the root; %ld nodes lifted, %ld infeasible\n",
+           instance.name.c_str(), (int)reduced.lp_.num_col_, (int)instance.model.lp_.num_col_,
+           count.lifted, count.infeasible);
+  }
+  PostsolveMap::PrintStatistic();
+  return true;
+}
@@ -0,0 +1,130 @@
+/*=====================================================================================
+
+    Filename:     PropagatorTest.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "Test.h"
+#include "Propagator/Propagator.h"
+
+namespace
+{
+  constexpr size_t kMaxBranchCols = 20;
+
+  /* x0 + x1 <= 1 and x1 + x2 >= 2 over binaries. Only the rows of a
+     changed column are propagated, so x0 = 0 implies nothing. */
+  HighsLp SmallLp()
+  {
+    HighsLp lp;
+    lp.num_col_ = 3;
+    lp.num_row_ = 2;
+    lp.col_cost_ = {1, 1, 1};
+    lp.col_lower_ = {0, 0, 0};
+    lp.col_upper_ = {1, 1, 1};
+    lp.row_lower_ = {-kHighsInf, 2};
+    lp.row_upper_ = {1, kHighsInf};
+    lp.integrality_.assign(3, HighsVarType::kInteger);
+    lp.a_matrix_.format_ = MatrixFormat::kColwise;
+    lp.a_matrix_.num_col_ = 3;
+    lp.a_matrix_.num_row_ = 2;
+    lp.a_matrix_.start_ = {0, 1, 3, 4};
+    lp.a_matrix_.index_ = {0, 0, 1, 1};
+    lp.a_matrix_.value_ = {1, 1, 1, 1};
+    return lp;
+  }
+
+  bool Within(const vector<BoundChange> &_changes, const vector<double> &_colValue)
+  {
+    for (const BoundChange &change : _changes)
+      if (_colValue[change.col] < change.lower - 1e-6 || _colValue[change.col] > change.upper + 1e-6)
+        return false;
+    return true;
+  }
+
+  bool CheckSmall()
+  {
+    Propagator propagator(SmallLp());
+    vector<BoundChange> changes = {{0, 1, 1}};
+    CHECK(!propagator.Propagate(changes), "x0 = 1 leaves x1 + x2 >= 2 unsatisfiable");
+    changes = {{0, 0, 0}};
+    CHECK(propagator.Propagate(changes), "x0 = 0 is feasible");
+    CHECK(Within(changes, {0, 1, 1}), "x0 = 0 cuts off the only solution");
+    changes = {{2, 1, 1}};
+    CHECK(propagator.Propagate(changes), "x2 = 1 is feasible");
+    CHECK(!Within(changes, {1, 1, 1}) && Within(changes, {0, 1, 1}), "x2 = 1 is not propagated to x1 and x0");
+    return true;
+  }
+}
+
+/* Checks the propagation of a hand-made model, then branches on integer
+   columns of each instance. Fixing a column to its value in an optimum
+   has to keep that optimum. Fixing it to a bound has to keep the optimum
+   of the model with that fixing, and may only be found infeasible if that
+   model is. */
+bool TestPropagate(const string &_dir)
+{
+  if (!CheckSmall())
+    return false;
+  vector<TestInstance> instances;
+  if (!ReadInstances(_dir, instances))
+    return false;
+  size_t tightenNum = 0;
+  for (const TestInstance &instance : instances)
+  {
+    const HighsLp &lp = instance.model.lp_;
+    vector<double> optimum;
+    double obj;
+    CHECK(SolveMip(instance.model, optimum, obj), "%s: no optimum", instance.name.c_str());
+    Propagator propagator(lp);
+    size_t branchNum = 0;
+    size_t infeasibleNum = 0;
+    for (HighsInt col = 0; col < lp.num_col_ && branchNum < kMaxBranchCols; ++col)
+    {
+      if (lp.integrality_[col] != HighsVarType::kInteger || lp.col_lower_[col] >= lp.col_upper_[col] ||
+          isinf(lp.col_upper_[col]))
+        continue;
+      branchNum++;
+      const double value = round(optimum[col]);
+      vector<BoundChange> changes = {{col, value, value}};
+      CHECK(propagator.Propagate(changes), "%s: column %d = %g found infeasible at an optimum",
+            instance.name.c_str(), (int)col, value);
+      CHECK(Within(changes, optimum), "%s: column %d = %g cuts off the optimum",
+            instance.name.c_str(), (int)col, value);
+      tightenNum += changes.size() - 1;
+
+      const double other = value == lp.col_lower_[col] ? lp.col_upper_[col] : lp.col_lower_[col];
+      changes = {{col, other, other}};
+      const bool feasible = propagator.Propagate(changes);
+      HighsModel branch = instance.model;
+      branch.lp_.col_lower_[col] = branch.lp_.col_upper_[col] = other;
+      vector<double> branchOptimum;
+      double branchObj;
+      const bool solved = SolveMip(branch, branchOptimum, branchObj);
+      if (!feasible)
+      {
+        CHECK(!solved, "%s: column %d = %g found infeasible, but has an optimum",
+              instance.name.c_str(), (int)col, other);
+        infeasibleNum++;
+      }
+      else if (solved)
+        CHECK(Within(changes, branchOptimum), "%s: column %d = %g cuts off the branch's optimum",
+              instance.name.c_str(), (int)col, other);
+      if (feasible)
+        tightenNum += changes.size() - 1;
+    }
+    printf("c Test: %s: %ld branching columns; %ld branches found infeasible\n",
+           instance.name.c_str(), branchNum, infeasibleNum);
+  }
+  CHECK(tightenNum > 0, "no bound was tightened on any instance");
+  Propagator::PrintStatistic();
+  return true;
+}
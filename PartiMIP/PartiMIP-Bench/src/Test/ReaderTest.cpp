@@ -0,0 +1,87 @@
+/*=====================================================================================
+
+    Filename:     ReaderTest.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "Test.h"
+#include "Reader/MPSReader.h"
+#include <zlib.h>
+
+namespace
+{
+  constexpr size_t kPoolThreads = 4;
+
+  bool Compress(const string &_path, const string &_gzPath)
+  {
+    ifstream in(_path, ios::binary);
+    gzFile out = gzopen(_gzPath.c_str(), "wb");
+    if (!in || out == nullptr)
+      return false;
+    vector<char> buffer(1 << 16);
+    bool ok = true;
+    while (ok && in)
+    {
+      in.read(buffer.data(), buffer.size());
+      if (in.gcount() > 0)
+        ok = gzwrite(out, buffer.data(), (unsigned)in.gcount()) == (int)in.gcount();
+    }
+    return gzclose(out) == Z_OK && ok;
+  }
+}
+
+/* Reads each instance with the parallel reader, from the file or from a
+   gzip copy of it, and compares the model with HiGHS' one the way the
+   scheduler does with mpsReader=2. At least one file has to be cut into
+   several column chunks, so that the chunks are parsed in parallel. */
+bool TestReader(const string &_dir, const bool _gzip)
+{
+  vector<TestInstance> instances;
+  if (!ReadInstances(_dir, instances))
+    return false;
+  ThreadPool pool(kPoolThreads);
+  size_t maxChunkNum = 0;
+  for (const TestInstance &instance : instances)
+  {
+    string path = instance.path;
+    if (_gzip)
+    {
+      path = (filesystem::temp_directory_path() / (to_string(getpid()) + "-" + instance.name + ".gz")).string();
+      CHECK(Compress(instance.path, path), "cannot write %s", path.c_str());
+    }
+    MPSReader reader(&pool);
+    HighsModel model;
+    const bool read = reader.Read(path, model);
+    if (_gzip)
+      filesystem::remove(path);
+    CHECK(read, "%s: declined (%s)", instance.name.c_str(), reader.GetError().c_str());
+    CHECK((reader.GetCompression() != nullptr) == _gzip &&
+              (!_gzip || strcmp(reader.GetCompression(), "gzip") == 0),
+          "%s: read as %s", instance.name.c_str(),
+          reader.GetCompression() == nullptr ? "uncompressed" : reader.GetCompression());
+    maxChunkNum = max(maxChunkNum, reader.GetChunkNum());
+
+    Highs check;
+    check.setOptionValue("output_flag", false);
+    check.passModel(std::move(model));
+    const HighsLp &expected = instance.model.lp_;
+    HighsLp lp = check.getLp();
+    lp.model_name_ = expected.model_name_;
+    CHECK(lp.equalButForScalingAndNames(expected) && lp.integrality_ == expected.integrality_ &&
+              lp.equalNames(expected),
+          "%s: the model differs from HiGHS' one", instance.name.c_str());
+    printf("c Test: %s: %ld column chunks; %s\n", instance.name.c_str(), reader.GetChunkNum(),
+           _gzip ? "gzip" : "uncompressed");
+  }
+  CHECK(maxChunkNum > 1, "no file was parsed in more than one chunk");
+  return true;
+}
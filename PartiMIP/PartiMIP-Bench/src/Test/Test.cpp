@@ -0,0 +1,104 @@
+/*=====================================================================================
+
+    Filename:     Test.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "Test.h"
+
+/* Every instance of _dir's list.txt, read by HiGHS. */
+bool ReadInstances(const string &_dir, vector<TestInstance> &_instances)
+{
+  ifstream list(filesystem::path(_dir) / "list.txt");
+  string name;
+  while (list >> name)
+  {
+    TestInstance instance;
+    instance.name = name;
+    instance.path = (filesystem::path(_dir) / name).string();
+    Highs highs;
+    highs.setOptionValue("output_flag", false);
+    CHECK(highs.readModel(instance.path) != HighsStatus::kError, "HiGHS cannot read %s", instance.path.c_str());
+    instance.model = highs.getModel();
+    _instances.push_back(std::move(instance));
+  }
+  CHECK(!_instances.empty(), "no instance listed in %s/list.txt", _dir.c_str());
+  return true;
+}
+
+static inline bool Exceeds(const double _value, const double _bound, const double _sign)
+{
+  return _sign * (_value - _bound) > 1e-6 * max(1.0, fabs(_bound));
+}
+
+/* True if _colValue breaks a bound, an integrality or a row of _lp, which
+   _what then names. */
+bool ViolatedBy(const HighsLp &_lp, const vector<double> &_colValue, string &_what)
+{
+  char what[128];
+  if (_colValue.size() != (size_t)_lp.num_col_)
+  {
+    snprintf(what, sizeof(what), "%ld values for %d columns", _colValue.size(), (int)_lp.num_col_);
+    _what = what;
+    return true;
+  }
+  const bool mip = _lp.integrality_.size() == (size_t)_lp.num_col_;
+  vector<double> rowAct(_lp.num_row_, 0);
+  for (HighsInt col = 0; col < _lp.num_col_; ++col)
+  {
+    const double value = _colValue[col];
+    if (Exceeds(value, _lp.col_upper_[col], 1) || Exceeds(value, _lp.col_lower_[col], -1) ||
+        (mip && _lp.integrality_[col] == HighsVarType::kInteger && fabs(value - round(value)) > 1e-6))
+    {
+      snprintf(what, sizeof(what), "column %d = %g in [%g, %g]",
+               (int)col, value, _lp.col_lower_[col], _lp.col_upper_[col]);
+      _what = what;
+      return true;
+    }
+    for (HighsInt k = _lp.a_matrix_.start_[col]; k < _lp.a_matrix_.start_[col + 1]; ++k)
+      rowAct[_lp.a_matrix_.index_[k]] += _lp.a_matrix_.value_[k] * value;
+  }
+  for (HighsInt row = 0; row < _lp.num_row_; ++row)
+    if (Exceeds(rowAct[row], _lp.row_upper_[row], 1) || Exceeds(rowAct[row], _lp.row_lower_[row], -1))
+    {
+      snprintf(what, sizeof(what), "row %d = %g in [%g, %g]",
+               (int)row, rowAct[row], _lp.row_lower_[row], _lp.row_upper_[row]);
+      _what = what;
+      return true;
+    }
+  return false;
+}
+
+double ObjectiveOf(const HighsLp &_lp, const vector<double> &_colValue)
+{
+  double obj = _lp.offset_;
+  for (HighsInt col = 0; col < _lp.num_col_; ++col)
+    obj += _lp.col_cost_[col] * _colValue[col];
+  return obj;
+}
+
+/* Solves _model to optimality; false if HiGHS found no solution. */
+bool SolveMip(const HighsModel &_model, vector<double> &_colValue, double &_obj)
+{
+  Highs highs;
+  highs.setOptionValue("output_flag", false);
+  highs.setOptionValue("threads", 1);
+  highs.setOptionValue("mip_rel_gap", 0.0);
+  highs.setOptionValue("mip_abs_gap", 0.0);
+  highs.passModel(_model);
+  highs.run();
+  if (highs.getModelStatus() != HighsModelStatus::kOptimal)
+    return false;
+  _colValue = highs.getSolution().col_value;
+  _obj = highs.getInfo().objective_function_value;
+  return true;
+}
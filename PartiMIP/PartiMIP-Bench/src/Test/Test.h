@@ -0,0 +1,50 @@
+/*=====================================================================================
+
+    Filename:     Test.h
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#pragma once
+#include "utils/header.h"
+#include "utils/paras.h"
+
+/* Behaviour checks of the shared modules on small generated models. Each
+   case runs on the instances partimip-gen listed in a directory's list.txt
+   and returns false after printing the first check that failed. */
+
+#define CHECK(cond, ...)                                         \
+  do                                                             \
+  {                                                              \
+    if (!(cond))                                                 \
+    {                                                            \
+      printf("c Test: %s:%d: %s: ", __FILE__, __LINE__, #cond);  \
+      printf(__VA_ARGS__);                                       \
+      printf("\n");                                              \
+      return false;                                              \
+    }                                                            \
+  } while (0)
+
+struct TestInstance
+{
+  string name;
+  string path;
+  HighsModel model;
+};
+
+bool ReadInstances(const string &_dir, vector<TestInstance> &_instances);
+bool ViolatedBy(const HighsLp &_lp, const vector<double> &_colValue, string &_what);
+double ObjectiveOf(const HighsLp &_lp, const vector<double> &_colValue);
+bool SolveMip(const HighsModel &_model, vector<double> &_colValue, double &_obj);
+
+bool TestPostsolve(const string &_dir);
+bool TestPropagate(const string &_dir);
+bool TestReader(const string &_dir, const bool _gzip);
@@ -0,0 +1,44 @@
+/*=====================================================================================
+
+    Filename:     main.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "Test.h"
+#include "cmdline.h"
+
+std::chrono::steady_clock::time_point timeStart = std::chrono::steady_clock::now();
+
+int main(int argc, char **argv)
+{
+    cmdline::parser parser;
+    parser.add<string>("case", 'c', "postsolve, propagate, reader or reader-gzip", true, "");
+    parser.add<string>("instanceDir", 'd', "Directory of partimip-gen instances and their list.txt", true, "");
+    parser.parse_check(argc, argv);
+
+    const string testCase = parser.get<string>("case");
+    const string dir = parser.get<string>("instanceDir");
+    bool passed;
+    if (testCase == "postsolve")
+        passed = TestPostsolve(dir);
+    else if (testCase == "propagate")
+        passed = TestPropagate(dir);
+    else if (testCase == "reader" || testCase == "reader-gzip")
+        passed = TestReader(dir, testCase == "reader-gzip");
+    else
+    {
+        printf("c Test: unknown case %s\n", testCase.c_str());
+        return 1;
+    }
+    printf("c Test: %s %s in %.2lf s\n", testCase.c_str(), passed ? "passed" : "FAILED", ElapsedTime());
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,43 @@
+#ifndef _paras_hpp_INCLUDED
+#define _paras_hpp_INCLUDED
+
+#include "header.h"
+
+//        name,               type,  short-name, must-need, default, low, high, comments
+#define PARAS \
+    PARA( cutoff            ,   double   , 'c'  ,  false , 300   , 0  , 1e8     , "Cutoff time passed to every run") \
+    PARA( timeout           ,   double   , '\0' ,  false , 600   , 0  , 1e8     , "Runs still alive after this are killed") \
+    PARA( cores             ,   int      , 'n'  ,  false , 128   , 1  , 65536   , "Core budget shared by concurrent runs")\
+    PARA( shift             ,   double   , '\0' ,  false , 10    , 0  , 1e8     , "Shift of the geometric mean of solve times")\
+    PARA( maxSlowdown       ,   double   , '\0' ,  false , 0     , 0  , 1e8     , "Fail when the SGM exceeds the baseline's by this fraction (0: off)")\
+//            name,   short-name, must-need, default, comments
+#define STR_PARAS \
+    STR_PARA( config      , 's'   ,  true     , ""                         , "name:binary:threads[,threads...], several separated by ';'")\
+    STR_PARA( list        , 'L'   ,  false    , "Benchmark/benchmark.txt"  , "Instance list")\
+    STR_PARA( instanceDir , 'd'   ,  false    , "Benchmark/mps"            , "Directory holding the listed instances")\
+    STR_PARA( baseline    , 'b'   ,  false    , "Result"                   , "Directory of <name>_<threads>.txt baselines")\
+    STR_PARA( reference   , 'r'   ,  false    , ""                         , "File of known optimal objectives, one \"instance objective\" per line")\
+    STR_PARA( outPath     , 'o'   ,  false    , "bench/"                   , "Logs, profiles and result files")
+
+struct paras 
+{
+#define PARA(N, T, S, M, D, L, H, C) \
+    T N = D;
+    PARAS 
+#undef PARA
+
+#define STR_PARA(N, S, M, D, C) \
+    std::string N = D;
+    STR_PARAS
+#undef STR_PARA
+
+void parse_args(int argc, char *argv[]);
+};
+
+#define INIT_ARGS __global_paras.parse_args(argc, argv);
+
+extern paras __global_paras;
+
+#define OPT(N) (__global_paras.N)
+
+#endif
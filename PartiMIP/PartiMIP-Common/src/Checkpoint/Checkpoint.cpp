@@ -0,0 +1,111 @@
+/*=====================================================================================
+
+    Filename:     Checkpoint.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "Checkpoint.h"
+
+namespace
+{
+  const char *kHeader = "PartiMIP-Checkpoint";
+  constexpr int kVersion = 1;
+
+  /* Bounds and objectives may be infinite, which operator>> cannot read
+     back. */
+  bool ReadValue(istream &_in, double &_value)
+  {
+    string token;
+    if (!(_in >> token))
+      return false;
+    char *end;
+    _value = strtod(token.c_str(), &end);
+    return *end == '\0';
+  }
+}
+
+/* Replaces the file by renaming a temporary one, so a run killed while
+   writing still leaves the previous checkpoint behind. */
+bool Checkpoint::Write(const string &_path) const
+{
+  const string tempPath = _path + ".tmp";
+  FILE *file = fopen(tempPath.c_str(), "w");
+  if (file == nullptr)
+    return false;
+  fprintf(file, "%s %d\n", kHeader, kVersion);
+  fprintf(file, "model %d %d %d\n", (int)colNum, (int)rowNum, (int)nonzeroNum);
+  fprintf(file, "time %.6f\n", searchTime);
+  fprintf(file, "incumbent %.17g %ld\n", incumbentObj, incumbent.size());
+  for (size_t i = 0; i < incumbent.size(); ++i)
+    fprintf(file, "%.17g%c", incumbent[i], (i + 1) % 8 == 0 || i + 1 == incumbent.size() ? '\n' : ' ');
+  fprintf(file, "varbranch %ld\n", varBranchInSolved.size());
+  for (const auto &[name, count] : varBranchInSolved)
+    fprintf(file, "%s %ld\n", name.c_str(), count);
+  fprintf(file, "nodes %ld\n", nodes.size());
+  for (const CheckpointNode &node : nodes)
+    fprintf(file, "%lld %d %.17g %.17g %d %d %.17g %ld %ld %ld\n",
+            node.parent, (int)node.change.col, node.change.lower, node.change.upper,
+            (int)node.end, (int)node.problemStatus, node.obj,
+            node.varNum, node.conNum, node.nonzeroNum);
+  bool done = ferror(file) == 0;
+  done = fclose(file) == 0 && done;
+  if (done)
+    done = rename(tempPath.c_str(), _path.c_str()) == 0;
+  if (!done)
+    remove(tempPath.c_str());
+  return done;
+}
+
+bool Checkpoint::Read(const string &_path)
+{
+  ifstream file(_path);
+  string word;
+  int version;
+  if (!(file >> word >> version) || word != kHeader || version != kVersion)
+    return false;
+  size_t num;
+  if (!(file >> word >> colNum >> rowNum >> nonzeroNum) || word != "model" ||
+      !(file >> word >> searchTime) || word != "time" ||
+      !(file >> word) || word != "incumbent" || !ReadValue(file, incumbentObj) || !(file >> num) ||
+      (num != 0 && num != (size_t)colNum))
+    return false;
+  incumbent.resize(num);
+  for (double &value : incumbent)
+    if (!ReadValue(file, value))
+      return false;
+  if (!(file >> word >> num) || word != "varbranch")
+    return false;
+  varBranchInSolved.clear();
+  for (size_t i = 0; i < num; ++i)
+  {
+    string name;
+    size_t count;
+    if (!(file >> name >> count))
+      return false;
+    varBranchInSolved[name] = count;
+  }
+  if (!(file >> word >> num) || word != "nodes")
+    return false;
+  nodes.resize(num);
+  for (CheckpointNode &node : nodes)
+  {
+    int end, problemStatus;
+    if (!(file >> node.parent >> node.change.col) ||
+        !ReadValue(file, node.change.lower) || !ReadValue(file, node.change.upper) ||
+        !(file >> end >> problemStatus) || !ReadValue(file, node.obj) ||
+        !(file >> node.varNum >> node.conNum >> node.nonzeroNum))
+      return false;
+    node.end = end != 0;
+    node.problemStatus = (ProblemStatus)problemStatus;
+  }
+  return !nodes.empty();
+}
@@ -0,0 +1,54 @@
+/*=====================================================================================
+
+    Filename:     Checkpoint.h
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#pragma once
+#include "utils/header.h"
+#include "utils/paras.h"
+#include "Presolve/Presolve.h"
+
+/* One node of the saved tree. A node is its parent's reduced model with
+   one more bound change, so replaying the changes from the root and
+   presolving each node again gives back the same reduced models. */
+struct CheckpointNode
+{
+  long long parent;
+  BoundChange change;
+  bool end;
+  ProblemStatus problemStatus;
+  double obj;
+  /* Size of an open node's reduced model, to check the replay. */
+  size_t varNum;
+  size_t conNum;
+  size_t nonzeroNum;
+};
+
+/* Search state kept on disk: the open part of the tree in breadth-first
+   order, with each ended subtree cut down to its ended top node, the
+   branching scores and the incumbent of the original model. */
+struct Checkpoint
+{
+  HighsInt colNum = 0;
+  HighsInt rowNum = 0;
+  HighsInt nonzeroNum = 0;
+  /* Seconds searched by all runs that wrote this checkpoint. */
+  double searchTime = 0;
+  vector<CheckpointNode> nodes;
+  map<string, size_t> varBranchInSolved;
+  vector<double> incumbent;
+  double incumbentObj = INF;
+
+  bool Write(const string &_path) const;
+  bool Read(const string &_path);
+};
@@ -0,0 +1,501 @@
+/*=====================================================================================
+
+    Filename:     ModelCache.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "ModelCache.h"
+#include "Profiler/Profiler.h"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+  constexpr char kMagic[8] = {'P', 'M', 'I', 'P', 'C', 'A', 'C', 'H'};
+  constexpr uint64_t kFormatVersion = 2;
+  constexpr size_t kHashChunk = 16 << 20;
+
+  struct CacheHeader
+  {
+    char magic[8];
+    uint64_t version;
+    uint64_t key;
+    uint64_t size;
+    uint64_t rootOffset;
+    uint64_t intBytes;
+    /* Hash of everything after the header, as the models' values cannot
+       be checked otherwise. */
+    uint64_t checksum;
+  };
+
+  inline size_t Align(const size_t _size) { return (_size + 7) & ~(size_t)7; }
+
+  /* Appends 8-byte aligned fields; arrays carry their length in front. */
+  class CacheWriter
+  {
+  public:
+    CacheWriter(vector<char> &_buffer) : buffer_(_buffer) {}
+    template <typename T>
+    void Put(const T &_value) { Append(&_value, sizeof(T)); }
+    template <typename T>
+    void PutArray(const vector<T> &_array)
+    {
+      Put<uint64_t>(_array.size());
+      Append(_array.data(), _array.size() * sizeof(T));
+    }
+    void PutString(const string &_string)
+    {
+      Put<uint64_t>(_string.size());
+      Append(_string.data(), _string.size());
+    }
+    void PutStrings(const vector<string> &_strings)
+    {
+      vector<uint64_t> offsets(_strings.size() + 1, 0);
+      for (size_t i = 0; i < _strings.size(); ++i)
+        offsets[i + 1] = offsets[i] + _strings[i].size();
+      PutArray(offsets);
+      const size_t pos = Reserve(offsets.back());
+      for (size_t i = 0; i < _strings.size(); ++i)
+        memcpy(buffer_.data() + pos + offsets[i], _strings[i].data(), _strings[i].size());
+    }
+
+  private:
+    vector<char> &buffer_;
+
+    size_t Reserve(const size_t _size)
+    {
+      const size_t pos = buffer_.size();
+      buffer_.resize(pos + Align(_size));
+      return pos;
+    }
+    void Append(const void *_data, const size_t _size)
+    {
+      const size_t pos = Reserve(_size);
+      if (_size > 0)
+        memcpy(buffer_.data() + pos, _data, _size);
+    }
+  };
+
+  /* Reads what CacheWriter wrote, checking every length against the file. */
+  class CacheReader
+  {
+  public:
+    CacheReader(const char *_data, const size_t _size, const size_t _pos)
+        : data_(_data), size_(_size), pos_(_pos) {}
+    template <typename T>
+    bool Get(T &_value)
+    {
+      const char *data = Take(sizeof(T));
+      if (data == nullptr)
+        return false;
+      memcpy(&_value, data, sizeof(T));
+      return true;
+    }
+    template <typename T>
+    bool GetArray(vector<T> &_array)
+    {
+      uint64_t num;
+      if (!Get(num) || num > (size_ - pos_) / sizeof(T))
+        return false;
+      _array.resize(num);
+      const char *data = Take(num * sizeof(T));
+      if (data == nullptr)
+        return false;
+      if (num > 0)
+        memcpy(_array.data(), data, num * sizeof(T));
+      return true;
+    }
+    bool GetString(string &_string)
+    {
+      uint64_t num;
+      if (!Get(num) || num > size_ - pos_)
+        return false;
+      const char *data = Take(num);
+      if (data == nullptr)
+        return false;
+      _string.assign(data, num);
+      return true;
+    }
+    bool GetStrings(vector<string> &_strings)
+    {
+      vector<uint64_t> offsets;
+      if (!GetArray(offsets) || offsets.empty() || offsets.back() > size_ - pos_)
+        return false;
+      const char *data = Take(offsets.back());
+      if (data == nullptr)
+        return false;
+      _strings.resize(offsets.size() - 1);
+      for (size_t i = 0; i < _strings.size(); ++i)
+      {
+        if (offsets[i] > offsets[i + 1])
+          return false;
+        _strings[i].assign(data + offsets[i], offsets[i + 1] - offsets[i]);
+      }
+      return true;
+    }
+
+  private:
+    const char *data_;
+    size_t size_;
+    size_t pos_;
+
+    const char *Take(const size_t _size)
+    {
+      if (_size > size_ - pos_ || Align(_size) > size_ - pos_)
+        return nullptr;
+      const char *data = data_ + pos_;
+      pos_ += Align(_size);
+      return data;
+    }
+  };
+
+  void PutLp(CacheWriter &_writer, const HighsLp &_lp)
+  {
+    _writer.Put<int64_t>(_lp.num_col_);
+    _writer.Put<int64_t>(_lp.num_row_);
+    _writer.Put<int64_t>((int64_t)_lp.sense_);
+    _writer.Put<double>(_lp.offset_);
+    _writer.Put<int64_t>(_lp.cost_row_location_);
+    _writer.PutArray(_lp.col_cost_);
+    _writer.PutArray(_lp.col_lower_);
+    _writer.PutArray(_lp.col_upper_);
+    _writer.PutArray(_lp.row_lower_);
+    _writer.PutArray(_lp.row_upper_);
+    _writer.PutArray(_lp.a_matrix_.start_);
+    _writer.PutArray(_lp.a_matrix_.index_);
+    _writer.PutArray(_lp.a_matrix_.value_);
+    _writer.PutArray(_lp.integrality_);
+    _writer.PutString(_lp.model_name_);
+    _writer.PutString(_lp.objective_name_);
+    _writer.PutStrings(_lp.col_names_);
+    _writer.PutStrings(_lp.row_names_);
+  }
+
+  bool GetLp(CacheReader &_reader, HighsLp &_lp)
+  {
+    int64_t numCol, numRow, sense, costRowLocation;
+    _lp.clear();
+    if (!_reader.Get(numCol) || !_reader.Get(numRow) || !_reader.Get(sense) ||
+        !_reader.Get(_lp.offset_) || !_reader.Get(costRowLocation) ||
+        !_reader.GetArray(_lp.col_cost_) || !_reader.GetArray(_lp.col_lower_) ||
+        !_reader.GetArray(_lp.col_upper_) || !_reader.GetArray(_lp.row_lower_) ||
+        !_reader.GetArray(_lp.row_upper_) || !_reader.GetArray(_lp.a_matrix_.start_) ||
+        !_reader.GetArray(_lp.a_matrix_.index_) || !_reader.GetArray(_lp.a_matrix_.value_) ||
+        !_reader.GetArray(_lp.integrality_) || !_reader.GetString(_lp.model_name_) ||
+        !_reader.GetString(_lp.objective_name_) || !_reader.GetStrings(_lp.col_names_) ||
+        !_reader.GetStrings(_lp.row_names_))
+      return false;
+    const size_t colNum = numCol, rowNum = numRow;
+    if (numCol < 0 || numRow < 0 ||
+        _lp.col_cost_.size() != colNum || _lp.col_lower_.size() != colNum ||
+        _lp.col_upper_.size() != colNum || _lp.row_lower_.size() != rowNum ||
+        _lp.row_upper_.size() != rowNum || _lp.a_matrix_.start_.size() != colNum + 1 ||
+        _lp.a_matrix_.index_.size() != (size_t)_lp.a_matrix_.start_.back() ||
+        _lp.a_matrix_.value_.size() != _lp.a_matrix_.index_.size() ||
+        (!_lp.integrality_.empty() && _lp.integrality_.size() != colNum) ||
+        (!_lp.col_names_.empty() && _lp.col_names_.size() != colNum) ||
+        (!_lp.row_names_.empty() && _lp.row_names_.size() != rowNum))
+      return false;
+    for (size_t col = 0; col < colNum; ++col)
+      if (_lp.a_matrix_.start_[col] < 0 || _lp.a_matrix_.start_[col] > _lp.a_matrix_.start_[col + 1])
+        return false;
+    for (const HighsInt row : _lp.a_matrix_.index_)
+      if (row < 0 || row >= numRow)
+        return false;
+    _lp.num_col_ = numCol;
+    _lp.num_row_ = numRow;
+    _lp.sense_ = (ObjSense)sense;
+    _lp.cost_row_location_ = costRowLocation;
+    _lp.a_matrix_.format_ = MatrixFormat::kColwise;
+    _lp.setMatrixDimensions();
+    return true;
+  }
+
+  bool IsCacheable(const HighsPresolveStatus _status)
+  {
+    return _status == HighsPresolveStatus::kNotReduced ||
+           _status == HighsPresolveStatus::kReduced ||
+           _status == HighsPresolveStatus::kReducedToEmpty ||
+           _status == HighsPresolveStatus::kInfeasible ||
+           _status == HighsPresolveStatus::kUnboundedOrInfeasible;
+  }
+}
+
+void *ModelCacheWrite(void *arg)
+{
+  ModelCache *cache = (ModelCache *)arg;
+  Profiler::NameThread("model cache");
+  cache->Write();
+  return nullptr;
+}
+
+ModelCache::ModelCache(const string &_dir, const string &_instance, const string &_optionKey, ThreadPool *_pool)
+    : key_(0),
+      data_(nullptr),
+      size_(0),
+      rootOffset_(0),
+      threadStarted_(false),
+      modelLoaded_(false),
+      rootLoaded_(false),
+      storeStarted_(false),
+      written_(false),
+      hashTime_(0),
+      loadTime_(0)
+{
+  const double startTime = ElapsedTime();
+  uint64_t fileHash;
+  if (!HashFile(_instance, _pool, fileHash))
+  {
+    printf("c Model Cache: cannot read %s; cache off\n", _instance.c_str());
+    return;
+  }
+  key_ = MixHash(fileHash ^ HashBytes(_optionKey.data(), _optionKey.size()) ^ kFormatVersion);
+  hashTime_ = ElapsedTime() - startTime;
+  error_code error;
+  filesystem::create_directories(_dir, error);
+  char name[32];
+  snprintf(name, sizeof(name), "%016llx.pmc", (unsigned long long)key_);
+  path_ = (filesystem::path(_dir) / name).string();
+  const double mapTime = ElapsedTime();
+  Map();
+  loadTime_ = ElapsedTime() - mapTime;
+}
+
+ModelCache::~ModelCache()
+{
+  Finish();
+  Unmap();
+}
+
+/* Chunks of the instance are hashed in parallel and then combined in file
+   order. */
+bool ModelCache::HashFile(const string &_path, ThreadPool *_pool, uint64_t &_hash)
+{
+  const int fd = open(_path.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0)
+  {
+    close(fd);
+    return false;
+  }
+  const size_t size = st.st_size;
+  void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+    return false;
+  madvise(data, size, MADV_SEQUENTIAL);
+  const size_t chunkNum = (size + kHashChunk - 1) / kHashChunk;
+  vector<uint64_t> chunkHash(chunkNum);
+  auto hashChunk = [&](const size_t _chunk)
+  {
+    const size_t begin = _chunk * kHashChunk;
+    chunkHash[_chunk] = HashBytes((const char *)data + begin, min(kHashChunk, size - begin));
+  };
+  if (_pool == nullptr || chunkNum <= 1)
+    for (size_t chunk = 0; chunk < chunkNum; ++chunk)
+      hashChunk(chunk);
+  else
+  {
+    TaskGroup group;
+    for (size_t chunk = 0; chunk < chunkNum; ++chunk)
+      _pool->Submit(group, [&hashChunk, chunk]
+                    { hashChunk(chunk); });
+    _pool->Wait(group);
+  }
+  munmap(data, size);
+  _hash = MixHash(size);
+  for (const uint64_t hash : chunkHash)
+    _hash = MixHash(_hash ^ hash);
+  return true;
+}
+
+bool ModelCache::Map()
+{
+  const int fd = open(path_.c_str(), O_RDONLY);
+  if (fd < 0)
+    return false;
+  struct stat st;
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(CacheHeader))
+  {
+    close(fd);
+    return false;
+  }
+  size_ = st.st_size;
+  void *data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+    return false;
+  data_ = (const char *)data;
+  madvise(data, size_, MADV_SEQUENTIAL);
+  CacheHeader header;
+  memcpy(&header, data_, sizeof(header));
+  if (memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+      header.version != kFormatVersion || header.key != key_ ||
+      header.size != size_ || header.intBytes != sizeof(HighsInt) ||
+      header.rootOffset < sizeof(CacheHeader) || header.rootOffset > size_ ||
+      header.checksum != HashBytes(data_ + sizeof(CacheHeader), size_ - sizeof(CacheHeader)))
+  {
+    printf("c Model Cache: ignoring stale or damaged %s\n", path_.c_str());
+    Unmap();
+    return false;
+  }
+  rootOffset_ = header.rootOffset;
+  return true;
+}
+
+void ModelCache::Unmap()
+{
+  if (data_ != nullptr)
+    munmap((void *)data_, size_);
+  data_ = nullptr;
+  size_ = 0;
+}
+
+bool ModelCache::LoadModel(HighsModel &_model)
+{
+  if (!IsHit())
+    return false;
+  const double startTime = ElapsedTime();
+  CacheReader reader(data_, rootOffset_, sizeof(CacheHeader));
+  _model.clear();
+  if (!GetLp(reader, _model.lp_))
+  {
+    printf("c Model Cache: %s is damaged\n", path_.c_str());
+    _model.clear();
+    Unmap();
+    return false;
+  }
+  modelLoaded_ = true;
+  loadTime_ += ElapsedTime() - startTime;
+  return true;
+}
+
+/* The root's presolve result for _model: the status, the reduced model
+   and, if the presolve reduced the model, the column of _model of each
+   reduced column. */
+bool ModelCache::LoadRoot(const HighsModel &_model, HighsPresolveStatus &_status,
+                          HighsModel &_presolvedModel, vector<HighsInt> &_colIndex)
+{
+  if (!IsHit())
+    return false;
+  const double startTime = ElapsedTime();
+  CacheReader reader(data_, size_, rootOffset_);
+  int64_t status;
+  bool ok = reader.Get(status) &&
+            IsCacheable((HighsPresolveStatus)status) &&
+            GetLp(reader, _presolvedModel.lp_) &&
+            reader.GetArray(_colIndex) &&
+            _colIndex.size() == ((HighsPresolveStatus)status == HighsPresolveStatus::kReduced
+                                     ? (size_t)_presolvedModel.lp_.num_col_
+                                     : 0);
+  for (size_t i = 0; ok && i < _colIndex.size(); ++i)
+    ok = _colIndex[i] >= 0 && _colIndex[i] < _model.lp_.num_col_;
+  if (!ok)
+  {
+    printf("c Model Cache: %s is damaged\n", path_.c_str());
+    _presolvedModel.clear();
+    _colIndex.clear();
+    Unmap();
+    return false;
+  }
+  _status = (HighsPresolveStatus)status;
+  rootLoaded_ = true;
+  loadTime_ += ElapsedTime() - startTime;
+  return true;
+}
+
+/* Serializes the model and its presolve result at once, as the presolver
+   is used again as soon as this returns, and leaves the file to a thread. */
+void ModelCache::StoreRoot(const Highs &_presolver)
+{
+  const HighsModel &model = _presolver.getModel();
+  const HighsPresolveStatus status = _presolver.getModelPresolveStatus();
+  if (path_.empty() || IsHit() || storeStarted_ ||
+      !IsCacheable(status) || model.isQp() || !model.lp_.a_matrix_.isColwise())
+    return;
+  const HighsModel &presolvedModel = _presolver.getPresolvedModel();
+  if (!presolvedModel.lp_.a_matrix_.isColwise())
+    return;
+  storeStarted_ = true;
+  vector<HighsInt> colIndex;
+  if (status == HighsPresolveStatus::kReduced)
+    colIndex.assign(_presolver.getPresolveOrigColsIndex(),
+                    _presolver.getPresolveOrigColsIndex() + presolvedModel.lp_.num_col_);
+
+  CacheWriter writer(buffer_);
+  writer.Put(CacheHeader());
+  PutLp(writer, model.lp_);
+  const size_t rootOffset = buffer_.size();
+  writer.Put<int64_t>((int64_t)status);
+  PutLp(writer, presolvedModel.lp_);
+  writer.PutArray(colIndex);
+
+  CacheHeader header;
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kFormatVersion;
+  header.key = key_;
+  header.size = buffer_.size();
+  header.rootOffset = rootOffset;
+  header.intBytes = sizeof(HighsInt);
+  header.checksum = HashBytes(buffer_.data() + sizeof(CacheHeader), buffer_.size() - sizeof(CacheHeader));
+  memcpy(buffer_.data(), &header, sizeof(header));
+  threadStarted_ = pthread_create(&thread_, nullptr, ModelCacheWrite, this) == 0;
+  if (!threadStarted_)
+    Write();
+}
+
+/* Runs with other runs of the same instance possibly writing the same
+   file, so each writes its own temporary file and renames it. */
+void ModelCache::Write()
+{
+  const string tempPath = path_ + ".tmp" + to_string(getpid());
+  bool done = false;
+  FILE *file = fopen(tempPath.c_str(), "wb");
+  if (file != nullptr)
+  {
+    done = fwrite(buffer_.data(), 1, buffer_.size(), file) == buffer_.size();
+    done = fclose(file) == 0 && done;
+  }
+  if (done)
+    done = rename(tempPath.c_str(), path_.c_str()) == 0;
+  if (!done)
+  {
+    printf("c Model Cache: cannot write %s\n", path_.c_str());
+    remove(tempPath.c_str());
+  }
+  written_ = done;
+  size_ = done ? buffer_.size() : 0;
+  vector<char>().swap(buffer_);
+}
+
+void ModelCache::Finish()
+{
+  if (threadStarted_)
+    pthread_join(thread_, nullptr);
+  threadStarted_ = false;
+}
+
+void ModelCache::PrintStatistic() const
+{
+  if (path_.empty())
+    return;
+  const char *result = rootLoaded_    ? "hit"
+                       : modelLoaded_ ? "model hit, root presolved"
+                                      : "miss";
+  printf("c Model Cache: %s; %.3lf s hashing; %.3lf s loading; %s%ld bytes in %s\n",
+         result, hashTime_, loadTime_, written_ ? "stored " : "", size_, path_.c_str());
+}
@@ -0,0 +1,69 @@
+/*=====================================================================================
+
+    Filename:     ModelCache.h
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#pragma once
+#include "utils/header.h"
+#include "utils/paras.h"
+#include "ThreadPool/ThreadPool.h"
+
+/* On-disk cache of the original model and the presolved root model, so
+   that a warm run skips parsing and starts the search without waiting for
+   the root presolve. Only what HiGHS shows of a presolve is kept: its
+   status, the reduced model and the original column of each reduced
+   column. A cache file is named after a hash of the instance file's
+   bytes, the root presolver's options and the HiGHS version, and a hit is
+   trusted as is. Postsolving needs HiGHS' own presolve, whose postsolve
+   stack cannot be stored, so a root the presolve reduced is presolved
+   again on the pool, off the search's path but not for free: the first
+   lift waits for it. A cache file is a flat sequence of
+   8-byte aligned arrays that is mmapped, checked against the hash kept in
+   its header and copied straight into the HiGHS vectors. A new file is
+   written by a background thread once the root has been presolved. */
+class ModelCache
+{
+public:
+  ModelCache(const string &_dir, const string &_instance, const string &_optionKey, ThreadPool *_pool);
+  ~ModelCache();
+  bool LoadModel(HighsModel &_model);
+  bool LoadRoot(const HighsModel &_model, HighsPresolveStatus &_status,
+                HighsModel &_presolvedModel, vector<HighsInt> &_colIndex);
+  void StoreRoot(const Highs &_presolver);
+  void Finish();
+  inline bool IsHit() const { return data_ != nullptr; }
+  void PrintStatistic() const;
+
+private:
+  string path_;
+  uint64_t key_;
+  const char *data_;
+  size_t size_;
+  /* Offset of the presolved root in data_. */
+  size_t rootOffset_;
+  vector<char> buffer_;
+  pthread_t thread_;
+  bool threadStarted_;
+  bool modelLoaded_;
+  bool rootLoaded_;
+  bool storeStarted_;
+  bool written_;
+  double hashTime_;
+  double loadTime_;
+
+  bool HashFile(const string &_path, ThreadPool *_pool, uint64_t &_hash);
+  bool Map();
+  void Unmap();
+  void Write();
+  friend void *ModelCacheWrite(void *arg);
+};
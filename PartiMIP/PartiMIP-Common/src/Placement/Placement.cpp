@@ -0,0 +1,142 @@
+/*=====================================================================================
+
+    Filename:     Placement.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "Placement.h"
+#include <pthread.h>
+#include <sched.h>
+
+vector<vector<int>> Placement::numaCpus_;
+vector<int> Placement::cpus_;
+vector<int> Placement::numaNodes_;
+thread_local int Placement::currentNode_ = -1;
+
+namespace
+{
+  /* Parses a kernel cpu list such as "0-3,8,10-11". */
+  vector<int> ParseCpuList(const string &_list)
+  {
+    vector<int> cpus;
+    stringstream stream(_list);
+    string range;
+    while (getline(stream, range, ','))
+    {
+      int first, last;
+      const int num = sscanf(range.c_str(), "%d-%d", &first, &last);
+      if (num < 1)
+        continue;
+      if (num == 1)
+        last = first;
+      for (int cpu = first; cpu <= last; ++cpu)
+        cpus.push_back(cpu);
+    }
+    return cpus;
+  }
+}
+
+/* Only the cores this process may run on are used, so that pinning stays
+   inside a taskset or a cgroup's cpuset. */
+bool Placement::ReadTopology()
+{
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+    return false;
+  const string root = "/sys/devices/system/node/";
+  for (int node = 0; filesystem::exists(root + "node" + to_string(node)); ++node)
+  {
+    ifstream file(root + "node" + to_string(node) + "/cpulist");
+    string list;
+    getline(file, list);
+    vector<int> cpus;
+    for (int cpu : ParseCpuList(list))
+      if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed))
+        cpus.push_back(cpu);
+    if (!cpus.empty())
+      numaCpus_.push_back(cpus);
+  }
+  // No NUMA information: one node of all allowed cores.
+  if (numaCpus_.empty())
+  {
+    vector<int> cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+      if (CPU_ISSET(cpu, &allowed))
+        cpus.push_back(cpu);
+    if (!cpus.empty())
+      numaCpus_.push_back(cpus);
+  }
+  return !numaCpus_.empty();
+}
+
+/* Workers are spread evenly over the NUMA nodes in blocks of consecutive
+   tids. With more workers than cores, a node's cores are shared round
+   robin by its block. */
+void Placement::Init(const size_t _workerNum)
+{
+  if (OPT(pinThreads) == 0 || _workerNum == 0 || !ReadTopology())
+    return;
+  const size_t numaNum = numaCpus_.size();
+  const size_t blockSize = (_workerNum + numaNum - 1) / numaNum;
+  cpus_.resize(_workerNum);
+  numaNodes_.resize(_workerNum);
+  for (size_t tid = 0; tid < _workerNum; ++tid)
+  {
+    const size_t node = tid / blockSize;
+    const vector<int> &cpus = numaCpus_[node];
+    numaNodes_[tid] = node;
+    cpus_[tid] = cpus[(tid - node * blockSize) % cpus.size()];
+  }
+  printf("c Placement: %ld workers pinned over %ld NUMA nodes, up to %ld per node\n",
+         _workerNum, numaNum, blockSize);
+}
+
+/* Pins the calling thread to the core of worker _tid. */
+bool Placement::Pin(const size_t _tid)
+{
+  if (_tid >= cpus_.size())
+    return false;
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  CPU_SET(cpus_[_tid], &cpuSet);
+  if (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) != 0)
+  {
+    printf("c Placement: cannot pin worker %ld to core %d\n", _tid, cpus_[_tid]);
+    return false;
+  }
+  currentNode_ = numaNodes_[_tid];
+  return true;
+}
+
+/* Binds the calling thread, the _index-th of _threadNum, to every core of
+   one NUMA node, so that the threads cover the nodes in blocks as the
+   workers do. */
+bool Placement::PinToNode(const size_t _index, const size_t _threadNum)
+{
+  if (!IsEnabled() || _index >= _threadNum)
+    return false;
+  const size_t node = _index * numaCpus_.size() / _threadNum;
+  cpu_set_t cpuSet;
+  CPU_ZERO(&cpuSet);
+  for (int cpu : numaCpus_[node])
+    CPU_SET(cpu, &cpuSet);
+  if (pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) != 0)
+    return false;
+  currentNode_ = node;
+  return true;
+}
+
+int Placement::GetNumaNode(const size_t _tid)
+{
+  return _tid < numaNodes_.size() ? numaNodes_[_tid] : -1;
+}
@@ -0,0 +1,46 @@
+/*=====================================================================================
+
+    Filename:     Placement.h
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#pragma once
+#include "utils/header.h"
+#include "utils/paras.h"
+
+/* Pins workers to cores, filling one NUMA node before the next, so that
+   consecutive workers share a socket. Memory is not bound: Linux places
+   a page on the node of the thread that first touches it, so a pinned
+   worker's solver data is local. Node models are presolved by the
+   partition pool, whose threads are spread over the NUMA nodes in the
+   same way, each free to move within its node. */
+class Placement
+{
+public:
+  static void Init(const size_t _workerNum);
+  static bool Pin(const size_t _tid);
+  static bool PinToNode(const size_t _index, const size_t _threadNum);
+  static int GetNumaNode(const size_t _tid);
+  /* NUMA node of the calling thread; -1 if it is not pinned. */
+  static inline int GetCurrentNode() { return currentNode_; }
+  static inline bool IsEnabled() { return !cpus_.empty(); }
+  static inline size_t GetNumaNum() { return numaCpus_.size(); }
+
+private:
+  static vector<vector<int>> numaCpus_;
+  /* Core and NUMA node of each worker, in tid order. */
+  static vector<int> cpus_;
+  static vector<int> numaNodes_;
+  static thread_local int currentNode_;
+
+  static bool ReadTopology();
+};
@@ -0,0 +1,183 @@
+/*=====================================================================================
+
+    Filename:     PostsolveMap.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "PostsolveMap.h"
+#include "Profiler/Profiler.h"
+
+atomic<size_t> PostsolveMap::mapNum_(0);
+atomic<size_t> PostsolveMap::stepNum_(0);
+atomic<size_t> PostsolveMap::closedStepNum_(0);
+atomic<size_t> PostsolveMap::liftNum_(0);
+atomic<size_t> PostsolveMap::undoNum_(0);
+
+shared_ptr<const PostsolveMap> PostsolveMap::Identity(const HighsInt _colNum)
+{
+  shared_ptr<PostsolveMap> map = make_shared<PostsolveMap>();
+  map->ownStep_ = false;
+  map->colNum_ = _colNum;
+  map->colIndex_.resize(_colNum);
+  for (HighsInt i = 0; i < _colNum; ++i)
+    map->colIndex_[i] = i;
+  return map;
+}
+
+/* The map of a node from its parent's and its own presolve, which gives up
+   its presolver if it kept one. _parent is nullptr for the root, whose
+   input model is the original one. Nullptr if the presolve left nothing to
+   lift. */
+shared_ptr<const PostsolveMap> PostsolveMap::Build(
+    const shared_ptr<const PostsolveMap> &_parent, Presolve &_presolve)
+{
+  if (!_presolve.CanLift())
+    return nullptr;
+  const HighsLp &reduced = _presolve.GetReducedModel().lp_;
+  const vector<HighsInt> &stepColIndex = _presolve.GetStepColIndex();
+  shared_ptr<Highs> presolver = _presolve.TakePresolver();
+  mapNum_++;
+  if (presolver == nullptr)
+    return Compose(_parent, _presolve.GetInputColNum(), stepColIndex, _presolve.GetStepFixed());
+  shared_ptr<PostsolveMap> map = make_shared<PostsolveMap>();
+  shared_ptr<Step> step = make_shared<Step>();
+  step->presolver = std::move(presolver);
+  step->pending = step->presolver->getModelPresolveStatus() == HighsPresolveStatus::kNotPresolved;
+  step->next = _parent != nullptr ? _parent : Identity(_presolve.GetInputColNum());
+  map->colNum_ = reduced.num_col_;
+  map->colIndex_.resize(reduced.num_col_);
+  for (HighsInt i = 0; i < reduced.num_col_; ++i)
+    map->colIndex_[i] = i;
+  map->step_ = step;
+  map->ownStep_ = true;
+  stepNum_++;
+  return map;
+}
+
+/* The parent's map followed by a step that places the reduced columns at
+   _stepColIndex of its input model and gives the others fixed values. */
+shared_ptr<PostsolveMap> PostsolveMap::Compose(
+    const shared_ptr<const PostsolveMap> &_parent, const HighsInt _inputColNum,
+    const vector<HighsInt> &_stepColIndex, const vector<pair<HighsInt, double>> &_stepFixed)
+{
+  shared_ptr<PostsolveMap> map = make_shared<PostsolveMap>();
+  map->ownStep_ = false;
+  if (_parent == nullptr)
+  {
+    map->colNum_ = _inputColNum;
+    map->colIndex_ = _stepColIndex;
+    map->fixed_ = _stepFixed;
+    return map;
+  }
+  map->colNum_ = _parent->colNum_;
+  map->step_ = _parent->step_;
+  map->fixed_ = _parent->fixed_;
+  for (const pair<HighsInt, double> &fixed : _stepFixed)
+    map->fixed_.push_back({_parent->colIndex_[fixed.first], fixed.second});
+  map->colIndex_.resize(_stepColIndex.size());
+  for (size_t i = 0; i < _stepColIndex.size(); ++i)
+    map->colIndex_[i] = _parent->colIndex_[_stepColIndex[i]];
+  return map;
+}
+
+/* Runs the presolve of a cached root, as HiGHS keeps what it needs to
+   postsolve only in the Highs object that presolved. The result is not
+   compared with the cached one: the cache key covers the instance's
+   bytes, the presolver's options and the HiGHS version. Should it still
+   differ, HiGHS refuses the lifts, whose nodes then run unpresolved. */
+void PostsolveMap::PresolveCached(Step &_step)
+{
+  PhaseTimer timer(Phase::RootPresolve);
+  _step.pending = false;
+  _step.presolver->presolve();
+  Presolve::SetPostsolveOptions(*_step.presolver);
+}
+
+/* Runs the presolve of a cached root ahead of its first lift, which
+   then only postsolves. */
+void PostsolveMap::PresolvePending() const
+{
+  if (step_ == nullptr)
+    return;
+  boost::mutex::scoped_lock lock(step_->mutex);
+  if (step_->pending && step_->presolver != nullptr)
+    PresolveCached(*step_);
+}
+
+/* Places the columns and the fixed values, then postsolves through the
+   step's presolver if there is one, and so on down to the original model.
+   A closed step lifts nothing. */
+bool PostsolveMap::Lift(vector<double> &_colValue) const
+{
+  liftNum_++;
+  vector<double> lifted;
+  shared_ptr<const PostsolveMap> next;
+  for (const PostsolveMap *map = this; map != nullptr; map = next.get())
+  {
+    if (_colValue.size() != map->colIndex_.size())
+      return false;
+    lifted.assign(map->colNum_, 0);
+    for (const pair<HighsInt, double> &fixed : map->fixed_)
+      lifted[fixed.first] = fixed.second;
+    for (size_t i = 0; i < map->colIndex_.size(); ++i)
+      lifted[map->colIndex_[i]] = _colValue[i];
+    _colValue.swap(lifted);
+    if (map->step_ == nullptr)
+      return true;
+    Step &step = *map->step_;
+    HighsSolution solution;
+    solution.col_value.swap(_colValue);
+    solution.value_valid = true;
+    // Holds the next map, which a closing step lets go of.
+    shared_ptr<const PostsolveMap> stepNext;
+    {
+      boost::mutex::scoped_lock lock(step.mutex);
+      if (step.presolver == nullptr)
+        return false;
+      if (step.pending)
+        PresolveCached(step);
+      if (step.presolver->postsolve(solution) == HighsStatus::kError)
+        return false;
+      _colValue = step.presolver->getSolution().col_value;
+      stepNext = step.next;
+    }
+    undoNum_++;
+    next.swap(stepNext);
+  }
+  return false;
+}
+
+/* Frees the presolver of the step this map made, and the maps the step
+   goes on to. Called once the subtree of the node that made the step is
+   closed: no solution found below it can then better the tree's best,
+   which is already lifted. */
+void PostsolveMap::CloseStep() const
+{
+  if (!ownStep_)
+    return;
+  shared_ptr<Highs> presolver;
+  shared_ptr<const PostsolveMap> next;
+  {
+    boost::mutex::scoped_lock lock(step_->mutex);
+    if (step_->presolver == nullptr)
+      return;
+    presolver.swap(step_->presolver);
+    next.swap(step_->next);
+  }
+  closedStepNum_++;
+}
+
+void PostsolveMap::PrintStatistic()
+{
+  printf("c Postsolve Map: %ld maps, %ld HiGHS presolvers kept as steps, %ld freed with their subtrees; %ld solutions lifted through %ld steps\n",
+         (size_t)mapNum_, (size_t)stepNum_, (size_t)closedStepNum_, (size_t)liftNum_, (size_t)undoNum_);
+}
@@ -0,0 +1,74 @@
+/*=====================================================================================
+
+    Filename:     PostsolveMap.h
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#pragma once
+#include "utils/header.h"
+#include "Presolve/Presolve.h"
+
+/* Maps a primal solution of a node's reduced model straight to the
+   original model. Presolve steps that only fix columns and drop rows, as
+   the incremental presolve makes, are composed into one column map with
+   fixed values. A HiGHS presolve that reduced the model is kept as a
+   step, shared by every node below it, whose presolver postsolves; the
+   next map goes on from the step's input model. HiGHS does not show its
+   reductions, so such steps are never flattened: a lift postsolves
+   through each one on its path, as each node's own presolver did before.
+   A map never changes once built, and holds nothing of the presolvers it
+   was built from but the steps'. A step is freed, with the maps it goes
+   on to, once the subtree of the node that made it is closed. */
+class PostsolveMap
+{
+public:
+  static shared_ptr<const PostsolveMap> Build(
+      const shared_ptr<const PostsolveMap> &_parent, Presolve &_presolve);
+  bool Lift(vector<double> &_colValue) const;
+  void CloseStep() const;
+  void PresolvePending() const;
+  static void PrintStatistic();
+
+private:
+  struct Step
+  {
+    shared_ptr<Highs> presolver;
+    shared_ptr<const PostsolveMap> next;
+    /* A root taken from the model cache is presolved again on the pool
+       right after it is loaded, or on its first lift if that comes
+       sooner. */
+    bool pending;
+    /* Postsolving changes the presolver's solution. */
+    boost::mutex mutex;
+  };
+
+  /* Column of each reduced column in the model mapped to: the original
+     model, or the reduced model of step_'s presolver. */
+  HighsInt colNum_;
+  vector<HighsInt> colIndex_;
+  vector<pair<HighsInt, double>> fixed_;
+  shared_ptr<Step> step_;
+  /* step_ was made by this map rather than taken from the parent's. */
+  bool ownStep_;
+
+  static atomic<size_t> mapNum_;
+  static atomic<size_t> stepNum_;
+  static atomic<size_t> closedStepNum_;
+  static atomic<size_t> liftNum_;
+  static atomic<size_t> undoNum_;
+
+  static shared_ptr<const PostsolveMap> Identity(const HighsInt _colNum);
+  static shared_ptr<PostsolveMap> Compose(
+      const shared_ptr<const PostsolveMap> &_parent, const HighsInt _inputColNum,
+      const vector<HighsInt> &_stepColIndex, const vector<pair<HighsInt, double>> &_stepFixed);
+  static void PresolveCached(Step &_step);
+};
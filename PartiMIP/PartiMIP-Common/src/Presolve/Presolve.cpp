@@ -0,0 +1,482 @@
+/*=====================================================================================
+
+    Filename:     Presolve.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "Presolve.h"
+
+atomic<size_t> Presolve::incrementalNum_(0);
+atomic<size_t> Presolve::fixedColNum_(0);
+atomic<size_t> Presolve::removedRowNum_(0);
+
+Presolve::Presolve(const bool _initDone)
+    : presolver_(make_shared<Highs>()),
+      incremental_(false),
+      cached_(false),
+      status_(HighsPresolveStatus::kNotPresolved),
+      inputColNum_(0)
+{
+  presolver_->setOptionValue("log_to_console", "false");
+  presolver_->setOptionValue("mip_abs_gap", 0.0);
+  presolver_->setOptionValue("mip_rel_gap", 0.0);
+  // presolver_->setOptionValue("log_file", OPT(logPath) + "presolve.log");
+  presolver_->setOptionValue("threads", 1);
+}
+
+void Presolve::LoadModel(
+    const HighsModel &_baseModel,
+    const vector<BoundChange> &_boundChanges)
+{
+  presolver_->passModel(_baseModel);
+  for (const BoundChange &change : _boundChanges)
+    presolver_->changeColBounds(change.col, change.lower, change.upper);
+}
+
+static size_t LpBytes(const HighsLp &_lp)
+{
+  size_t bytes = sizeof(double) * (_lp.col_cost_.capacity() + _lp.col_lower_.capacity() +
+                                   _lp.col_upper_.capacity() + _lp.row_lower_.capacity() +
+                                   _lp.row_upper_.capacity() + _lp.a_matrix_.value_.capacity()) +
+                 sizeof(HighsInt) * (_lp.a_matrix_.start_.capacity() + _lp.a_matrix_.index_.capacity()) +
+                 sizeof(HighsVarType) * _lp.integrality_.capacity();
+  for (const string &name : _lp.col_names_)
+    bytes += sizeof(string) + name.capacity();
+  for (const string &name : _lp.row_names_)
+    bytes += sizeof(string) + name.capacity();
+  return bytes;
+}
+
+size_t Presolve::GetModelBytes() const
+{
+  return (presolver_ != nullptr ? LpBytes(presolver_->getLp()) : 0) + LpBytes(reducedModel_.lp_) +
+         sizeof(HighsInt) * stepColIndex_.capacity() +
+         sizeof(pair<HighsInt, double>) * stepFixed_.capacity();
+}
+void Presolve::SetPresolveOptions(Highs &_presolver)
+{
+  _presolver.setOptionValue("primal_feasibility_tolerance", 1e-10);
+  _presolver.setOptionValue("mip_feasibility_tolerance", 1e-10);
+}
+
+/* The tolerances HiGHS postsolved with here before. */
+void Presolve::SetPostsolveOptions(Highs &_presolver)
+{
+  _presolver.setOptionValue("primal_feasibility_tolerance", 1e-03);
+  _presolver.setOptionValue("mip_feasibility_tolerance", 1e-03);
+}
+
+void Presolve::PresolveByHighs()
+{
+  SetPresolveOptions(*presolver_);
+  presolver_->presolve();
+}
+
+/* Takes the model with the bounds as the reduced model, without presolving:
+   its solutions lift to _baseModel as they are. */
+void Presolve::LoadUnreduced(
+    const HighsModel &_baseModel,
+    const vector<BoundChange> &_boundChanges)
+{
+  presolver_.reset();
+  incremental_ = false;
+  cached_ = false;
+  status_ = HighsPresolveStatus::kNotReduced;
+  reducedModel_ = _baseModel;
+  HighsLp &lp = reducedModel_.lp_;
+  for (const BoundChange &change : _boundChanges)
+  {
+    lp.col_lower_[change.col] = change.lower;
+    lp.col_upper_[change.col] = change.upper;
+  }
+  inputColNum_ = lp.num_col_;
+  stepColIndex_.resize(lp.num_col_);
+  for (HighsInt i = 0; i < lp.num_col_; ++i)
+    stepColIndex_[i] = i;
+  stepFixed_.clear();
+}
+
+/* Presolves a child from its parent's reduced model, which is already
+   reduced, so only what the new bounds touch is looked at again: columns
+   they fix, the rows of those columns that become empty, singleton or
+   redundant, and columns left in no row. Each pass handles what the one
+   before queued, up to _maxPass passes. A model that is not column-wise
+   goes to HiGHS instead. */
+void Presolve::PresolveIncremental(
+    const HighsModel &_baseModel,
+    const vector<BoundChange> &_boundChanges,
+    const int _maxPass)
+{
+  const HighsLp &lp = _baseModel.lp_;
+  if (!lp.a_matrix_.isColwise())
+  {
+    LoadModel(_baseModel, _boundChanges);
+    PresolveByHighs();
+    return;
+  }
+  const double kTol = 1e-9;
+  const double kInfeasTol = 1e-6;
+  incremental_ = true;
+  const HighsInt colNum = lp.num_col_;
+  inputColNum_ = colNum;
+  const HighsInt rowNum = lp.num_row_;
+  const vector<HighsInt> &colStart = lp.a_matrix_.start_;
+  const vector<HighsInt> &colRow = lp.a_matrix_.index_;
+  const vector<double> &colValue = lp.a_matrix_.value_;
+  const bool mip = lp.integrality_.size() == (size_t)colNum;
+  vector<HighsInt> rowStart(rowNum + 1, 0);
+  for (HighsInt k = 0; k < colStart[colNum]; ++k)
+    rowStart[colRow[k] + 1]++;
+  for (HighsInt i = 0; i < rowNum; ++i)
+    rowStart[i + 1] += rowStart[i];
+  vector<HighsInt> rowCol(colStart[colNum]);
+  vector<double> rowValue(colStart[colNum]);
+  {
+    vector<HighsInt> next(rowStart.begin(), rowStart.end() - 1);
+    for (HighsInt j = 0; j < colNum; ++j)
+      for (HighsInt k = colStart[j]; k < colStart[j + 1]; ++k)
+      {
+        rowCol[next[colRow[k]]] = j;
+        rowValue[next[colRow[k]]++] = colValue[k];
+      }
+  }
+  vector<double> lower(lp.col_lower_);
+  vector<double> upper(lp.col_upper_);
+  vector<double> rowShift(rowNum, 0);
+  vector<HighsInt> rowCount(rowNum);
+  vector<HighsInt> colCount(colNum);
+  for (HighsInt i = 0; i < rowNum; ++i)
+    rowCount[i] = rowStart[i + 1] - rowStart[i];
+  for (HighsInt j = 0; j < colNum; ++j)
+    colCount[j] = colStart[j + 1] - colStart[j];
+  vector<char> colFixed(colNum, 0);
+  vector<char> rowRemoved(rowNum, 0);
+  vector<char> colQueued(colNum, 0);
+  vector<char> rowQueued(rowNum, 0);
+  vector<HighsInt> colQueue;
+  vector<HighsInt> rowQueue;
+  bool infeasible = false;
+  size_t fixedNum = 0;
+  size_t removedNum = 0;
+
+  auto queueCol = [&](const HighsInt _col)
+  {
+    if (!colQueued[_col] && !colFixed[_col])
+    {
+      colQueued[_col] = 1;
+      colQueue.push_back(_col);
+    }
+  };
+  auto queueRow = [&](const HighsInt _row)
+  {
+    if (!rowQueued[_row] && !rowRemoved[_row])
+    {
+      rowQueued[_row] = 1;
+      rowQueue.push_back(_row);
+    }
+  };
+  auto fixCol = [&](const HighsInt _col, const double _value)
+  {
+    colFixed[_col] = 1;
+    lower[_col] = upper[_col] = _value;
+    fixedNum++;
+    for (HighsInt k = colStart[_col]; k < colStart[_col + 1]; ++k)
+      if (!rowRemoved[colRow[k]])
+      {
+        rowShift[colRow[k]] += colValue[k] * _value;
+        rowCount[colRow[k]]--;
+        queueRow(colRow[k]);
+      }
+  };
+  auto removeRow = [&](const HighsInt _row)
+  {
+    rowRemoved[_row] = 1;
+    removedNum++;
+    for (HighsInt k = rowStart[_row]; k < rowStart[_row + 1]; ++k)
+      if (!colFixed[rowCol[k]] && --colCount[rowCol[k]] == 0)
+        queueCol(rowCol[k]);
+  };
+  // An empty row only has to hold at the fixed columns' values.
+  auto emptyRowFeasible = [&](const HighsInt _row)
+  {
+    return lp.row_lower_[_row] - rowShift[_row] <= kInfeasTol * max(1.0, fabs(lp.row_lower_[_row])) &&
+           lp.row_upper_[_row] - rowShift[_row] >= -kInfeasTol * max(1.0, fabs(lp.row_upper_[_row]));
+  };
+
+  for (const BoundChange &change : _boundChanges)
+  {
+    lower[change.col] = change.lower;
+    upper[change.col] = change.upper;
+    queueCol(change.col);
+    for (HighsInt k = colStart[change.col]; k < colStart[change.col + 1]; ++k)
+      queueRow(colRow[k]);
+  }
+  vector<HighsInt> cols;
+  vector<HighsInt> rows;
+  for (int pass = 0; pass < _maxPass && !infeasible && (!colQueue.empty() || !rowQueue.empty()); ++pass)
+  {
+    cols.swap(colQueue);
+    rows.swap(rowQueue);
+    colQueue.clear();
+    rowQueue.clear();
+    for (const HighsInt j : cols)
+    {
+      colQueued[j] = 0;
+      if (colFixed[j] || infeasible)
+        continue;
+      if (mip && lp.integrality_[j] == HighsVarType::kInteger)
+      {
+        lower[j] = ceil(lower[j] - kInfeasTol);
+        upper[j] = floor(upper[j] + kInfeasTol);
+      }
+      if (lower[j] > upper[j] + kInfeasTol * max(1.0, fabs(lower[j])))
+        infeasible = true;
+      else if (upper[j] - lower[j] <= kTol)
+        fixCol(j, lower[j]);
+      else if (colCount[j] == 0)
+      {
+        // Left in no row: the objective alone decides its value.
+        const double cost = lp.col_cost_[j] * (HighsInt)lp.sense_;
+        const double value = cost > 0   ? lower[j]
+                             : cost < 0 ? upper[j]
+                             : !isinf(lower[j]) ? lower[j]
+                             : !isinf(upper[j]) ? upper[j]
+                                                : 0;
+        if (!isinf(value))
+          fixCol(j, value);
+      }
+    }
+    for (const HighsInt i : rows)
+    {
+      rowQueued[i] = 0;
+      if (rowRemoved[i] || infeasible)
+        continue;
+      const double rowLower = lp.row_lower_[i] - rowShift[i];
+      const double rowUpper = lp.row_upper_[i] - rowShift[i];
+      if (rowCount[i] == 0)
+      {
+        if (!emptyRowFeasible(i))
+          infeasible = true;
+        else
+          removeRow(i);
+        continue;
+      }
+      double minAct = 0, maxAct = 0;
+      HighsInt minInf = 0, maxInf = 0, single = -1;
+      double singleValue = 0;
+      for (HighsInt k = rowStart[i]; k < rowStart[i + 1]; ++k)
+      {
+        const HighsInt j = rowCol[k];
+        if (colFixed[j])
+          continue;
+        const double value = rowValue[k];
+        const double low = value > 0 ? lower[j] : upper[j];
+        const double high = value > 0 ? upper[j] : lower[j];
+        if (isinf(low))
+          minInf++;
+        else
+          minAct += value * low;
+        if (isinf(high))
+          maxInf++;
+        else
+          maxAct += value * high;
+        single = j;
+        singleValue = value;
+      }
+      if ((minInf == 0 && minAct > rowUpper + kInfeasTol * max(1.0, fabs(rowUpper))) ||
+          (maxInf == 0 && maxAct < rowLower - kInfeasTol * max(1.0, fabs(rowLower))))
+        infeasible = true;
+      else if ((isinf(rowLower) || (minInf == 0 && minAct >= rowLower - kTol)) &&
+               (isinf(rowUpper) || (maxInf == 0 && maxAct <= rowUpper + kTol)))
+        removeRow(i);
+      else if (rowCount[i] == 1 && fabs(singleValue) > kTol)
+      {
+        // A singleton row is only a bound on its column.
+        double low = (singleValue > 0 ? rowLower : rowUpper) / singleValue;
+        double high = (singleValue > 0 ? rowUpper : rowLower) / singleValue;
+        removeRow(i);
+        lower[single] = max(lower[single], low);
+        upper[single] = min(upper[single], high);
+        queueCol(single);
+      }
+    }
+  }
+  // A row whose columns were all fixed is dropped even past the pass cap,
+  // so that a model without columns has no rows either.
+  for (HighsInt i = 0; i < rowNum && !infeasible; ++i)
+    if (!rowRemoved[i] && rowCount[i] == 0)
+    {
+      if (!emptyRowFeasible(i))
+        infeasible = true;
+      else
+        removeRow(i);
+    }
+  incrementalNum_++;
+  if (infeasible)
+  {
+    status_ = HighsPresolveStatus::kInfeasible;
+    return;
+  }
+  fixedColNum_ += fixedNum;
+  removedRowNum_ += removedNum;
+
+  vector<HighsInt> newRow(rowNum, -1);
+  HighsInt reducedRowNum = 0;
+  for (HighsInt i = 0; i < rowNum; ++i)
+    if (!rowRemoved[i])
+      newRow[i] = reducedRowNum++;
+  HighsLp &reduced = reducedModel_.lp_;
+  reduced.model_name_ = lp.model_name_;
+  reduced.sense_ = lp.sense_;
+  reduced.offset_ = lp.offset_;
+  reduced.a_matrix_.format_ = MatrixFormat::kColwise;
+  reduced.a_matrix_.start_.assign(1, 0);
+  for (HighsInt j = 0; j < colNum; ++j)
+  {
+    if (colFixed[j])
+    {
+      stepFixed_.push_back({j, lower[j]});
+      reduced.offset_ += lp.col_cost_[j] * lower[j];
+      continue;
+    }
+    stepColIndex_.push_back(j);
+    reduced.col_cost_.push_back(lp.col_cost_[j]);
+    reduced.col_lower_.push_back(lower[j]);
+    reduced.col_upper_.push_back(upper[j]);
+    if (mip)
+      reduced.integrality_.push_back(lp.integrality_[j]);
+    if (lp.col_names_.size() == (size_t)colNum)
+      reduced.col_names_.push_back(lp.col_names_[j]);
+    for (HighsInt k = colStart[j]; k < colStart[j + 1]; ++k)
+      if (!rowRemoved[colRow[k]])
+      {
+        reduced.a_matrix_.index_.push_back(newRow[colRow[k]]);
+        reduced.a_matrix_.value_.push_back(colValue[k]);
+      }
+    reduced.a_matrix_.start_.push_back(reduced.a_matrix_.index_.size());
+  }
+  for (HighsInt i = 0; i < rowNum; ++i)
+    if (!rowRemoved[i])
+    {
+      reduced.row_lower_.push_back(lp.row_lower_[i] - rowShift[i]);
+      reduced.row_upper_.push_back(lp.row_upper_[i] - rowShift[i]);
+      if (lp.row_names_.size() == (size_t)rowNum)
+        reduced.row_names_.push_back(lp.row_names_[i]);
+    }
+  reduced.num_col_ = stepColIndex_.size();
+  reduced.num_row_ = reducedRowNum;
+  reduced.a_matrix_.num_col_ = reduced.num_col_;
+  reduced.a_matrix_.num_row_ = reduced.num_row_;
+  status_ = reduced.num_col_ == 0 && reduced.num_row_ == 0 ? HighsPresolveStatus::kReducedToEmpty
+            : fixedNum == 0 && removedNum == 0             ? HighsPresolveStatus::kNotReduced
+                                                           : HighsPresolveStatus::kReduced;
+}
+
+/* Takes the root's presolve result from the cache instead of running it.
+   The presolver is given the input model for the postsolve map to presolve
+   again, as HiGHS cannot be handed a presolve result. */
+bool Presolve::LoadRoot(ModelCache &_cache, const HighsModel &_baseModel)
+{
+  if (!_cache.LoadRoot(_baseModel, status_, reducedModel_, stepColIndex_))
+    return false;
+  cached_ = true;
+  inputColNum_ = _baseModel.lp_.num_col_;
+  if (status_ != HighsPresolveStatus::kReduced)
+  {
+    stepColIndex_.resize(reducedModel_.lp_.num_col_);
+    for (HighsInt i = 0; i < reducedModel_.lp_.num_col_; ++i)
+      stepColIndex_[i] = i;
+  }
+  LoadModel(_baseModel, {});
+  SetPresolveOptions(*presolver_);
+  return true;
+}
+
+/* Every option the presolver runs with, so that a cached presolve result is
+   only reused under the same settings. */
+string Presolve::OptionKey()
+{
+  Presolve presolve(false);
+  SetPresolveOptions(*presolve.presolver_);
+  string key = presolve.presolver_->version();
+  for (const OptionRecord *record : presolve.presolver_->getOptions().records)
+  {
+    key += "\n" + record->name + "=";
+    if (record->type == HighsOptionType::kBool)
+      key += to_string(*((const OptionRecordBool *)record)->value);
+    else if (record->type == HighsOptionType::kInt)
+      key += to_string(*((const OptionRecordInt *)record)->value);
+    else if (record->type == HighsOptionType::kDouble)
+    {
+      char value[32];
+      snprintf(value, sizeof(value), "%.17g", *((const OptionRecordDouble *)record)->value);
+      key += value;
+    }
+    else
+      key += *((const OptionRecordString *)record)->value;
+  }
+  return key;
+}
+
+/* Copies the result of a HiGHS presolve out of the Highs object. It is
+   kept, with its copy of the input model, only if it reduced the model and
+   so has to postsolve, and only if asked to; a model it did not reduce
+   maps column to column. */
+void Presolve::Detach(const bool _keepPresolver)
+{
+  if (incremental_)
+  {
+    presolver_.reset();
+    return;
+  }
+  if (!cached_)
+  {
+    status_ = presolver_->getModelPresolveStatus();
+    inputColNum_ = presolver_->getLp().num_col_;
+  }
+  if (!cached_ && CanLift())
+  {
+    reducedModel_ = presolver_->getPresolvedModel();
+    const HighsInt colNum = reducedModel_.lp_.num_col_;
+    const HighsInt *colIndex = presolver_->getPresolveOrigColsIndex();
+    stepColIndex_.resize(colNum);
+    for (HighsInt i = 0; i < colNum; ++i)
+      stepColIndex_[i] = status_ == HighsPresolveStatus::kReduced ? colIndex[i] : i;
+  }
+  if (_keepPresolver && (status_ == HighsPresolveStatus::kReduced ||
+                         status_ == HighsPresolveStatus::kReducedToEmpty))
+  {
+    if (!cached_)
+      SetPostsolveOptions(*presolver_);
+  }
+  else
+    presolver_.reset();
+}
+
+bool Presolve::CheckPresolveInfeas()
+{
+  return status_ == HighsPresolveStatus::kInfeasible ||
+         status_ == HighsPresolveStatus::kUnboundedOrInfeasible;
+}
+
+bool Presolve::CheckPresolveOptimal()
+{
+  return status_ == HighsPresolveStatus::kReducedToEmpty;
+}
+
+void Presolve::PrintStatistic()
+{
+  if (incrementalNum_ == 0)
+    return;
+  printf("c Incremental Presolve: %ld children; %ld columns fixed, %ld rows removed\n",
+         (size_t)incrementalNum_, (size_t)fixedColNum_, (size_t)removedRowNum_);
+}
@@ -0,0 +1,96 @@
+/*=====================================================================================
+
+    Filename:     Presolve.h
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#pragma once
+#include "utils/header.h"
+#include "utils/paras.h"
+#include "ModelCache/ModelCache.h"
+
+/* A column bound fixed by branching, kept on the node until its model is built. */
+struct BoundChange
+{
+  HighsInt col;
+  double lower;
+  double upper;
+};
+
+class Presolve
+{
+public:
+  Presolve(const bool _initDone);
+  void LoadModel(
+      const HighsModel &_baseModel,
+      const vector<BoundChange> &_boundChanges);
+  void PresolveByHighs();
+  void LoadUnreduced(
+      const HighsModel &_baseModel,
+      const vector<BoundChange> &_boundChanges);
+  void PresolveIncremental(
+      const HighsModel &_baseModel,
+      const vector<BoundChange> &_boundChanges,
+      const int _maxPass);
+  static void PrintStatistic();
+  bool LoadRoot(ModelCache &_cache, const HighsModel &_baseModel);
+  void StoreRoot(ModelCache &_cache) { _cache.StoreRoot(*presolver_); }
+  static string OptionKey();
+  static void SetPresolveOptions(Highs &_presolver);
+  static void SetPostsolveOptions(Highs &_presolver);
+  void Detach(const bool _keepPresolver = true);
+  inline const HighsModel &GetReducedModel() const { return reducedModel_; }
+  inline const vector<HighsInt> &GetStepColIndex() const { return stepColIndex_; }
+  inline const vector<pair<HighsInt, double>> &GetStepFixed() const { return stepFixed_; }
+  inline HighsInt GetInputColNum() const { return inputColNum_; }
+  inline bool CanLift() const
+  {
+    return status_ == HighsPresolveStatus::kNotReduced ||
+           status_ == HighsPresolveStatus::kReduced ||
+           status_ == HighsPresolveStatus::kReducedToEmpty;
+  }
+  shared_ptr<Highs> TakePresolver() { return std::move(presolver_); }
+  bool CheckPresolveInfeas();
+  bool CheckPresolveOptimal();
+  void Release()
+  {
+    presolver_.reset();
+    reducedModel_.clear();
+    vector<HighsInt>().swap(stepColIndex_);
+    vector<pair<HighsInt, double>>().swap(stepFixed_);
+  }
+  size_t GetModelBytes() const;
+  ~Presolve() = default;
+
+private:
+  /* Holds the input model and the HiGHS presolve result. After Detach()
+     only kept if the presolve reduced the model: HiGHS does not show what
+     its reductions were, so the presolver itself postsolves, once a
+     postsolve map has taken it. */
+  shared_ptr<Highs> presolver_;
+
+  /* The presolve result, whether HiGHS or the incremental presolve made it:
+     the reduced model, the input model column of each reduced column, and
+     the columns of the input model fixed on the way. */
+  bool incremental_;
+  /* Taken from the model cache; the presolver only has the input model. */
+  bool cached_;
+  HighsPresolveStatus status_;
+  HighsModel reducedModel_;
+  HighsInt inputColNum_;
+  vector<HighsInt> stepColIndex_;
+  vector<pair<HighsInt, double>> stepFixed_;
+
+  static atomic<size_t> incrementalNum_;
+  static atomic<size_t> fixedColNum_;
+  static atomic<size_t> removedRowNum_;
+};
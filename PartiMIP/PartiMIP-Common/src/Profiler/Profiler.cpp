@@ -0,0 +1,167 @@
+/*=====================================================================================
+
+    Filename:     Profiler.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "Profiler.h"
+
+thread_local Profiler::Slot *Profiler::localSlot_ = nullptr;
+vector<Profiler::Slot *> Profiler::slots_;
+boost::mutex Profiler::mutexSlots_;
+size_t Profiler::traceBufferSize_ = 0;
+
+const char *PhaseToString(const Phase &_phase)
+{
+  switch (_phase)
+  {
+  case Phase::ReadModel:
+    return "readModel";
+  case Phase::RootPresolve:
+    return "rootPresolve";
+  case Phase::InitPartition:
+    return "initPartition";
+  case Phase::ChildPresolve:
+    return "childPresolve";
+  case Phase::DispatchWait:
+    return "dispatchWait";
+  case Phase::WorkerIdle:
+    return "workerIdle";
+  case Phase::SolverSetup:
+    return "solverSetup";
+  case Phase::Solve:
+    return "solve";
+  case Phase::Partition:
+    return "partition";
+  default:
+    return "unknown";
+  }
+}
+
+Profiler::Slot *Profiler::NewSlot()
+{
+  Slot *slot = new Slot();
+  slot->name = "thread";
+  fill(slot->time, slot->time + PhaseNum, 0.0);
+  fill(slot->count, slot->count + PhaseNum, (size_t)0);
+  slot->eventNum = 0;
+  boost::mutex::scoped_lock lock(mutexSlots_);
+  slots_.push_back(slot);
+  return slot;
+}
+
+void Profiler::NameThread(const string &_name)
+{
+  LocalSlot()->name = _name;
+}
+
+static void WritePhases(FILE *_file, const double *_time, const size_t *_count)
+{
+  fprintf(_file, "{");
+  for (int phase = 0; phase < PhaseNum; phase++)
+    fprintf(_file, "%s\"%s\": {\"time\": %.6lf, \"count\": %ld}",
+            phase == 0 ? "" : ", ", PhaseToString((Phase)phase), _time[phase], _count[phase]);
+  fprintf(_file, "}");
+}
+
+/* Phase times are summed over threads, so phases running in parallel add up
+   to more than the wall time. Utilization is the share of the workers' wall
+   time spent setting up and running the solver. */
+void Profiler::WriteReport(const string &_path, const size_t _workerNum)
+{
+  FILE *file = fopen(_path.c_str(), "w");
+  if (file == nullptr)
+  {
+    printf("c Profile: cannot write %s\n", _path.c_str());
+    return;
+  }
+  const double wallTime = ElapsedTime();
+  boost::mutex::scoped_lock lock(mutexSlots_);
+  double time[PhaseNum] = {};
+  size_t count[PhaseNum] = {};
+  for (Slot *slot : slots_)
+    for (int phase = 0; phase < PhaseNum; phase++)
+    {
+      time[phase] += slot->time[phase];
+      count[phase] += slot->count[phase];
+    }
+  const double busyTime = time[Phase::SolverSetup] + time[Phase::Solve];
+  const double utilization = wallTime > 0 && _workerNum > 0
+                                 ? busyTime / (wallTime * _workerNum) * 100
+                                 : 0.0;
+  fprintf(file, "{\n");
+  fprintf(file, "  \"threadNum\": %ld,\n", _workerNum);
+  fprintf(file, "  \"wallTime\": %.6lf,\n", wallTime);
+  fprintf(file, "  \"workerUtilization\": %.2lf,\n", utilization);
+  fprintf(file, "  \"phases\": ");
+  WritePhases(file, time, count);
+  fprintf(file, ",\n  \"threads\": [\n");
+  for (size_t idx = 0; idx < slots_.size(); idx++)
+  {
+    fprintf(file, "    {\"name\": \"%s\", \"phases\": ", slots_[idx]->name.c_str());
+    WritePhases(file, slots_[idx]->time, slots_[idx]->count);
+    fprintf(file, "}%s\n", idx + 1 < slots_.size() ? "," : "");
+  }
+  fprintf(file, "  ]\n}\n");
+  fclose(file);
+  printf("c Profile: %.2lf%% worker utilization; report written to %s\n", utilization, _path.c_str());
+}
+
+void Profiler::EnableTrace(const size_t _bufferSize)
+{
+  traceBufferSize_ = _bufferSize;
+}
+
+/* Chrome trace-event format; timestamps and durations are in microseconds.
+   Each slot becomes one thread row, named after the slot. */
+void Profiler::WriteTrace(const string &_path)
+{
+  FILE *file = fopen(_path.c_str(), "w");
+  if (file == nullptr)
+  {
+    printf("c Trace: cannot write %s\n", _path.c_str());
+    return;
+  }
+  boost::mutex::scoped_lock lock(mutexSlots_);
+  size_t eventNum = 0, droppedNum = 0;
+  fprintf(file, "{\"traceEvents\": [\n");
+  for (size_t tid = 0; tid < slots_.size(); tid++)
+    fprintf(file, "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %ld, \"args\": {\"name\": \"%s\"}}",
+            tid == 0 ? "" : ",\n", tid, slots_[tid]->name.c_str());
+  for (size_t tid = 0; tid < slots_.size(); tid++)
+  {
+    const Slot *slot = slots_[tid];
+    const size_t size = slot->events.size();
+    const size_t first = slot->eventNum > size ? slot->eventNum % size : 0;
+    for (size_t idx = 0; idx < size; idx++)
+    {
+      const TraceEvent &event = slot->events[(first + idx) % size];
+      fprintf(file, ",\n{\"cat\": \"%s\", \"name\": \"%s\", \"ph\": \"%c\", \"pid\": 0, \"tid\": %ld, \"ts\": %.1lf",
+              event.category, event.name, event.type, tid, event.time * 1e6);
+      if (event.type == 'X')
+        fprintf(file, ", \"dur\": %.1lf", event.duration * 1e6);
+      else if (event.type == 'i')
+        fprintf(file, ", \"s\": \"t\"");
+      if (event.type == 'C')
+        fprintf(file, ", \"args\": {\"%s\": %.6lf}", event.name, event.value);
+      else if (event.id >= 0)
+        fprintf(file, ", \"args\": {\"node\": %lld}", event.id);
+      fprintf(file, "}");
+    }
+    eventNum += size;
+    droppedNum += slot->eventNum - size;
+  }
+  fprintf(file, "\n]}\n");
+  fclose(file);
+  printf("c Trace: %ld events written to %s; %ld older events dropped\n",
+         eventNum, _path.c_str(), droppedNum);
+}
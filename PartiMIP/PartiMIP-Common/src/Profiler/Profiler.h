@@ -0,0 +1,133 @@
+/*=====================================================================================
+
+    Filename:     Profiler.h
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#pragma once
+#include "utils/header.h"
+#include "utils/paras.h"
+
+enum Phase
+{
+  ReadModel,
+  RootPresolve,
+  InitPartition,
+  ChildPresolve,
+  DispatchWait,
+  WorkerIdle,
+  SolverSetup,
+  Solve,
+  Partition,
+  PhaseNum
+};
+
+const char *PhaseToString(const Phase &_phase);
+
+struct TraceEvent
+{
+  const char *category;
+  const char *name;
+  char type;
+  double time;
+  double duration;
+  long long id;
+  double value;
+};
+
+/* Per-thread phase timers and trace buffers. Every thread owns one slot and
+   writes it without locking; the slot list is only locked when a thread
+   registers, and the slots are merged once all threads are done. The trace
+   buffer of a slot is a ring, so a long run keeps its most recent events. */
+class Profiler
+{
+public:
+  static void NameThread(const string &_name);
+  static inline void Record(const Phase _phase, const double _time)
+  {
+    Slot *slot = LocalSlot();
+    slot->time[_phase] += _time;
+    slot->count[_phase]++;
+  }
+  static void WriteReport(const string &_path, const size_t _workerNum);
+
+  /* Records the time since _startTime and, when tracing, the span itself
+     tagged with the node it worked on. */
+  static inline void RecordSpan(const Phase _phase, const double _startTime, const long long _id)
+  {
+    const double duration = ElapsedTime() - _startTime;
+    Record(_phase, duration);
+    Trace("phase", PhaseToString(_phase), 'X', _startTime, duration, _id, 0);
+  }
+
+  static void EnableTrace(const size_t _bufferSize);
+  static inline bool IsTracing() { return traceBufferSize_ > 0; }
+  static inline void Trace(const char *_category, const char *_name, const char _type,
+                           const double _time, const double _duration,
+                           const long long _id, const double _value)
+  {
+    if (!IsTracing())
+      return;
+    Slot *slot = LocalSlot();
+    if (slot->events.size() < traceBufferSize_)
+      slot->events.push_back({_category, _name, _type, _time, _duration, _id, _value});
+    else
+      slot->events[slot->eventNum % traceBufferSize_] = {_category, _name, _type, _time, _duration, _id, _value};
+    slot->eventNum++;
+  }
+  static inline void TraceInstant(const char *_category, const char *_name, const long long _id)
+  {
+    Trace(_category, _name, 'i', ElapsedTime(), 0, _id, 0);
+  }
+  static inline void TraceCounter(const char *_name, const double _value)
+  {
+    Trace("counter", _name, 'C', ElapsedTime(), 0, -1, _value);
+  }
+  static void WriteTrace(const string &_path);
+
+private:
+  struct Slot
+  {
+    string name;
+    double time[PhaseNum];
+    size_t count[PhaseNum];
+    vector<TraceEvent> events;
+    size_t eventNum;
+  };
+
+  static thread_local Slot *localSlot_;
+  static vector<Slot *> slots_;
+  static boost::mutex mutexSlots_;
+  static size_t traceBufferSize_;
+
+  static inline Slot *LocalSlot()
+  {
+    if (localSlot_ == nullptr)
+      localSlot_ = NewSlot();
+    return localSlot_;
+  }
+  static Slot *NewSlot();
+};
+
+/* Records the time from construction to destruction as one span. */
+class PhaseTimer
+{
+public:
+  PhaseTimer(const Phase _phase, const long long _id = -1)
+      : phase_(_phase), id_(_id), startTime_(ElapsedTime()) {}
+  ~PhaseTimer() { Profiler::RecordSpan(phase_, startTime_, id_); }
+
+private:
+  Phase phase_;
+  long long id_;
+  double startTime_;
+};
@@ -0,0 +1,354 @@
+/*=====================================================================================
+
+    Filename:     Propagator.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "Propagator.h"
+
+atomic<size_t> Propagator::checkNum_(0);
+atomic<size_t> Propagator::infeasibleNum_(0);
+atomic<size_t> Propagator::tightenNum_(0);
+atomic<uint64_t> Propagator::timeNs_(0);
+
+namespace
+{
+  const double kFeasTol = 1e-6;
+  const double kIntTol = 1e-6;
+  /* Implied bounds beyond this are not worth carrying. */
+  const double kMaxBound = 1e9;
+  /* Independent partial sums of a row scan. */
+  const HighsInt kLaneNum = 4;
+
+  /* Turns one compressed matrix into the other orientation. */
+  void Transpose(const HighsInt _majorNum, const HighsInt _minorNum,
+                 const vector<HighsInt> &_start, const vector<HighsInt> &_index, const vector<double> &_value,
+                 vector<HighsInt> &_tStart, vector<HighsInt> &_tIndex, vector<double> &_tValue)
+  {
+    const HighsInt nonzeroNum = _start[_majorNum];
+    _tStart.assign(_minorNum + 1, 0);
+    for (HighsInt k = 0; k < nonzeroNum; ++k)
+      _tStart[_index[k] + 1]++;
+    for (HighsInt i = 0; i < _minorNum; ++i)
+      _tStart[i + 1] += _tStart[i];
+    _tIndex.resize(nonzeroNum);
+    _tValue.resize(nonzeroNum);
+    vector<HighsInt> next(_tStart.begin(), _tStart.end() - 1);
+    for (HighsInt j = 0; j < _majorNum; ++j)
+      for (HighsInt k = _start[j]; k < _start[j + 1]; ++k)
+      {
+        const HighsInt pos = next[_index[k]]++;
+        _tIndex[pos] = j;
+        _tValue[pos] = _value[k];
+      }
+  }
+}
+
+Propagator::Propagator(const HighsLp &_lp)
+    : colNum_(_lp.num_col_),
+      rowNum_(_lp.num_row_),
+      rowLower_(_lp.row_lower_),
+      rowUpper_(_lp.row_upper_),
+      integer_(_lp.num_col_, 0),
+      baseLower_(_lp.col_lower_),
+      baseUpper_(_lp.col_upper_),
+      work_(0)
+{
+  const HighsSparseMatrix &matrix = _lp.a_matrix_;
+  if (matrix.isColwise())
+  {
+    colStart_.assign(matrix.start_.begin(), matrix.start_.begin() + colNum_ + 1);
+    colRow_.assign(matrix.index_.begin(), matrix.index_.begin() + colStart_[colNum_]);
+    colValue_.assign(matrix.value_.begin(), matrix.value_.begin() + colStart_[colNum_]);
+    Transpose(colNum_, rowNum_, colStart_, colRow_, colValue_, rowStart_, rowCol_, rowValue_);
+  }
+  else
+  {
+    rowStart_.assign(matrix.start_.begin(), matrix.start_.begin() + rowNum_ + 1);
+    rowCol_.assign(matrix.index_.begin(), matrix.index_.begin() + rowStart_[rowNum_]);
+    rowValue_.assign(matrix.value_.begin(), matrix.value_.begin() + rowStart_[rowNum_]);
+    Transpose(rowNum_, colNum_, rowStart_, rowCol_, rowValue_, colStart_, colRow_, colValue_);
+  }
+  if (_lp.integrality_.size() == (size_t)colNum_)
+    for (HighsInt j = 0; j < colNum_; ++j)
+      integer_[j] = _lp.integrality_[j] == HighsVarType::kInteger;
+  lower_ = baseLower_;
+  upper_ = baseUpper_;
+  baseMinAct_.resize(rowNum_);
+  baseMaxAct_.resize(rowNum_);
+  baseMinInf_.resize(rowNum_);
+  baseMaxInf_.resize(rowNum_);
+  for (HighsInt i = 0; i < rowNum_; ++i)
+    ScanRow(i, baseMinAct_[i], baseMaxAct_[i], baseMinInf_[i], baseMaxInf_[i]);
+  inQueue_.assign(rowNum_, 0);
+  colChanged_.assign(colNum_, 0);
+}
+
+/* One pass over the row in the row-wise copy. The bounds are gathered
+   kLaneNum at a time and the lanes are then summed without branches:
+   the contribution's ends are the smaller and the larger of the two
+   products and infinite ones are counted, not added, so that the
+   compiler can run the lanes side by side in SIMD registers. */
+void Propagator::ScanRow(
+    const HighsInt _row, double &_minAct, double &_maxAct,
+    HighsInt &_minInf, HighsInt &_maxInf) const
+{
+  double minAct[kLaneNum] = {}, maxAct[kLaneNum] = {};
+  double minInf[kLaneNum] = {}, maxInf[kLaneNum] = {};
+  const HighsInt end = rowStart_[_row + 1];
+  HighsInt k = rowStart_[_row];
+  for (; k + kLaneNum <= end; k += kLaneNum)
+  {
+    double lower[kLaneNum], upper[kLaneNum];
+    for (HighsInt lane = 0; lane < kLaneNum; ++lane)
+    {
+      lower[lane] = lower_[rowCol_[k + lane]];
+      upper[lane] = upper_[rowCol_[k + lane]];
+    }
+    for (HighsInt lane = 0; lane < kLaneNum; ++lane)
+    {
+      const double atLower = rowValue_[k + lane] * lower[lane];
+      const double atUpper = rowValue_[k + lane] * upper[lane];
+      const double low = atLower < atUpper ? atLower : atUpper;
+      const double high = atLower < atUpper ? atUpper : atLower;
+      minInf[lane] += low == -kHighsInf ? 1.0 : 0.0;
+      maxInf[lane] += high == kHighsInf ? 1.0 : 0.0;
+      minAct[lane] += low == -kHighsInf ? 0.0 : low;
+      maxAct[lane] += high == kHighsInf ? 0.0 : high;
+    }
+  }
+  for (; k < end; ++k)
+  {
+    const double atLower = rowValue_[k] * lower_[rowCol_[k]];
+    const double atUpper = rowValue_[k] * upper_[rowCol_[k]];
+    const double low = min(atLower, atUpper);
+    const double high = max(atLower, atUpper);
+    minInf[0] += isinf(low);
+    maxInf[0] += isinf(high);
+    minAct[0] += isinf(low) ? 0 : low;
+    maxAct[0] += isinf(high) ? 0 : high;
+  }
+  _minAct = 0;
+  _maxAct = 0;
+  double minCount = 0, maxCount = 0;
+  for (HighsInt lane = 0; lane < kLaneNum; ++lane)
+  {
+    _minAct += minAct[lane];
+    _maxAct += maxAct[lane];
+    minCount += minInf[lane];
+    maxCount += maxInf[lane];
+  }
+  _minInf = (HighsInt)minCount;
+  _maxInf = (HighsInt)maxCount;
+}
+
+/* Replaces the row's incremental sums by a fresh scan. */
+void Propagator::RescanRow(const HighsInt _row)
+{
+  ScanRow(_row, minAct_[_row], maxAct_[_row], minInf_[_row], maxInf_[_row]);
+  work_ += rowStart_[_row + 1] - rowStart_[_row];
+}
+
+bool Propagator::IsViolated(const HighsInt _row) const
+{
+  const double rowLower = rowLower_[_row];
+  const double rowUpper = rowUpper_[_row];
+  return (minInf_[_row] == 0 && minAct_[_row] > rowUpper + kFeasTol * max(1.0, fabs(rowUpper))) ||
+         (maxInf_[_row] == 0 && maxAct_[_row] < rowLower - kFeasTol * max(1.0, fabs(rowLower)));
+}
+
+/* Moves a column's bounds and its contribution to the activity of every
+   row it is in, queueing those rows. */
+void Propagator::ChangeBound(const HighsInt _col, const double _lower, const double _upper)
+{
+  const double oldLower = lower_[_col];
+  const double oldUpper = upper_[_col];
+  lower_[_col] = _lower;
+  upper_[_col] = _upper;
+  if (!colChanged_[_col])
+  {
+    colChanged_[_col] = 1;
+    changedCols_.push_back(_col);
+  }
+  for (HighsInt k = colStart_[_col]; k < colStart_[_col + 1]; ++k)
+  {
+    const HighsInt row = colRow_[k];
+    const double value = colValue_[k];
+    const double oldLow = value > 0 ? oldLower : oldUpper;
+    const double oldHigh = value > 0 ? oldUpper : oldLower;
+    const double newLow = value > 0 ? _lower : _upper;
+    const double newHigh = value > 0 ? _upper : _lower;
+    if (isinf(oldLow))
+      minInf_[row]--;
+    else
+      minAct_[row] -= value * oldLow;
+    if (isinf(newLow))
+      minInf_[row]++;
+    else
+      minAct_[row] += value * newLow;
+    if (isinf(oldHigh))
+      maxInf_[row]--;
+    else
+      maxAct_[row] -= value * oldHigh;
+    if (isinf(newHigh))
+      maxInf_[row]++;
+    else
+      maxAct_[row] += value * newHigh;
+    if (!inQueue_[row])
+    {
+      inQueue_[row] = 1;
+      queue_.push_back(row);
+    }
+  }
+  work_ += colStart_[_col + 1] - colStart_[_col];
+}
+
+/* False if the row cannot be satisfied. Otherwise tightens the integer
+   columns of the row by what the rest of the row leaves them, on the
+   row's sums as ChangeBound keeps them. A verdict of infeasibility is
+   checked again on a fresh scan of the row. */
+bool Propagator::PropagateRow(const HighsInt _row)
+{
+  const double rowLower = rowLower_[_row];
+  const double rowUpper = rowUpper_[_row];
+  // A row with two unbounded contributions on each side implies nothing.
+  if ((isinf(rowUpper) || minInf_[_row] > 1) && (isinf(rowLower) || maxInf_[_row] > 1))
+    return true;
+  work_ += rowStart_[_row + 1] - rowStart_[_row];
+  bool fresh = false;
+  if (IsViolated(_row))
+  {
+    RescanRow(_row);
+    fresh = true;
+    if (IsViolated(_row))
+      return false;
+  }
+  for (HighsInt k = rowStart_[_row]; k < rowStart_[_row + 1]; ++k)
+  {
+    const HighsInt col = rowCol_[k];
+    const double value = rowValue_[k];
+    if (!integer_[col] || fabs(value) < 1e-9)
+      continue;
+    const double minAct = minAct_[_row];
+    const double maxAct = maxAct_[_row];
+    const HighsInt minInf = minInf_[_row];
+    const HighsInt maxInf = maxInf_[_row];
+    double lower = lower_[col];
+    double upper = upper_[col];
+    const double low = value > 0 ? lower : upper;
+    const double high = value > 0 ? upper : lower;
+    // The activity of the rest of the row, if it is finite.
+    if (!isinf(rowUpper) && (minInf == 0 || (minInf == 1 && isinf(low))))
+    {
+      const double rest = minInf == 0 ? minAct - value * low : minAct;
+      const double bound = (rowUpper - rest) / value;
+      if (value > 0 && bound < upper && bound < kMaxBound)
+        upper = floor(bound + kIntTol * max(1.0, fabs(bound)));
+      else if (value < 0 && bound > lower && bound > -kMaxBound)
+        lower = ceil(bound - kIntTol * max(1.0, fabs(bound)));
+    }
+    if (!isinf(rowLower) && (maxInf == 0 || (maxInf == 1 && isinf(high))))
+    {
+      const double rest = maxInf == 0 ? maxAct - value * high : maxAct;
+      const double bound = (rowLower - rest) / value;
+      if (value > 0 && bound > lower && bound > -kMaxBound)
+        lower = ceil(bound - kIntTol * max(1.0, fabs(bound)));
+      else if (value < 0 && bound < upper && bound < kMaxBound)
+        upper = floor(bound + kIntTol * max(1.0, fabs(bound)));
+    }
+    if (lower > upper + 0.5)
+    {
+      if (fresh)
+        return false;
+      // Look at the column again on the row's exact sums.
+      RescanRow(_row);
+      fresh = true;
+      --k;
+      continue;
+    }
+    if (lower > lower_[col] + 0.5 || upper < upper_[col] - 0.5)
+    {
+      ChangeBound(col, max(lower, lower_[col]), min(upper, upper_[col]));
+      fresh = false;
+    }
+  }
+  return true;
+}
+
+/* Applies the branching bounds in _changes and propagates them until no
+   row implies more or the work is spent. False if a row cannot be
+   satisfied. Otherwise the tightened integer bounds are appended to
+   _changes; its first entry stays the branching bound. */
+bool Propagator::Propagate(vector<BoundChange> &_changes)
+{
+  const auto startTime = chrono::steady_clock::now();
+  lower_ = baseLower_;
+  upper_ = baseUpper_;
+  minAct_ = baseMinAct_;
+  maxAct_ = baseMaxAct_;
+  minInf_ = baseMinInf_;
+  maxInf_ = baseMaxInf_;
+  queue_.clear();
+  changedCols_.clear();
+  work_ = 0;
+  bool feasible = true;
+  for (const BoundChange &change : _changes)
+  {
+    if (change.col < 0 || change.col >= colNum_)
+      continue;
+    if (change.lower > change.upper + kFeasTol)
+      feasible = false;
+    ChangeBound(change.col, change.lower, change.upper);
+  }
+  const size_t givenNum = _changes.size();
+  const size_t branchNum = changedCols_.size();
+  const size_t workLimit = 4 * colStart_[colNum_] + 1000;
+  for (size_t head = 0; feasible && head < queue_.size() && work_ < workLimit; ++head)
+  {
+    const HighsInt row = queue_[head];
+    inQueue_[row] = 0;
+    feasible = PropagateRow(row);
+  }
+  for (const HighsInt row : queue_)
+    inQueue_[row] = 0;
+  for (size_t i = 0; i < changedCols_.size(); ++i)
+  {
+    const HighsInt col = changedCols_[i];
+    colChanged_[col] = 0;
+    if (feasible && i >= branchNum)
+      _changes.push_back({col, lower_[col], upper_[col]});
+  }
+  // A branching column tightened further is given again after the others.
+  for (size_t i = 0; feasible && i < givenNum; ++i)
+  {
+    const HighsInt col = _changes[i].col;
+    if (col >= 0 && col < colNum_ &&
+        (lower_[col] > _changes[i].lower || upper_[col] < _changes[i].upper))
+      _changes.push_back({col, lower_[col], upper_[col]});
+  }
+  checkNum_++;
+  if (!feasible)
+    infeasibleNum_++;
+  else
+    tightenNum_ += changedCols_.size() - branchNum;
+  timeNs_ += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - startTime).count();
+  return feasible;
+}
+
+void Propagator::PrintStatistic()
+{
+  if (checkNum_ == 0)
+    return;
+  printf("c Propagation: %ld children checked in %.3lf ms (%.1lf us avg); %ld infeasible; %ld integer bounds tightened\n",
+         (size_t)checkNum_, timeNs_ / 1e6, timeNs_ / 1e3 / checkNum_,
+         (size_t)infeasibleNum_, (size_t)tightenNum_);
+}
@@ -0,0 +1,973 @@
+/*=====================================================================================
+
+    Filename:     MPSReader.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "MPSReader.h"
+#include "Profiler/Profiler.h"
+#include <bzlib.h>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+namespace
+{
+  constexpr size_t kMaxToken = 8;
+  constexpr size_t kChunkBytes = 1 << 20;
+  constexpr size_t kInflateBytes = 1 << 20;
+  // Address space reserved per compressed byte; MPS text rarely packs
+  // better than 1:30.
+  constexpr size_t kMaxRatio = 128;
+  constexpr HighsInt kObjRow = -1;
+  constexpr HighsInt kFreeRow = -2;
+
+  enum BoundType
+  {
+    UP,
+    LO,
+    FX,
+    MI,
+    PL,
+    BV,
+    LI,
+    UI,
+    FR,
+    SI,
+    SC,
+    BoundTypeNum
+  };
+  const char *BoundTypeName[BoundTypeNum] = {"UP", "LO", "FX", "MI", "PL", "BV", "LI", "UI", "FR", "SI", "SC"};
+
+  inline bool IsBlank(const char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+  /* Splits the line at _line into at most kMaxToken tokens and moves _line to
+     the next one. Returns the number of tokens, which may exceed kMaxToken. */
+  size_t Tokenize(const char *&_line, const char *_end, string_view *_tokens)
+  {
+    const char *lineEnd = (const char *)memchr(_line, '\n', _end - _line);
+    if (lineEnd == nullptr)
+      lineEnd = _end;
+    size_t num = 0;
+    const char *pos = _line;
+    while (pos < lineEnd)
+    {
+      while (pos < lineEnd && IsBlank(*pos))
+        ++pos;
+      if (pos == lineEnd)
+        break;
+      const char *begin = pos;
+      while (pos < lineEnd && !IsBlank(*pos))
+        ++pos;
+      if (num < kMaxToken)
+        _tokens[num] = string_view(begin, pos - begin);
+      num++;
+    }
+    _line = lineEnd < _end ? lineEnd + 1 : _end;
+    return num;
+  }
+
+  inline bool IsComment(const char *_line, const char *_end)
+  {
+    return _line < _end && *_line == '*';
+  }
+
+  bool ParseValue(const string_view &_token, double &_value)
+  {
+    char buffer[64];
+    if (_token.empty() || _token.size() >= sizeof(buffer))
+      return false;
+    memcpy(buffer, _token.data(), _token.size());
+    buffer[_token.size()] = '\0';
+    char *end;
+    _value = strtod(buffer, &end);
+    return end == buffer + _token.size() && !std::isnan(_value);
+  }
+}
+
+MPSReader::MPSReader(ThreadPool *_pool)
+    : pool_(_pool),
+      data_(nullptr),
+      size_(0),
+      mapSize_(0),
+      chunkNum_(0),
+      compression_(nullptr),
+      streamStarted_(false),
+      available_(0),
+      streamDone_(false),
+      streamStop_(false),
+      columnCut_(nullptr),
+      objLocation_(-1)
+{
+}
+
+MPSReader::~MPSReader()
+{
+  FinishStream();
+  if (pool_ != nullptr)
+    pool_->Wait(group_);
+  if (data_ != nullptr)
+    munmap((void *)data_, mapSize_);
+}
+
+bool MPSReader::Fail(const string &_error)
+{
+  error_ = _error;
+  return false;
+}
+
+/* Cuts [_begin, _end) into pieces of at least _minBytes that start at line
+   beginnings, about four per pool thread. */
+vector<pair<const char *, const char *>> MPSReader::Split(
+    const char *_begin, const char *_end, const size_t _minBytes) const
+{
+  const size_t bytes = _end - _begin;
+  size_t num = pool_ == nullptr ? 1 : pool_->GetThreadNum() * 4;
+  num = max((size_t)1, min(num, bytes / _minBytes));
+  vector<pair<const char *, const char *>> pieces;
+  const char *begin = _begin;
+  for (size_t i = 1; i <= num; ++i)
+  {
+    const char *end = _end;
+    if (i < num)
+    {
+      end = max(begin, _begin + bytes / num * i);
+      const char *newline = (const char *)memchr(end, '\n', _end - end);
+      end = newline == nullptr ? _end : newline + 1;
+    }
+    if (end > begin)
+      pieces.push_back({begin, end});
+    begin = end;
+  }
+  return pieces;
+}
+
+void MPSReader::ParallelFor(const size_t _num, const function<void(size_t)> &_func)
+{
+  if (pool_ == nullptr || _num <= 1)
+  {
+    for (size_t i = 0; i < _num; ++i)
+      _func(i);
+    return;
+  }
+  for (size_t i = 0; i < _num; ++i)
+    pool_->Submit(group_, [&_func, i]
+                  { _func(i); });
+  pool_->Wait(group_);
+}
+
+bool MPSReader::Read(const string &_path, HighsModel &_model)
+{
+  path_ = _path;
+  FILE *file = fopen(_path.c_str(), "rb");
+  if (file == nullptr)
+    return Fail("cannot open " + _path);
+  unsigned char magic[3] = {0, 0, 0};
+  const size_t magicNum = fread(magic, 1, 3, file);
+  fclose(file);
+  if (magicNum >= 2 && magic[0] == 0x1f && magic[1] == 0x8b)
+    compression_ = "gzip";
+  else if (magicNum == 3 && magic[0] == 'B' && magic[1] == 'Z' && magic[2] == 'h')
+    compression_ = "bzip2";
+
+  HighsLp &lp = _model.lp_;
+  lp = HighsLp();
+  if (compression_ == nullptr)
+  {
+    if (!MapFile() || !FindSections())
+      return false;
+    for (const SectionRange &range : sections_)
+      if (!ReadSection(range, lp))
+        return false;
+  }
+  else if (!StartStream() || !StreamSections(lp))
+  {
+    FinishStream();
+    return false;
+  }
+
+  for (HighsInt iCol = 0; iCol < lp.num_col_; iCol++)
+    if (binary_[iCol])
+    {
+      lp.col_lower_[iCol] = 0;
+      lp.col_upper_[iCol] = 1;
+    }
+  for (const HighsVarType type : integrality_)
+    if (type != HighsVarType::kContinuous)
+    {
+      lp.integrality_ = integrality_;
+      break;
+    }
+  lp.col_names_.resize(lp.num_col_);
+  lp.row_names_.resize(lp.num_row_);
+  ParallelFor(2, [&](size_t _which)
+              {
+                if (_which == 0)
+                  for (HighsInt iCol = 0; iCol < lp.num_col_; iCol++)
+                    lp.col_names_[iCol] = string(colNames_[iCol]);
+                else
+                  for (HighsInt iRow = 0; iRow < lp.num_row_; iRow++)
+                    lp.row_names_[iRow] = string(rowNames_[iRow]); });
+  lp.objective_name_ = objName_.empty() ? "Obj" : string(objName_);
+  lp.cost_row_location_ = objLocation_;
+  filesystem::path name = filesystem::path(_path).filename();
+  if (compression_ != nullptr)
+    name = name.stem();
+  lp.model_name_ = name.stem().string();
+  return true;
+}
+
+bool MPSReader::MapFile()
+{
+  const int fd = open(path_.c_str(), O_RDONLY);
+  if (fd < 0)
+    return Fail("cannot open " + path_);
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size == 0)
+  {
+    close(fd);
+    return Fail("empty file");
+  }
+  size_ = mapSize_ = st.st_size;
+  void *data = mmap(nullptr, mapSize_, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED)
+    return Fail("mmap failed");
+  data_ = (const char *)data;
+  madvise(data, mapSize_, MADV_SEQUENTIAL);
+  return true;
+}
+
+void *MPSReaderInflate(void *arg)
+{
+  ((MPSReader *)arg)->Inflate();
+  return nullptr;
+}
+
+/* The text is inflated into one reserved address range, so the pointers
+   into it stay valid while it grows; pages are only backed once written. */
+bool MPSReader::StartStream()
+{
+  struct stat st;
+  if (stat(path_.c_str(), &st) != 0)
+    return Fail("cannot stat " + path_);
+  mapSize_ = max((size_t)st.st_size * kMaxRatio, (size_t)1 << 30);
+  void *data = mmap(nullptr, mapSize_, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (data == MAP_FAILED)
+  {
+    mapSize_ = 0;
+    return Fail("cannot reserve memory for the inflated text");
+  }
+  data_ = (const char *)data;
+  streamStarted_ = pthread_create(&streamThread_, nullptr, MPSReaderInflate, this) == 0;
+  if (!streamStarted_)
+    return Fail("cannot start the inflating thread");
+  return true;
+}
+
+void MPSReader::Inflate()
+{
+  Profiler::NameThread("mps inflate");
+  char *buffer = (char *)data_;
+  const bool done = strcmp(compression_, "gzip") == 0 ? InflateGzip(buffer) : InflateBzip2(buffer);
+  {
+    boost::mutex::scoped_lock lock(mutexStream_);
+    if (!done && streamError_.empty())
+      streamError_ = string("corrupt ") + compression_ + " stream";
+    streamDone_ = true;
+  }
+  condStream_.notify_all();
+}
+
+/* Makes _size more bytes visible to the parsing thread. */
+bool MPSReader::Publish(const size_t _size)
+{
+  {
+    boost::mutex::scoped_lock lock(mutexStream_);
+    available_.store(available_.load() + _size, memory_order_release);
+  }
+  condStream_.notify_all();
+  return !streamStop_.load();
+}
+
+bool MPSReader::InflateGzip(char *_buffer)
+{
+  gzFile file = gzopen(path_.c_str(), "rb");
+  if (file == nullptr)
+    return false;
+  gzbuffer(file, kInflateBytes);
+  bool done = true;
+  while (true)
+  {
+    const size_t offset = available_.load();
+    const size_t room = min(kInflateBytes, mapSize_ - offset);
+    if (room == 0)
+    {
+      streamError_ = "inflated text is larger than the reservation";
+      done = false;
+      break;
+    }
+    const int bytes = gzread(file, _buffer + offset, (unsigned)room);
+    if (bytes < 0)
+    {
+      done = false;
+      break;
+    }
+    if (bytes == 0 || !Publish(bytes))
+      break;
+  }
+  gzclose(file);
+  return done;
+}
+
+/* Concatenated streams, as written by pbzip2, are read one after another. */
+bool MPSReader::InflateBzip2(char *_buffer)
+{
+  FILE *file = fopen(path_.c_str(), "rb");
+  if (file == nullptr)
+    return false;
+  vector<char> input(kInflateBytes);
+  bz_stream stream;
+  memset(&stream, 0, sizeof(stream));
+  bool done = BZ2_bzDecompressInit(&stream, 0, 0) == BZ_OK;
+  bool streamEnd = false;
+  while (done)
+  {
+    if (stream.avail_in == 0)
+    {
+      stream.avail_in = (unsigned)fread(input.data(), 1, input.size(), file);
+      stream.next_in = input.data();
+      if (stream.avail_in == 0)
+      {
+        done = streamEnd;
+        break;
+      }
+    }
+    if (streamEnd)
+    {
+      BZ2_bzDecompressEnd(&stream);
+      const unsigned availIn = stream.avail_in;
+      char *nextIn = stream.next_in;
+      memset(&stream, 0, sizeof(stream));
+      stream.avail_in = availIn;
+      stream.next_in = nextIn;
+      done = BZ2_bzDecompressInit(&stream, 0, 0) == BZ_OK;
+      streamEnd = false;
+      continue;
+    }
+    const size_t offset = available_.load();
+    const size_t room = min(kInflateBytes, mapSize_ - offset);
+    if (room == 0)
+    {
+      streamError_ = "inflated text is larger than the reservation";
+      done = false;
+      break;
+    }
+    stream.next_out = _buffer + offset;
+    stream.avail_out = (unsigned)room;
+    const int status = BZ2_bzDecompress(&stream);
+    if (status != BZ_OK && status != BZ_STREAM_END)
+    {
+      done = false;
+      break;
+    }
+    streamEnd = status == BZ_STREAM_END;
+    if (!Publish(room - stream.avail_out))
+      break;
+  }
+  BZ2_bzDecompressEnd(&stream);
+  fclose(file);
+  return done;
+}
+
+/* Blocks until there is text beyond _pos or the stream has ended, and
+   returns how much text there is. */
+size_t MPSReader::WaitData(const size_t _pos)
+{
+  boost::mutex::scoped_lock lock(mutexStream_);
+  condStream_.wait(lock, [&]
+                   { return available_.load(memory_order_acquire) > _pos || streamDone_.load(); });
+  return available_.load(memory_order_acquire);
+}
+
+bool MPSReader::FinishStream()
+{
+  if (!streamStarted_)
+    return false;
+  streamStop_ = true;
+  pthread_join(streamThread_, nullptr);
+  streamStarted_ = false;
+  if (!streamError_.empty())
+    return Fail(streamError_);
+  return true;
+}
+
+/* Walks the text line by line as it is inflated. A section is read once
+   the next header shows where it ends, except that COLUMNS is cut into
+   chunks for the pool while it is still arriving. */
+bool MPSReader::StreamSections(HighsLp &_lp)
+{
+  size_t pos = 0;
+  bool haveSection = false;
+  SectionRange range;
+  while (true)
+  {
+    size_t available = WaitData(pos);
+    if (pos >= available)
+      break;
+    const char *line = data_ + pos;
+    const char *newline = (const char *)memchr(line, '\n', available - pos);
+    while (newline == nullptr && !streamDone_.load())
+    {
+      available = WaitData(available);
+      newline = (const char *)memchr(line, '\n', available - pos);
+    }
+    const char *next = newline == nullptr ? data_ + available : newline + 1;
+    if (!IsBlank(*line) && *line != '*' && *line != '\n')
+    {
+      if (haveSection)
+      {
+        range.end = line;
+        if (!ReadSection(range, _lp))
+          return false;
+      }
+      if (!ReadHeader(line, next, range))
+        return false;
+      haveSection = true;
+      columnCut_ = range.begin;
+    }
+    else if (haveSection && range.section == Section::Columns &&
+             (size_t)(next - columnCut_) >= kChunkBytes)
+    {
+      SubmitColumns(columnCut_, next);
+      columnCut_ = next;
+    }
+    pos = next - data_;
+  }
+  if (!FinishStream())
+    return false;
+  size_ = available_.load();
+  if (haveSection)
+  {
+    range.end = data_ + size_;
+    if (!ReadSection(range, _lp))
+      return false;
+  }
+  return true;
+}
+
+bool MPSReader::ReadHeader(const char *_header, const char *_end, SectionRange &_range)
+{
+  string_view tokens[kMaxToken];
+  const char *line = _header;
+  Tokenize(line, _end, tokens);
+  _range = {Section::Name, _header, line, _end};
+  if (tokens[0] == "NAME")
+    _range.section = Section::Name;
+  else if (tokens[0] == "OBJSENSE")
+    _range.section = Section::ObjSense;
+  else if (tokens[0] == "ROWS")
+    _range.section = Section::Rows;
+  else if (tokens[0] == "COLUMNS")
+    _range.section = Section::Columns;
+  else if (tokens[0] == "RHS")
+    _range.section = Section::Rhs;
+  else if (tokens[0] == "RANGES")
+    _range.section = Section::Ranges;
+  else if (tokens[0] == "BOUNDS")
+    _range.section = Section::Bounds;
+  else if (tokens[0] == "ENDATA")
+    _range.section = Section::EndData;
+  else
+    return Fail("unsupported section " + string(tokens[0]));
+  return true;
+}
+
+bool MPSReader::ReadSection(const SectionRange &_range, HighsLp &_lp)
+{
+  switch (_range.section)
+  {
+  case Section::Name:
+  case Section::EndData:
+    return true;
+  case Section::ObjSense:
+  {
+    string_view tokens[kMaxToken];
+    const char *line = _range.header;
+    size_t num = Tokenize(line, _range.begin, tokens);
+    line = _range.begin;
+    if (num < 2)
+    {
+      while (line < _range.end && (num = Tokenize(line, _range.end, tokens)) == 0)
+        ;
+      tokens[1] = num > 0 ? tokens[0] : string_view();
+    }
+    if (tokens[1] == "MAX" || tokens[1] == "MAXIMIZE")
+      _lp.sense_ = ObjSense::kMaximize;
+    else if (tokens[1] != "MIN" && tokens[1] != "MINIMIZE")
+      return Fail("unknown objective sense");
+    return true;
+  }
+  case Section::Rows:
+    return ReadRows(_range, _lp);
+  case Section::Columns:
+    if (!ReadColumns(_range, _lp))
+      return false;
+    binary_.assign(_lp.num_col_, false);
+    for (HighsInt iCol = 0; iCol < _lp.num_col_; iCol++)
+      binary_[iCol] = integrality_[iCol] == HighsVarType::kInteger;
+    return true;
+  default:
+  {
+    vector<RecordChunk> chunks;
+    if (!ReadRecords(_range, chunks))
+      return false;
+    hasRowEntry_.assign(_lp.num_row_, false);
+    if (_range.section == Section::Rhs)
+      return ApplyRhs(chunks, _lp, hasRowEntry_);
+    if (_range.section == Section::Ranges)
+      return ApplyRanges(chunks, _lp, hasRowEntry_);
+    return ApplyBounds(chunks, _lp, binary_);
+  }
+  }
+}
+
+/* Section headers are the lines that do not start with a blank or '*'.
+   Every piece of the file is scanned for them in parallel. */
+bool MPSReader::FindSections()
+{
+  const vector<pair<const char *, const char *>> pieces = Split(data_, data_ + size_, kChunkBytes * 4);
+  vector<vector<const char *>> headers(pieces.size());
+  ParallelFor(pieces.size(), [&](size_t _piece)
+              {
+                const char *line = pieces[_piece].first;
+                const char *end = pieces[_piece].second;
+                while (line < end)
+                {
+                  if (!IsBlank(*line) && *line != '*' && *line != '\n')
+                    headers[_piece].push_back(line);
+                  const char *newline = (const char *)memchr(line, '\n', end - line);
+                  line = newline == nullptr ? end : newline + 1;
+                } });
+  for (const vector<const char *> &pieceHeaders : headers)
+    for (const char *header : pieceHeaders)
+    {
+      SectionRange range;
+      if (!ReadHeader(header, data_ + size_, range))
+        return false;
+      range.end = data_ + size_;
+      if (!sections_.empty())
+        sections_.back().end = header;
+      sections_.push_back(range);
+    }
+  return true;
+}
+
+bool MPSReader::ReadRows(const SectionRange &_range, HighsLp &_lp)
+{
+  const vector<pair<const char *, const char *>> pieces = Split(_range.begin, _range.end, kChunkBytes);
+  vector<vector<pair<char, string_view>>> rows(pieces.size());
+  vector<char> ok(pieces.size(), true);
+  ParallelFor(pieces.size(), [&](size_t _piece)
+              {
+                string_view tokens[kMaxToken];
+                const char *line = pieces[_piece].first;
+                const char *end = pieces[_piece].second;
+                while (line < end)
+                {
+                  if (IsComment(line, end))
+                  {
+                    Tokenize(line, end, tokens);
+                    continue;
+                  }
+                  const size_t num = Tokenize(line, end, tokens);
+                  if (num == 0)
+                    continue;
+                  if (num != 2 || tokens[0].size() != 1)
+                  {
+                    ok[_piece] = false;
+                    return;
+                  }
+                  rows[_piece].push_back({tokens[0][0], tokens[1]});
+                } });
+  size_t rowNum = 0;
+  for (size_t piece = 0; piece < pieces.size(); ++piece)
+  {
+    if (!ok[piece])
+      return Fail("malformed ROWS line");
+    rowNum += rows[piece].size();
+  }
+  rowIndex_.reserve(rowNum);
+  rowNames_.reserve(rowNum);
+  for (const vector<pair<char, string_view>> &pieceRows : rows)
+    for (const pair<char, string_view> &row : pieceRows)
+    {
+      const char type = row.first;
+      HighsInt index = (HighsInt)rowNames_.size();
+      if (type == 'N')
+        index = objName_.empty() ? kObjRow : kFreeRow;
+      else if (type != 'E' && type != 'L' && type != 'G')
+        return Fail("unknown row type");
+      if (!rowIndex_.emplace(row.second, index).second)
+        return Fail("duplicate row " + string(row.second));
+      if (index == kObjRow)
+      {
+        objName_ = row.second;
+        objLocation_ = (HighsInt)rowNames_.size();
+      }
+      if (index < 0)
+        continue;
+      rowNames_.push_back(row.second);
+      rowType_.push_back(type);
+      _lp.row_lower_.push_back(type == 'L' ? -kHighsInf : 0);
+      _lp.row_upper_.push_back(type == 'G' ? kHighsInf : 0);
+    }
+  _lp.num_row_ = (HighsInt)rowNames_.size();
+  return true;
+}
+
+/* Hands the COLUMNS lines in [_begin, _end) to the pool while the rest of
+   the section is still being inflated. */
+void MPSReader::SubmitColumns(const char *_begin, const char *_end)
+{
+  columnChunks_.emplace_back();
+  ColumnChunk *chunk = &columnChunks_.back();
+  if (pool_ == nullptr)
+    ParseColumns(_begin, _end, *chunk);
+  else
+    pool_->Submit(group_, [this, _begin, _end, chunk]
+                  { ParseColumns(_begin, _end, *chunk); });
+}
+
+bool MPSReader::ReadColumns(const SectionRange &_range, HighsLp &_lp)
+{
+  if (columnChunks_.empty())
+  {
+    const vector<pair<const char *, const char *>> pieces = Split(_range.begin, _range.end, kChunkBytes);
+    columnChunks_.resize(pieces.size());
+    ParallelFor(pieces.size(), [&](size_t _piece)
+                { ParseColumns(pieces[_piece].first, pieces[_piece].second, columnChunks_[_piece]); });
+  }
+  else
+  {
+    if (columnCut_ < _range.end)
+      SubmitColumns(columnCut_, _range.end);
+    if (pool_ != nullptr)
+      pool_->Wait(group_);
+  }
+  chunkNum_ = columnChunks_.size();
+
+  /* Stitch the chunks together: a column cut by a chunk boundary becomes
+     one column with two parts, and runs before the first marker of a chunk
+     take the marker state of the chunks before it. */
+  int integer = 0;
+  for (size_t chunk = 0; chunk < columnChunks_.size(); ++chunk)
+  {
+    const ColumnChunk &columnChunk = columnChunks_[chunk];
+    if (!columnChunk.ok)
+      return Fail("malformed COLUMNS line");
+    for (size_t run = 0; run < columnChunk.runs.size(); ++run)
+    {
+      const ColumnRun &columnRun = columnChunk.runs[run];
+      if (run > 0 || colNames_.empty() || colNames_.back() != columnRun.name)
+      {
+        colNames_.push_back(columnRun.name);
+        const int runInteger = columnRun.integer < 0 ? integer : columnRun.integer;
+        integrality_.push_back(runInteger ? HighsVarType::kInteger : HighsVarType::kContinuous);
+        colPartStart_.push_back(colParts_.size());
+      }
+      colParts_.push_back({chunk, columnRun.entryBegin, columnRun.entryEnd});
+    }
+    if (columnChunk.endInteger >= 0)
+      integer = columnChunk.endInteger;
+  }
+  colPartStart_.push_back(colParts_.size());
+  _lp.num_col_ = (HighsInt)colNames_.size();
+  colIndex_.reserve(colNames_.size());
+  for (HighsInt iCol = 0; iCol < _lp.num_col_; iCol++)
+    if (!colIndex_.emplace(colNames_[iCol], iCol).second)
+      return Fail("column " + string(colNames_[iCol]) + " is not contiguous");
+  _lp.col_lower_.assign(_lp.num_col_, 0);
+  _lp.col_upper_.assign(_lp.num_col_, kHighsInf);
+  BuildMatrix(_lp);
+  return true;
+}
+
+void MPSReader::ParseColumns(const char *_begin, const char *_end, ColumnChunk &_chunk) const
+{
+  _chunk.ok = true;
+  _chunk.endInteger = -1;
+  string_view tokens[kMaxToken];
+  const char *line = _begin;
+  while (line < _end)
+  {
+    if (IsComment(line, _end))
+    {
+      Tokenize(line, _end, tokens);
+      continue;
+    }
+    const size_t num = Tokenize(line, _end, tokens);
+    if (num == 0)
+      continue;
+    if (num >= 3 && tokens[1] == "'MARKER'")
+    {
+      if (tokens[2] == "'INTORG'")
+        _chunk.endInteger = 1;
+      else if (tokens[2] == "'INTEND'")
+        _chunk.endInteger = 0;
+      else
+        _chunk.ok = false;
+      continue;
+    }
+    if (num != 3 && num != 5)
+    {
+      _chunk.ok = false;
+      return;
+    }
+    if (_chunk.runs.empty() || _chunk.runs.back().name != tokens[0])
+      _chunk.runs.push_back({tokens[0], _chunk.endInteger, _chunk.entries.size(), _chunk.entries.size()});
+    for (size_t token = 1; token < num; token += 2)
+    {
+      auto row = rowIndex_.find(tokens[token]);
+      double value;
+      if (row == rowIndex_.end() || !ParseValue(tokens[token + 1], value))
+      {
+        _chunk.ok = false;
+        return;
+      }
+      if (value != 0)
+        _chunk.entries.push_back({row->second, value});
+    }
+    _chunk.runs.back().entryEnd = _chunk.entries.size();
+  }
+}
+
+/* Counts, then fills, the entries of each column in parallel over column
+   ranges. As in HiGHS, the first nonzero of a column in a row wins. */
+void MPSReader::BuildMatrix(HighsLp &_lp)
+{
+  const HighsInt colNum = _lp.num_col_;
+  HighsSparseMatrix &matrix = _lp.a_matrix_;
+  matrix.format_ = MatrixFormat::kColwise;
+  matrix.num_col_ = colNum;
+  matrix.num_row_ = _lp.num_row_;
+  matrix.start_.assign(colNum + 1, 0);
+  _lp.col_cost_.assign(colNum, 0);
+  const size_t rangeNum = max((size_t)1, min(chunkNum_ * 4, (size_t)colNum / 1024));
+  auto forColumns = [&](const bool _fill)
+  {
+    ParallelFor(rangeNum, [&](size_t _range)
+                {
+                  vector<HighsInt> stamp(_lp.num_row_, -1);
+                  const HighsInt colBegin = (HighsInt)(colNum * _range / rangeNum);
+                  const HighsInt colEnd = (HighsInt)(colNum * (_range + 1) / rangeNum);
+                  for (HighsInt iCol = colBegin; iCol < colEnd; iCol++)
+                  {
+                    HighsInt pos = _fill ? matrix.start_[iCol] : 0;
+                    bool haveCost = false;
+                    for (size_t part = colPartStart_[iCol]; part < colPartStart_[iCol + 1]; ++part)
+                    {
+                      const ColumnPart &columnPart = colParts_[part];
+                      const vector<Entry> &entries = columnChunks_[columnPart.chunk].entries;
+                      for (size_t entry = columnPart.entryBegin; entry < columnPart.entryEnd; ++entry)
+                      {
+                        const HighsInt row = entries[entry].row;
+                        if (row == kObjRow && !haveCost)
+                        {
+                          _lp.col_cost_[iCol] = entries[entry].value;
+                          haveCost = true;
+                        }
+                        if (row < 0 || stamp[row] == iCol)
+                          continue;
+                        stamp[row] = iCol;
+                        if (_fill)
+                        {
+                          matrix.index_[pos] = row;
+                          matrix.value_[pos] = entries[entry].value;
+                        }
+                        pos++;
+                      }
+                    }
+                    if (!_fill)
+                      matrix.start_[iCol + 1] = pos;
+                  } });
+  };
+  forColumns(false);
+  for (HighsInt iCol = 0; iCol < colNum; iCol++)
+    matrix.start_[iCol + 1] += matrix.start_[iCol];
+  matrix.index_.resize(matrix.start_[colNum]);
+  matrix.value_.resize(matrix.start_[colNum]);
+  forColumns(true);
+}
+
+bool MPSReader::ReadRecords(const SectionRange &_range, vector<RecordChunk> &_chunks)
+{
+  const vector<pair<const char *, const char *>> pieces = Split(_range.begin, _range.end, kChunkBytes);
+  _chunks.resize(pieces.size());
+  ParallelFor(pieces.size(), [&](size_t _piece)
+              { ParseRecords(_range.section, pieces[_piece].first, pieces[_piece].second, _chunks[_piece]); });
+  for (const RecordChunk &chunk : _chunks)
+    if (!chunk.ok)
+      return Fail("malformed RHS, RANGES or BOUNDS line");
+  return true;
+}
+
+void MPSReader::ParseRecords(Section _section, const char *_begin, const char *_end, RecordChunk &_chunk) const
+{
+  _chunk.ok = false;
+  string_view tokens[kMaxToken];
+  const char *line = _begin;
+  while (line < _end)
+  {
+    if (IsComment(line, _end))
+    {
+      Tokenize(line, _end, tokens);
+      continue;
+    }
+    const size_t num = Tokenize(line, _end, tokens);
+    if (num == 0)
+      continue;
+    if (_section != Section::Bounds)
+    {
+      // An odd number of tokens starts with the name of the vector.
+      if (num < 2 || num > 5)
+        return;
+      for (size_t token = num % 2; token < num; token += 2)
+      {
+        auto row = rowIndex_.find(tokens[token]);
+        double value;
+        if (row == rowIndex_.end() || !ParseValue(tokens[token + 1], value))
+          return;
+        _chunk.records.push_back({row->second, 0, value});
+      }
+      continue;
+    }
+    if (num < 2 || num > 4)
+      return;
+    int type = 0;
+    while (type < BoundTypeNum && tokens[0] != BoundTypeName[type])
+      ++type;
+    if (type == BoundTypeNum)
+      return;
+    // As in HiGHS, the bound vector name may be left out.
+    size_t colToken = colIndex_.count(tokens[1]) ? 1 : 2;
+    if (colToken >= num)
+      return;
+    auto col = colIndex_.find(tokens[colToken]);
+    if (col == colIndex_.end())
+      return;
+    double value = 0;
+    const bool needValue = type != MI && type != PL && type != BV && type != FR;
+    if (needValue && (colToken + 1 >= num || !ParseValue(tokens[colToken + 1], value)))
+      return;
+    _chunk.records.push_back({col->second, type, value});
+  }
+  _chunk.ok = true;
+}
+
+bool MPSReader::ApplyRhs(const vector<RecordChunk> &_chunks, HighsLp &_lp, vector<bool> &_hasEntry)
+{
+  bool hasObjEntry = false;
+  for (const RecordChunk &chunk : _chunks)
+    for (const Record &record : chunk.records)
+    {
+      if (record.index == kObjRow)
+      {
+        if (!hasObjEntry)
+          _lp.offset_ = -record.value;
+        hasObjEntry = true;
+        continue;
+      }
+      if (record.index < 0 || _hasEntry[record.index])
+        continue;
+      _hasEntry[record.index] = true;
+      const char type = rowType_[record.index];
+      if (type != 'G')
+        _lp.row_upper_[record.index] = record.value;
+      if (type != 'L')
+        _lp.row_lower_[record.index] = record.value;
+    }
+  return true;
+}
+
+bool MPSReader::ApplyRanges(const vector<RecordChunk> &_chunks, HighsLp &_lp, vector<bool> &_hasEntry)
+{
+  for (const RecordChunk &chunk : _chunks)
+    for (const Record &record : chunk.records)
+    {
+      if (record.index < 0 || _hasEntry[record.index])
+        continue;
+      _hasEntry[record.index] = true;
+      const char type = rowType_[record.index];
+      const double value = record.value;
+      if ((type == 'E' && value < 0) || type == 'L')
+        _lp.row_lower_[record.index] = _lp.row_upper_[record.index] - fabs(value);
+      else if ((type == 'E' && value > 0) || type == 'G')
+        _lp.row_upper_[record.index] = _lp.row_lower_[record.index] + fabs(value);
+    }
+  return true;
+}
+
+/* Mirrors HMpsFF::parseBounds: a second definition of the same bound is
+   ignored, and integer columns from markers stay binary until any bound
+   other than BV is given. */
+bool MPSReader::ApplyBounds(const vector<RecordChunk> &_chunks, HighsLp &_lp, vector<bool> &_binary)
+{
+  vector<bool> hasLower(_lp.num_col_, false), hasUpper(_lp.num_col_, false);
+  for (const RecordChunk &chunk : _chunks)
+    for (const Record &record : chunk.records)
+    {
+      const HighsInt col = record.index;
+      const int type = record.type;
+      const bool isLower = type == LO || type == FX || type == MI || type == BV || type == LI || type == FR;
+      const bool isUpper = type != LO && type != MI && type != LI;
+      if ((isLower && hasLower[col]) || (isUpper && hasUpper[col]))
+        continue;
+      if (type == BV)
+      {
+        integrality_[col] = HighsVarType::kInteger;
+        _binary[col] = true;
+        _lp.col_upper_[col] = 1;
+      }
+      else if (type == MI || type == PL || type == FR)
+      {
+        _binary[col] = false;
+        if (isLower)
+          _lp.col_lower_[col] = -kHighsInf;
+        if (isUpper)
+          _lp.col_upper_[col] = kHighsInf;
+      }
+      else
+      {
+        if (type == SI)
+          integrality_[col] = HighsVarType::kSemiInteger;
+        else if (type == LI || type == UI)
+          integrality_[col] = HighsVarType::kInteger;
+        else if (type == SC)
+          integrality_[col] = HighsVarType::kSemiContinuous;
+        if (isLower)
+          _lp.col_lower_[col] = record.value;
+        if (isUpper)
+          _lp.col_upper_[col] = record.value;
+        _binary[col] = false;
+      }
+      if (isLower)
+        hasLower[col] = true;
+      if (isUpper)
+        hasUpper[col] = true;
+    }
+  return true;
+}
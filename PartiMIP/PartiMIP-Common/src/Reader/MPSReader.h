@@ -0,0 +1,170 @@
+/*=====================================================================================
+
+    Filename:     MPSReader.h
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#pragma once
+#include "utils/header.h"
+#include "utils/paras.h"
+#include "ThreadPool/ThreadPool.h"
+#include <string_view>
+
+/* Free-format MPS reader over a memory-mapped file. The section bodies are
+   cut into line-aligned chunks that the thread pool parses in parallel, and
+   the column-wise matrix is counted and filled in parallel over column
+   ranges. It builds the same HighsLp as Highs::readModel does for the files
+   it accepts. Read() returns false for anything else (fixed format files,
+   quadratic, cone or SOS sections, duplicate names), so the caller can fall
+   back to readModel.
+
+   gzip and bzip2 files are inflated by a second thread into an anonymous
+   mapping, without a temporary file. The section headers are found as the
+   text arrives, and COLUMNS chunks are handed to the pool as soon as they
+   are complete, so parsing overlaps decompression. */
+class MPSReader
+{
+public:
+  MPSReader(ThreadPool *_pool);
+  ~MPSReader();
+  bool Read(const string &_path, HighsModel &_model);
+  inline size_t GetChunkNum() const { return chunkNum_; }
+  inline const char *GetCompression() const { return compression_; }
+  inline size_t GetBytes() const { return size_; }
+  inline const string &GetError() const { return error_; }
+
+private:
+  enum class Section
+  {
+    Name,
+    ObjSense,
+    Rows,
+    Columns,
+    Rhs,
+    Ranges,
+    Bounds,
+    EndData
+  };
+  struct SectionRange
+  {
+    Section section;
+    const char *header;
+    const char *begin;
+    const char *end;
+  };
+  /* One entry of the COLUMNS section; row -1 is the objective, -2 a free
+     row that is dropped. */
+  struct Entry
+  {
+    HighsInt row;
+    double value;
+  };
+  /* Consecutive lines of one column inside a chunk. integer is -1 when the
+     chunk has not seen a marker yet, so the state comes from the chunks
+     before it. */
+  struct ColumnRun
+  {
+    string_view name;
+    int integer;
+    size_t entryBegin;
+    size_t entryEnd;
+  };
+  struct ColumnChunk
+  {
+    vector<ColumnRun> runs;
+    vector<Entry> entries;
+    int endInteger;
+    bool ok;
+  };
+  /* One resolved line of RHS, RANGES or BOUNDS. */
+  struct Record
+  {
+    HighsInt index;
+    int type;
+    double value;
+  };
+  struct RecordChunk
+  {
+    vector<Record> records;
+    bool ok;
+  };
+  struct ColumnPart
+  {
+    size_t chunk;
+    size_t entryBegin;
+    size_t entryEnd;
+  };
+
+  ThreadPool *pool_;
+  TaskGroup group_;
+  const char *data_;
+  size_t size_;
+  size_t mapSize_;
+  size_t chunkNum_;
+  string error_;
+
+  /* Decompression into data_: the inflating thread publishes how many bytes
+     are ready in available_. */
+  const char *compression_;
+  string path_;
+  pthread_t streamThread_;
+  bool streamStarted_;
+  atomic<size_t> available_;
+  atomic<bool> streamDone_;
+  atomic<bool> streamStop_;
+  string streamError_;
+  boost::mutex mutexStream_;
+  boost::condition_variable condStream_;
+  const char *columnCut_;
+
+  vector<SectionRange> sections_;
+  unordered_map<string_view, HighsInt> rowIndex_;
+  unordered_map<string_view, HighsInt> colIndex_;
+  vector<string_view> rowNames_;
+  vector<char> rowType_;
+  string_view objName_;
+  HighsInt objLocation_;
+  vector<string_view> colNames_;
+  vector<HighsVarType> integrality_;
+  vector<size_t> colPartStart_;
+  vector<ColumnPart> colParts_;
+  deque<ColumnChunk> columnChunks_;
+  vector<bool> hasRowEntry_;
+  vector<bool> binary_;
+
+  bool Fail(const string &_error);
+  bool MapFile();
+  bool StartStream();
+  void Inflate();
+  bool InflateGzip(char *_buffer);
+  bool InflateBzip2(char *_buffer);
+  bool Publish(const size_t _size);
+  size_t WaitData(const size_t _pos);
+  bool FinishStream();
+  bool StreamSections(HighsLp &_lp);
+  bool ReadHeader(const char *_header, const char *_end, SectionRange &_range);
+  bool ReadSection(const SectionRange &_range, HighsLp &_lp);
+  void SubmitColumns(const char *_begin, const char *_end);
+  vector<pair<const char *, const char *>> Split(const char *_begin, const char *_end, const size_t _minBytes) const;
+  void ParallelFor(const size_t _num, const function<void(size_t)> &_func);
+  bool FindSections();
+  bool ReadRows(const SectionRange &_range, HighsLp &_lp);
+  bool ReadColumns(const SectionRange &_range, HighsLp &_lp);
+  void ParseColumns(const char *_begin, const char *_end, ColumnChunk &_chunk) const;
+  void BuildMatrix(HighsLp &_lp);
+  bool ReadRecords(const SectionRange &_range, vector<RecordChunk> &_chunks);
+  void ParseRecords(Section _section, const char *_begin, const char *_end, RecordChunk &_chunk) const;
+  bool ApplyRhs(const vector<RecordChunk> &_chunks, HighsLp &_lp, vector<bool> &_hasEntry);
+  bool ApplyRanges(const vector<RecordChunk> &_chunks, HighsLp &_lp, vector<bool> &_hasEntry);
+  bool ApplyBounds(const vector<RecordChunk> &_chunks, HighsLp &_lp, vector<bool> &_binary);
+  friend void *MPSReaderInflate(void *arg);
+};
@@ -0,0 +1,284 @@
+/*=====================================================================================
+
+    Filename:     Channel.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "Channel.h"
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace
+{
+  const char *kUnixPrefix = "unix:";
+
+  struct MessageHeader
+  {
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t size;
+  };
+
+  bool IsUnix(const string &_address)
+  {
+    return _address.compare(0, strlen(kUnixPrefix), kUnixPrefix) == 0;
+  }
+
+  bool UnixAddress(const string &_address, sockaddr_un &_addr)
+  {
+    const string path = _address.substr(strlen(kUnixPrefix));
+    if (path.empty() || path.size() >= sizeof(_addr.sun_path))
+      return false;
+    memset(&_addr, 0, sizeof(_addr));
+    _addr.sun_family = AF_UNIX;
+    memcpy(_addr.sun_path, path.c_str(), path.size());
+    return true;
+  }
+
+  /* Resolves "<host>:<port>"; an empty host listens on every interface. */
+  addrinfo *TcpAddress(const string &_address, const bool _passive)
+  {
+    const size_t colon = _address.rfind(':');
+    if (colon == string::npos)
+      return nullptr;
+    const string host = _address.substr(0, colon);
+    const string port = _address.substr(colon + 1);
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = _passive ? AI_PASSIVE : 0;
+    addrinfo *result = nullptr;
+    if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &result) != 0)
+      return nullptr;
+    return result;
+  }
+}
+
+namespace
+{
+  template <typename T>
+  uint64_t HashVector(const vector<T> &_values)
+  {
+    return HashBytes((const char *)_values.data(), sizeof(T) * _values.size());
+  }
+}
+
+uint64_t HashModel(const HighsLp &_lp)
+{
+  HighsSparseMatrix matrix = _lp.a_matrix_;
+  matrix.ensureColwise();
+  const uint64_t parts[] = {
+      (uint64_t)_lp.num_col_, (uint64_t)_lp.num_row_, (uint64_t)_lp.sense_,
+      HashBytes((const char *)&_lp.offset_, sizeof(_lp.offset_)),
+      HashVector(_lp.col_cost_), HashVector(_lp.col_lower_), HashVector(_lp.col_upper_),
+      HashVector(_lp.row_lower_), HashVector(_lp.row_upper_), HashVector(_lp.integrality_),
+      HashVector(matrix.start_), HashVector(matrix.index_), HashVector(matrix.value_)};
+  return HashBytes((const char *)parts, sizeof(parts));
+}
+
+/* The listening socket is non-blocking, so that the threads waiting on it
+   for a worker process do not block in accept when another one wins. */
+int Channel::Listen(const string &_address)
+{
+  int fd = -1;
+  if (IsUnix(_address))
+  {
+    sockaddr_un addr;
+    if (!UnixAddress(_address, addr))
+      return -1;
+    unlink(addr.sun_path);
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0 && bind(fd, (sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+      close(fd);
+      fd = -1;
+    }
+  }
+  else
+  {
+    addrinfo *result = TcpAddress(_address, true);
+    for (addrinfo *info = result; info != nullptr && fd < 0; info = info->ai_next)
+    {
+      fd = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+      if (fd < 0)
+        continue;
+      const int reuse = 1;
+      setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+      if (bind(fd, info->ai_addr, info->ai_addrlen) != 0)
+      {
+        close(fd);
+        fd = -1;
+      }
+    }
+    if (result != nullptr)
+      freeaddrinfo(result);
+  }
+  if (fd < 0)
+    return -1;
+  if (listen(fd, 128) != 0 || fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) != 0)
+  {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+void Channel::StopListening(const int _listenFd, const string &_address)
+{
+  if (_listenFd < 0)
+    return;
+  close(_listenFd);
+  sockaddr_un addr;
+  if (IsUnix(_address) && UnixAddress(_address, addr))
+    unlink(addr.sun_path);
+}
+
+bool Channel::Accept(const int _listenFd, const double _timeout)
+{
+  pollfd request = {_listenFd, POLLIN, 0};
+  if (poll(&request, 1, (int)(_timeout * 1000)) <= 0)
+    return false;
+  const int fd = accept(_listenFd, nullptr, nullptr);
+  if (fd < 0)
+    return false;
+  Close();
+  fd_ = fd;
+  maxMessageSize_ = kMaxMessageSize;
+  const int noDelay = 1;
+  setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+  return true;
+}
+
+bool Channel::Connect(const string &_address)
+{
+  Close();
+  maxMessageSize_ = kMaxMessageSize;
+  if (IsUnix(_address))
+  {
+    sockaddr_un addr;
+    if (!UnixAddress(_address, addr))
+      return false;
+    fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd_ >= 0 && connect(fd_, (sockaddr *)&addr, sizeof(addr)) != 0)
+      Close();
+    return IsOpen();
+  }
+  addrinfo *result = TcpAddress(_address, false);
+  for (addrinfo *info = result; info != nullptr && fd_ < 0; info = info->ai_next)
+  {
+    fd_ = socket(info->ai_family, info->ai_socktype, info->ai_protocol);
+    if (fd_ >= 0 && connect(fd_, info->ai_addr, info->ai_addrlen) != 0)
+      Close();
+  }
+  if (result != nullptr)
+    freeaddrinfo(result);
+  if (!IsOpen())
+    return false;
+  const int noDelay = 1;
+  setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+  return true;
+}
+
+bool Channel::WriteAll(const char *_data, size_t _size)
+{
+  while (_size > 0)
+  {
+    const ssize_t written = send(fd_, _data, _size, MSG_NOSIGNAL);
+    if (written < 0 && errno == EINTR)
+      continue;
+    if (written <= 0)
+      return false;
+    _data += written;
+    _size -= written;
+    bytesSent_ += written;
+  }
+  return true;
+}
+
+bool Channel::ReadAll(char *_data, size_t _size)
+{
+  while (_size > 0)
+  {
+    const ssize_t got = recv(fd_, _data, _size, 0);
+    if (got < 0 && errno == EINTR)
+      continue;
+    if (got <= 0)
+      return false;
+    _data += got;
+    _size -= got;
+    bytesReceived_ += got;
+  }
+  return true;
+}
+
+/* A failed send or receive closes the channel; the peer is gone. */
+bool Channel::Send(const Message &_message)
+{
+  if (!IsOpen())
+    return false;
+  const MessageHeader header = {(uint32_t)_message.type, 0, _message.data.size()};
+  if (WriteAll((const char *)&header, sizeof(header)) &&
+      WriteAll(_message.data.data(), _message.data.size()))
+    return true;
+  Close();
+  return false;
+}
+
+/* The size comes from the peer, so it is checked before anything is
+   allocated for it. */
+bool Channel::Receive(Message &_message)
+{
+  if (!IsOpen())
+    return false;
+  MessageHeader header;
+  if (ReadAll((char *)&header, sizeof(header)) && header.type <= (uint32_t)MessageType::Result &&
+      header.size <= maxMessageSize_)
+  {
+    _message.type = (MessageType)header.type;
+    _message.data.resize(header.size);
+    _message.offset = 0;
+    if (ReadAll(_message.data.data(), header.size))
+      return true;
+  }
+  Close();
+  return false;
+}
+
+/* 1 once a message (or the peer's hang-up) is waiting, 0 on timeout and
+   -1 if the channel is closed. */
+int Channel::Poll(const double _timeout)
+{
+  if (!IsOpen())
+    return -1;
+  pollfd request = {fd_, POLLIN, 0};
+  const int ready = poll(&request, 1, (int)(_timeout * 1000));
+  if (ready < 0 && errno != EINTR)
+  {
+    Close();
+    return -1;
+  }
+  return ready > 0 ? 1 : 0;
+}
+
+void Channel::Close()
+{
+  if (fd_ >= 0)
+    close(fd_);
+  fd_ = -1;
+}
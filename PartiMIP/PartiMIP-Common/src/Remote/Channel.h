@@ -0,0 +1,120 @@
+/*=====================================================================================
+
+    Filename:     Channel.h
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#pragma once
+#include "utils/header.h"
+#include "utils/paras.h"
+#include <cstring>
+#include <type_traits>
+
+/* Messages between the coordinator and a worker process. A node goes out
+   as the bound changes on the path from the root, which the worker process
+   replays on its own copy of the model; solutions come back in the node's
+   reduced model. */
+enum class MessageType : uint32_t
+{
+  Hello,    // worker process -> coordinator: its model and the token
+  Node,     // coordinator -> worker process: subproblem to solve
+  Bound,    // coordinator -> worker process: better incumbent value
+  Stop,     // coordinator -> worker process: abandon the subproblem
+  Quit,     // coordinator -> worker process: the run is over
+  Solution, // worker process -> coordinator: improving solution
+  Result    // worker process -> coordinator: end of the subproblem
+};
+
+/* Payload of one message. Values are copied as they lie in memory, so
+   both ends must be the same build on the same architecture, which the
+   Hello message does not check. */
+struct Message
+{
+  MessageType type;
+  vector<char> data;
+  size_t offset = 0;
+
+  Message(const MessageType _type = MessageType::Hello) : type(_type) {}
+  template <typename T>
+  void Put(const T &_value)
+  {
+    static_assert(is_trivially_copyable<T>::value, "plain values only");
+    const char *bytes = (const char *)&_value;
+    data.insert(data.end(), bytes, bytes + sizeof(T));
+  }
+  template <typename T>
+  void PutVector(const vector<T> &_values)
+  {
+    static_assert(is_trivially_copyable<T>::value, "plain values only");
+    Put((uint64_t)_values.size());
+    const char *bytes = (const char *)_values.data();
+    data.insert(data.end(), bytes, bytes + sizeof(T) * _values.size());
+  }
+  template <typename T>
+  bool Get(T &_value)
+  {
+    if (offset + sizeof(T) > data.size())
+      return false;
+    memcpy(&_value, data.data() + offset, sizeof(T));
+    offset += sizeof(T);
+    return true;
+  }
+  template <typename T>
+  bool GetVector(vector<T> &_values)
+  {
+    uint64_t size;
+    if (!Get(size) || size > (data.size() - offset) / sizeof(T))
+      return false;
+    _values.resize(size);
+    memcpy(_values.data(), data.data() + offset, sizeof(T) * size);
+    offset += sizeof(T) * size;
+    return true;
+  }
+};
+
+/* Hash of the model's values, column-wise, which a worker process sends
+   in its Hello so that only one reading the coordinator's model is
+   served. */
+uint64_t HashModel(const HighsLp &_lp);
+
+/* One connected stream socket. Addresses are "unix:<path>" for a
+   Unix-domain socket and "<host>:<port>" for TCP. */
+class Channel
+{
+public:
+  /* Largest payload Receive accepts until SetMaxMessageSize lowers it. */
+  static const size_t kMaxMessageSize = (size_t)256 << 20;
+
+  Channel() : fd_(-1), maxMessageSize_(kMaxMessageSize), bytesSent_(0), bytesReceived_(0) {}
+  ~Channel() { Close(); }
+  static int Listen(const string &_address);
+  static void StopListening(const int _listenFd, const string &_address);
+  bool Accept(const int _listenFd, const double _timeout);
+  bool Connect(const string &_address);
+  bool Send(const Message &_message);
+  bool Receive(Message &_message);
+  int Poll(const double _timeout);
+  void Close();
+  inline void SetMaxMessageSize(const size_t _size) { maxMessageSize_ = _size; }
+  inline bool IsOpen() const { return fd_ >= 0; }
+  inline size_t GetBytesSent() const { return bytesSent_; }
+  inline size_t GetBytesReceived() const { return bytesReceived_; }
+
+private:
+  int fd_;
+  size_t maxMessageSize_;
+  size_t bytesSent_;
+  size_t bytesReceived_;
+
+  bool WriteAll(const char *_data, size_t _size);
+  bool ReadAll(char *_data, size_t _size);
+};
@@ -0,0 +1,81 @@
+/*=====================================================================================
+
+    Filename:     SolutionPool.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "SolutionPool.h"
+
+SolutionPool::SolutionPool(const size_t _capacity)
+    : capacity_(_capacity),
+      version_(0),
+      addNum_(0),
+      injectNum_(0)
+{
+}
+
+bool SolutionPool::IsUseful(const double _obj) const
+{
+  boost::mutex::scoped_lock lock(mutexPool_);
+  if (capacity_ == 0)
+    return false;
+  return solutions_.size() < capacity_ || _obj < solutions_.back().obj - 1e-9;
+}
+
+bool SolutionPool::Add(const vector<double> &_colValue, const double _obj)
+{
+  boost::mutex::scoped_lock lock(mutexPool_);
+  if (capacity_ == 0)
+    return false;
+  auto pos = solutions_.begin();
+  while (pos != solutions_.end() && pos->obj <= _obj)
+  {
+    if (pos->obj > _obj - 1e-9)
+      return false;
+    ++pos;
+  }
+  if (pos == solutions_.end() && solutions_.size() >= capacity_)
+    return false;
+  const bool newBest = pos == solutions_.begin();
+  solutions_.insert(pos, {_obj, _colValue});
+  if (solutions_.size() > capacity_)
+    solutions_.pop_back();
+  addNum_++;
+  if (newBest)
+  {
+    version_++;
+    DEBUG_PRINT("c %10.2lf    [%-10s]    [%lf] (#%ld)\n",
+                ElapsedTime(), "Pool Best", _obj, solutions_.size());
+  }
+  return newBest;
+}
+
+bool SolutionPool::GetBest(vector<double> &_colValue, double &_obj, size_t &_version) const
+{
+  boost::mutex::scoped_lock lock(mutexPool_);
+  if (solutions_.empty())
+    return false;
+  _colValue = solutions_.front().colValue;
+  _obj = solutions_.front().obj;
+  _version = version_.load();
+  return true;
+}
+
+void SolutionPool::PrintStatistic(const ObjSense _sense) const
+{
+  boost::mutex::scoped_lock lock(mutexPool_);
+  if (solutions_.empty())
+    printf("c Solution Pool: empty; %ld injected\n", injectNum_.load());
+  else
+    printf("c Solution Pool: %ld solutions; %ld added; %ld injected; best %lf\n",
+           solutions_.size(), addNum_, injectNum_.load(), (HighsInt)_sense * solutions_.front().obj);
+}
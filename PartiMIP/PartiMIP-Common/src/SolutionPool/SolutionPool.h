@@ -0,0 +1,49 @@
+/*=====================================================================================
+
+    Filename:     SolutionPool.h
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#pragma once
+#include "utils/header.h"
+#include "utils/paras.h"
+
+struct PoolSolution
+{
+  double obj;
+  vector<double> colValue;
+};
+
+/* Best solutions of the original model found by any worker, best first,
+   ranked by their objective times the model's sense, as minimised.
+   The version changes whenever a new best solution arrives, so workers
+   only copy the best one when they have not seen it yet. */
+class SolutionPool
+{
+public:
+  SolutionPool(const size_t _capacity);
+  bool Add(const vector<double> &_colValue, const double _obj);
+  bool IsUseful(const double _obj) const;
+  bool GetBest(vector<double> &_colValue, double &_obj, size_t &_version) const;
+  inline size_t GetVersion() const { return version_.load(); }
+  inline size_t GetCapacity() const { return capacity_; }
+  inline void RecordInjection() { injectNum_++; }
+  void PrintStatistic(const ObjSense _sense) const;
+
+private:
+  mutable boost::mutex mutexPool_;
+  vector<PoolSolution> solutions_;
+  size_t capacity_;
+  atomic<size_t> version_;
+  size_t addNum_;
+  atomic<size_t> injectNum_;
+};
@@ -0,0 +1,173 @@
+/*=====================================================================================
+
+    Filename:     SolutionWriter.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "SolutionWriter.h"
+#include "Profiler/Profiler.h"
+#include <zlib.h>
+
+void *SolutionWriterRun(void *arg)
+{
+  ((SolutionWriter *)arg)->Run();
+  return nullptr;
+}
+
+SolutionWriter::SolutionWriter(const string &_path, const double _interval, const HighsLp &_lp)
+    : path_(_path),
+      interval_(_interval),
+      sense_((HighsInt)_lp.sense_),
+      pendingObj_(INF),
+      havePending_(false),
+      terminated_(false),
+      writtenObj_(INF),
+      lastWriteTime_(-INF),
+      writeNum_(0),
+      skipNum_(0),
+      threadStarted_(false)
+{
+  colNames_.resize(_lp.num_col_);
+  for (HighsInt iCol = 0; iCol < _lp.num_col_; iCol++)
+    colNames_[iCol] = (HighsInt)_lp.col_names_.size() == _lp.num_col_
+                          ? _lp.col_names_[iCol]
+                          : "C" + to_string(iCol);
+  threadStarted_ = pthread_create(&thread_, nullptr, SolutionWriterRun, this) == 0;
+}
+
+SolutionWriter::~SolutionWriter()
+{
+  Finish();
+}
+
+bool SolutionWriter::IsUseful(const double _obj)
+{
+  boost::mutex::scoped_lock lock(mutexPending_);
+  return _obj < min(pendingObj_, writtenObj_) - 1e-9;
+}
+
+void SolutionWriter::Submit(const vector<double> &_colValue, const double _obj)
+{
+  if (_colValue.size() != colNames_.size())
+    return;
+  {
+    boost::mutex::scoped_lock lock(mutexPending_);
+    if (_obj >= min(pendingObj_, writtenObj_) - 1e-9)
+      return;
+    if (havePending_)
+      skipNum_++;
+    pendingValue_ = _colValue;
+    pendingObj_ = _obj;
+    havePending_ = true;
+  }
+  condPending_.notify_one();
+}
+
+/* Writes whatever is still pending and stops the writer thread. */
+void SolutionWriter::Finish()
+{
+  {
+    boost::mutex::scoped_lock lock(mutexPending_);
+    terminated_ = true;
+  }
+  condPending_.notify_one();
+  if (threadStarted_)
+    pthread_join(thread_, nullptr);
+  threadStarted_ = false;
+  if (havePending_ && Write(pendingValue_, pendingObj_))
+    havePending_ = false;
+}
+
+void SolutionWriter::Run()
+{
+  Profiler::NameThread("solution writer");
+  vector<double> colValue;
+  double obj;
+  while (true)
+  {
+    {
+      boost::mutex::scoped_lock lock(mutexPending_);
+      condPending_.wait(lock, [&]
+                        { return terminated_ || havePending_; });
+      if (!havePending_)
+        return;
+      const double wait = lastWriteTime_ + interval_ - ElapsedTime();
+      if (wait > 0 && !terminated_)
+      {
+        // A better solution may still arrive and replace this one.
+        condPending_.timed_wait(
+            lock, boost::posix_time::microseconds((int64_t)(wait * 1e6)),
+            [&]
+            { return terminated_; });
+        continue;
+      }
+      colValue.swap(pendingValue_);
+      obj = pendingObj_;
+      havePending_ = false;
+    }
+    Write(colValue, obj);
+    lastWriteTime_ = ElapsedTime();
+  }
+}
+
+bool SolutionWriter::Write(const vector<double> &_colValue, const double _obj)
+{
+  string content;
+  char line[1024];
+  snprintf(line, sizeof(line), "%-40s %.8f\n", "=obj=", sense_ * _obj);
+  content += line;
+  for (size_t iCol = 0; iCol < _colValue.size(); iCol++)
+    if (_colValue[iCol] != 0)
+    {
+      snprintf(line, sizeof(line), "%-40s %.16e\n", colNames_[iCol].c_str(), _colValue[iCol]);
+      content += line;
+    }
+
+  const string tempPath = path_ + ".tmp";
+  bool done = false;
+  if (path_.size() > 3 && path_.compare(path_.size() - 3, 3, ".gz") == 0)
+  {
+    gzFile file = gzopen(tempPath.c_str(), "wb");
+    if (file != nullptr)
+    {
+      done = gzwrite(file, content.data(), content.size()) == (int)content.size();
+      done = gzclose(file) == Z_OK && done;
+    }
+  }
+  else
+  {
+    FILE *file = fopen(tempPath.c_str(), "w");
+    if (file != nullptr)
+    {
+      done = fwrite(content.data(), 1, content.size(), file) == content.size();
+      done = fclose(file) == 0 && done;
+    }
+  }
+  if (done)
+    done = rename(tempPath.c_str(), path_.c_str()) == 0;
+  if (!done)
+  {
+    printf("c Solution Writer: cannot write %s\n", path_.c_str());
+    remove(tempPath.c_str());
+    return false;
+  }
+  boost::mutex::scoped_lock lock(mutexPending_);
+  writtenObj_ = min(writtenObj_, _obj);
+  writeNum_++;
+  return true;
+}
+
+void SolutionWriter::PrintStatistic() const
+{
+  printf("c Solution File: %ld writes; %ld superseded before writing; best %lf in %s\n",
+         writeNum_, skipNum_, sense_ * writtenObj_, path_.c_str());
+}
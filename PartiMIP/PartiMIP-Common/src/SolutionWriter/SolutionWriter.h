@@ -0,0 +1,57 @@
+/*=====================================================================================
+
+    Filename:     SolutionWriter.h
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#pragma once
+#include "utils/header.h"
+#include "utils/paras.h"
+
+/* Keeps the incumbent of the original model on disk in MIPLIB .sol format
+   (gzip-compressed when the path ends in .gz). Submit() only copies the
+   solution; a writer thread replaces the file by renaming a temporary one,
+   at most once per interval, so a killed run still leaves its last
+   incumbent behind. Objectives are submitted minimised, times the model's
+   sense, and written in the model's sense. */
+class SolutionWriter
+{
+public:
+  SolutionWriter(const string &_path, const double _interval, const HighsLp &_lp);
+  ~SolutionWriter();
+  void Submit(const vector<double> &_colValue, const double _obj);
+  bool IsUseful(const double _obj);
+  void Finish();
+  void PrintStatistic() const;
+
+private:
+  string path_;
+  double interval_;
+  vector<string> colNames_;
+  double sense_;
+  boost::mutex mutexPending_;
+  boost::condition_variable condPending_;
+  vector<double> pendingValue_;
+  double pendingObj_;
+  bool havePending_;
+  bool terminated_;
+  double writtenObj_;
+  double lastWriteTime_;
+  size_t writeNum_;
+  size_t skipNum_;
+  pthread_t thread_;
+  bool threadStarted_;
+
+  void Run();
+  bool Write(const vector<double> &_colValue, const double _obj);
+  friend void *SolutionWriterRun(void *arg);
+};
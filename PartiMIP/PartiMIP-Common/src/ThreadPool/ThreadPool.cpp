@@ -0,0 +1,187 @@
+/*=====================================================================================
+
+    Filename:     ThreadPool.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "ThreadPool.h"
+
+thread_local ThreadPool *ThreadPool::localPool_ = nullptr;
+thread_local size_t ThreadPool::localIndex_ = 0;
+
+struct PoolThreadArg
+{
+  ThreadPool *pool;
+  size_t index;
+};
+
+void *PoolThreadRun(void *arg)
+{
+  PoolThreadArg *threadArg = (PoolThreadArg *)arg;
+  ThreadPool *pool = threadArg->pool;
+  size_t index = threadArg->index;
+  delete threadArg;
+  pool->ThreadLoop(index);
+  return nullptr;
+}
+
+ThreadPool::ThreadPool(const size_t _threadNum)
+    : threadNum_(max(_threadNum, (size_t)1)),
+      terminated_(false),
+      queueDepth_(0),
+      taskNum_(0),
+      stealNum_(0),
+      maxQueueDepth_(0),
+      taskLatencySum_(0),
+      taskLatencyMax_(0)
+{
+  for (size_t idx = 0; idx <= threadNum_; ++idx)
+    deques_.push_back(new TaskDeque());
+  threads_.resize(threadNum_);
+  for (size_t idx = 0; idx < threadNum_; ++idx)
+    pthread_create(&threads_[idx], nullptr, PoolThreadRun, new PoolThreadArg{this, idx});
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    boost::mutex::scoped_lock lock(mutexSleep_);
+    terminated_ = true;
+  }
+  condSleep_.notify_all();
+  for (size_t idx = 0; idx < threadNum_; ++idx)
+    pthread_join(threads_[idx], nullptr);
+  for (TaskDeque *taskDeque : deques_)
+    delete taskDeque;
+}
+
+void ThreadPool::Submit(TaskGroup &_group, const function<void()> &_func)
+{
+  _group.pendingNum_++;
+  const size_t index = localPool_ == this ? localIndex_ : threadNum_;
+  size_t depth;
+  {
+    boost::mutex::scoped_lock lock(mutexSleep_);
+    depth = ++queueDepth_;
+  }
+  {
+    boost::mutex::scoped_lock lock(deques_[index]->mutex);
+    deques_[index]->tasks.push_back({_func, &_group, chrono::steady_clock::now()});
+  }
+  size_t maxDepth = maxQueueDepth_.load();
+  while (depth > maxDepth && !maxQueueDepth_.compare_exchange_weak(maxDepth, depth))
+    ;
+  condSleep_.notify_one();
+}
+
+bool ThreadPool::PopTask(PoolTask &_task)
+{
+  const bool inPool = localPool_ == this;
+  if (inPool)
+  {
+    TaskDeque *own = deques_[localIndex_];
+    boost::mutex::scoped_lock lock(own->mutex);
+    if (!own->tasks.empty())
+    {
+      _task = std::move(own->tasks.back());
+      own->tasks.pop_back();
+      queueDepth_--;
+      return true;
+    }
+  }
+  for (size_t offset = 0; offset <= threadNum_; ++offset)
+  {
+    const size_t index = (threadNum_ + offset) % (threadNum_ + 1);
+    if (inPool && index == localIndex_)
+      continue;
+    TaskDeque *victim = deques_[index];
+    boost::mutex::scoped_lock lock(victim->mutex);
+    if (!victim->tasks.empty())
+    {
+      _task = std::move(victim->tasks.front());
+      victim->tasks.pop_front();
+      queueDepth_--;
+      if (index != threadNum_)
+        stealNum_++;
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::RunTask(PoolTask &_task)
+{
+  const uint64_t latency = chrono::duration_cast<chrono::microseconds>(
+                               chrono::steady_clock::now() - _task.submitTime)
+                               .count();
+  taskNum_++;
+  taskLatencySum_ += latency;
+  uint64_t latencyMax = taskLatencyMax_.load();
+  while (latency > latencyMax && !taskLatencyMax_.compare_exchange_weak(latencyMax, latency))
+    ;
+  _task.func();
+  if (--_task.group->pendingNum_ == 0)
+  {
+    boost::mutex::scoped_lock lock(mutexSleep_);
+    condSleep_.notify_all();
+  }
+}
+
+void ThreadPool::Wait(TaskGroup &_group)
+{
+  while (!_group.IsDone())
+  {
+    PoolTask task;
+    if (PopTask(task))
+    {
+      RunTask(task);
+      continue;
+    }
+    boost::mutex::scoped_lock lock(mutexSleep_);
+    condSleep_.wait(
+        lock, [&]
+        { return _group.IsDone() || queueDepth_.load() > 0; });
+  }
+}
+
+void ThreadPool::ThreadLoop(const size_t _index)
+{
+  localPool_ = this;
+  localIndex_ = _index;
+  Profiler::NameThread("pool " + to_string(_index));
+  Placement::PinToNode(_index, threadNum_);
+  while (true)
+  {
+    PoolTask task;
+    if (PopTask(task))
+    {
+      RunTask(task);
+      continue;
+    }
+    boost::mutex::scoped_lock lock(mutexSleep_);
+    condSleep_.wait(
+        lock, [&]
+        { return terminated_ || queueDepth_.load() > 0; });
+    if (terminated_ && queueDepth_.load() == 0)
+      break;
+  }
+}
+
+void ThreadPool::PrintStatistic() const
+{
+  const size_t taskNum = taskNum_.load();
+  printf("c Thread Pool: %ld threads; %ld tasks; %ld steals; max queue depth %ld; "
+         "task latency %.1lf us avg, %.1lf us max\n",
+         threadNum_, taskNum, stealNum_.load(), maxQueueDepth_.load(),
+         taskNum > 0 ? (double)taskLatencySum_.load() / taskNum : 0.0,
+         (double)taskLatencyMax_.load());
+}
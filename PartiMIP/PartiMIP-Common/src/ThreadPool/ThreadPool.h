@@ -0,0 +1,84 @@
+/*=====================================================================================
+
+    Filename:     ThreadPool.h
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#pragma once
+#include "utils/header.h"
+#include "utils/paras.h"
+#include "Profiler/Profiler.h"
+#include "Placement/Placement.h"
+#include <deque>
+#include <functional>
+
+class TaskGroup
+{
+public:
+  TaskGroup() : pendingNum_(0) {}
+  inline bool IsDone() const { return pendingNum_.load() == 0; }
+
+private:
+  friend class ThreadPool;
+  atomic<size_t> pendingNum_;
+};
+
+struct PoolTask
+{
+  function<void()> func;
+  TaskGroup *group;
+  chrono::steady_clock::time_point submitTime;
+};
+
+/* Long-lived pool with one deque per thread. The owner pops from the back,
+   idle threads and waiting callers steal from the front. Tasks submitted
+   from outside the pool go through one shared injection deque. */
+class ThreadPool
+{
+public:
+  ThreadPool(const size_t _threadNum);
+  ~ThreadPool();
+  void Submit(TaskGroup &_group, const function<void()> &_func);
+  void Wait(TaskGroup &_group);
+  inline size_t GetThreadNum() const { return threadNum_; }
+  inline size_t GetQueueDepth() const { return queueDepth_.load(); }
+  void PrintStatistic() const;
+
+private:
+  struct TaskDeque
+  {
+    boost::mutex mutex;
+    deque<PoolTask> tasks;
+  };
+
+  size_t threadNum_;
+  vector<TaskDeque *> deques_;
+  vector<pthread_t> threads_;
+  atomic<bool> terminated_;
+  atomic<size_t> queueDepth_;
+  boost::mutex mutexSleep_;
+  boost::condition_variable condSleep_;
+
+  atomic<size_t> taskNum_;
+  atomic<size_t> stealNum_;
+  atomic<size_t> maxQueueDepth_;
+  atomic<uint64_t> taskLatencySum_;
+  atomic<uint64_t> taskLatencyMax_;
+
+  static thread_local ThreadPool *localPool_;
+  static thread_local size_t localIndex_;
+
+  bool PopTask(PoolTask &_task);
+  void RunTask(PoolTask &_task);
+  void ThreadLoop(const size_t _index);
+  friend void *PoolThreadRun(void *arg);
+};
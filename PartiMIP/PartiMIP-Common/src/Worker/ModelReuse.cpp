@@ -0,0 +1,29 @@
+/*=====================================================================================
+
+    Filename:     ModelReuse.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "ModelReuse.h"
+
+bool SameModelButBounds(const HighsLp &_lp, const HighsLp &_otherLp)
+{
+  return _lp.num_col_ == _otherLp.num_col_ &&
+         _lp.num_row_ == _otherLp.num_row_ &&
+         _lp.sense_ == _otherLp.sense_ &&
+         _lp.offset_ == _otherLp.offset_ &&
+         _lp.col_cost_ == _otherLp.col_cost_ &&
+         _lp.row_lower_ == _otherLp.row_lower_ &&
+         _lp.row_upper_ == _otherLp.row_upper_ &&
+         _lp.integrality_ == _otherLp.integrality_ &&
+         _lp.a_matrix_ == _otherLp.a_matrix_;
+}
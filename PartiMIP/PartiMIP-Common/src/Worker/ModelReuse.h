@@ -0,0 +1,21 @@
+/*=====================================================================================
+
+    Filename:     ModelReuse.h
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#pragma once
+#include "utils/header.h"
+
+/* A worker keeps the model it solved last loaded in its solver. Two node
+   models can share it if they differ in column bounds only. */
+bool SameModelButBounds(const HighsLp &_lp, const HighsLp &_otherLp);
@@ -16,7 +16,11 @@
 #pragma once
 #include "../utils/header.h"
 #include "../utils/paras.h"
-#include "../Presolve/Presolve.h"
+#include "Presolve/Presolve.h"
+#include "Presolve/PostsolveMap.h"
+#include "Checkpoint/Checkpoint.h"
+#include "Placement/Placement.h"
+#include "Propagator/Propagator.h"
 #include "MIPTree.h"
 #include "../Worker/Worker.h"
 class MIPTree;
@@ -27,16 +31,39 @@ class MIPNode
 public:
   MIPNode(
       const size_t _depth, MIPNode *_parent,
-      const HighsModel &_oriModel,
-      const double _objCutValue);
+      const HighsModel &_baseModel,
+      const vector<BoundChange> &_boundChanges);
   ~MIPNode();
 
   void Activate();
   void ReducedModel();
+  void Propagate(Propagator &_propagator);
+  void Propagate();
+  void Defer();
+  void PresolveModel();
+  void ApplyPresolve();
+  void Unpresolve();
+  inline bool IsUnpresolved() const { return unpresolved_; }
+  inline bool IsDeferred() const { return deferred_; }
+  void LinkToParent();
+  void DealParentEnd();
+  void Discard();
+  void StartPartition() { inPartition_ = true; }
+  void EndPartition();
+  inline MIPNode *GetParentNode() { return parentNode_; }
+  inline const MIPNode *GetLeftNode() const { return leftNode_; }
+  inline const MIPNode *GetRightNode() const { return rightNode_; }
+  inline const vector<BoundChange> &GetBoundChanges() const { return boundChanges_; }
   inline size_t GetNodeID() const { return nodeID_; }
+  inline int GetNumaNode() const { return numaNode_; }
   const HighsModel &GetModelToSolve() const { return presolve_.GetReducedModel(); }
-  const Highs &GetHighsToSolve() const { return highs_; }
-  void ReturnSolution(const HighsSolution &_reducedSolution) { presolve_.SetReducedSolution(_reducedSolution); }
+  inline const vector<HighsInt> &GetOrigColIndex() const { return origColIndex_; }
+  bool LiftSolution(vector<double> &_colValue);
+  inline shared_ptr<const PostsolveMap> GetPostsolveMap() const { return postsolveMap_; }
+  inline const vector<double> &GetOriColValue() const { return oriColValue_; }
+  void SetHintSolution(const vector<double> &_colValue, const double _obj);
+  bool InheritWarmStart();
+  bool TakeWarmStart(vector<double> &_colValue);
   NodeStatus GetNodeStatus() const { return nodeStatus_; }
   ProblemStatus GetProblemStatus() const { return problemStatus_; }
   inline size_t GetDepth() const { return depth_; }
@@ -50,22 +77,32 @@ public:
   bool IsInfeasible() const { return problemStatus_ == ProblemStatus::Infeasible; }
   bool IsFeasible() const { return problemStatus_ == ProblemStatus::Feasible; }
   bool IsUnknown() const { return problemStatus_ == ProblemStatus::Unknown; }
-  void DealOptimal(const HighsSolution &_reducedSolution);
+  void DealOptimal(vector<double> &_oriColValue, const double _obj);
   void DealInfeasible();
-  void DealFeasible(const HighsSolution &_reducedSolution);
-  void DealEndFeasible(const HighsSolution &_reducedSolution, const double _obj);
+  void DealFeasible(vector<double> &_oriColValue, const double _obj);
+  void DealEndFeasible(vector<double> &_oriColValue, const double _obj);
   void DealUnknown();
   void RealseModel();
-  inline double GetObjCutValue() const { return objCutValue_; }
+  void ReleasePresolve();
+  void ReleaseMap();
+  void CloseMapStep();
+  void ReleaseUnusedModel();
+  void EndSolving();
   void SetProblemStatus(ProblemStatus _problemStatus) { problemStatus_ = _problemStatus; }
   void SetNodeStatus(NodeStatus _nodeStatus) { nodeStatus_ = _nodeStatus; }
   void SetWorker(GeneralWorker *_worker) { worker_ = _worker; }
+  void EndRunning();
   vector<MIPNode *> SelectVarToBrach();
   void SetRunningStartTime() { runningStartTime_ = ElapsedTime(); }
   inline double GetRunningStartTime() const { return runningStartTime_; }
   void SolPropagation();
+  static double OriginalObj(const vector<double> &_oriColValue);
   void IncreaseVarBranchInSolved();
   void UpdateVarMsg();
+  bool Restore(const CheckpointNode &_record);
+  void ReleaseSubtree();
+  static map<string, size_t> GetVarBranchInSolved();
+  static void SetVarBranchInSolved(const map<string, size_t> &_varBranchInSolved);
   inline const MIPNode *GetParent() const { return parentNode_; }
   static MIPTree *Tree_;
   static double TreeBestObj_;
@@ -75,6 +112,7 @@ private:
   static size_t NODEID_;
 
   static map<string, size_t> VarBranchInSolved_;
+  static boost::shared_mutex mutexVarBranchInSolved_;
 
   static boost::mutex mutexNODEID__;
 
@@ -92,13 +130,14 @@ private:
   };
 
   string branchVarName_;
-  GeneralWorker *worker_;
+  /* A worker is set on a running node after the tree lock is released,
+     so the worker and the status are published atomically. */
+  atomic<GeneralWorker *> worker_;
   Presolve presolve_;
-  double objCutValue_;
   size_t depth_;
   size_t nodeID_;
   ProblemStatus problemStatus_;
-  NodeStatus nodeStatus_;
+  atomic<NodeStatus> nodeStatus_;
   MIPNode *parentNode_;
   MIPNode *leftNode_;
   MIPNode *rightNode_;
@@ -106,21 +145,57 @@ private:
   size_t varNum_;
   size_t conNum_;
   size_t nonzeroNum_;
-  Highs highs_;
+  /* Until ReducedModel() runs, the node is only its parent's reduced model
+     plus the branching bounds applied on top of it. The bounds are kept
+     afterwards for checkpoints. */
+  const HighsModel *baseModel_;
+  vector<BoundChange> boundChanges_;
+  size_t modelBytes_;
+  /* NUMA node of the thread that presolved the node, where its model's
+     pages were first touched; -1 if that thread was not pinned. */
+  int numaNode_;
+  /* Original model column of each column of the reduced model. */
+  vector<HighsInt> origColIndex_;
+  /* Best solution the node's own worker found, in its reduced model; the
+     children start from it. */
+  vector<double> hintSolution_;
+  double hintObj_;
+  /* Start solution handed to this node's worker, in its reduced model. */
+  vector<double> warmStart_;
   vector<size_t> shortDegree_;
   vector<size_t> varDegree_;
   vector<char> varType_;
   double Obj_;
   double runningStartTime_;
+  bool inPartition_;
+  bool releasePending_;
+  /* Split off without presolving; the worker that runs the node presolves
+     it. Only changed under the tree lock. */
+  bool deferred_;
+  /* Runs on the original model, its solution not having lifted through
+     its presolve. */
+  bool unpresolved_;
+  /* Propagating the branching bounds found a row that cannot hold. */
+  bool splitInfeasible_;
+  /* No worker runs the node any more; its reduced model is only kept for
+     children still to be presolved from it. */
+  bool solveDone_;
+  /* Lifts a solution of the reduced model to the original one; kept after
+     the presolve is released, for solutions reported late. */
+  shared_ptr<const PostsolveMap> postsolveMap_;
+  /* The node's best solution in the original model, kept only while the
+     node is the tree's best. */
+  vector<double> oriColValue_;
 
   void InitModel();
+  void SetInfeasible();
   bool CheckPresolveInfeas();
   bool CheckPresolveOptimal();
   void UpPropagation();
   void DownPropagation();
-  void Postsolve();
-  void Postsolve(const HighsSolution &_reducedSolution);
-  void ObjCut();
+  void Postsolve(const vector<double> &_colValue);
+  void TakeSolution(vector<double> &_oriColValue, const double _obj);
+  void UpdateTreeBest();
 
   /* Branch*/
   size_t bestIndex_;
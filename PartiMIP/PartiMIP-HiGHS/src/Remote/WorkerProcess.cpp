@@ -0,0 +1,329 @@
+/*=====================================================================================
+
+    Filename:     WorkerProcess.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "WorkerProcess.h"
+#include "Reader/MPSReader.h"
+#include "ModelCache/ModelCache.h"
+#include <unistd.h>
+
+HighsCallbackFunctionType remoteNodeCallback =
+    [](int callback_type, const std::string &,
+       const HighsCallbackDataOut *data_out, HighsCallbackDataIn *data_in,
+       void *user_callback_data)
+{
+  WorkerProcess *process = static_cast<WorkerProcess *>(user_callback_data);
+  if (callback_type == kCallbackMipInterrupt ||
+      callback_type == kCallbackSimplexInterrupt ||
+      callback_type == kCallbackIpmInterrupt)
+  {
+    process->PollCoordinator();
+    data_in->user_interrupt = process->IsStopped();
+  }
+  // Stop once the node cannot beat an incumbent better than its own best
+  // solution, as a local worker does.
+  if (callback_type == kCallbackMipInterrupt &&
+      process->IsCutOff(process->GetSense() * data_out->mip_dual_bound))
+    data_in->user_interrupt = true;
+  else if (callback_type == kCallbackMipImprovingSolution)
+    process->ReportSolution(data_out->mip_solution, process->GetSense() * data_out->objective_function_value);
+};
+
+WorkerProcess::WorkerProcess()
+    : pool_(new ThreadPool(OPT(poolThreadNum) > 0 ? OPT(poolThreadNum) : max(2u, thread::hardware_concurrency()))),
+      root_(nullptr),
+      cutoff_(INF),
+      bestObj_(INF),
+      cutOff_(false),
+      sense_(1),
+      stopped_(false),
+      quit_(false),
+      lastPoll_(0),
+      nodeNum_(0),
+      presolveNum_(0),
+      presolveTime_(0),
+      solveTime_(0)
+{
+  highs_.setOptionValue("log_to_console", "false");
+  highs_.setOptionValue("threads", 1);
+}
+
+WorkerProcess::~WorkerProcess()
+{
+  ClearChain(0);
+  delete root_;
+  delete pool_;
+}
+
+/* The same sources as the coordinator, so that both start from the same
+   root model: the model cache, then the parallel reader, then HiGHS, whose
+   model the coordinator keeps when it reads with both. */
+bool WorkerProcess::ReadModel()
+{
+  ModelCache *cache = nullptr;
+  bool done = false;
+  if (!OPT(modelCache).empty())
+  {
+    cache = new ModelCache(OPT(modelCache), OPT(instance), Presolve::OptionKey(), pool_);
+    done = cache->LoadModel(model_);
+  }
+  if (!done && OPT(mpsReader) == 1)
+  {
+    MPSReader reader(pool_);
+    done = reader.Read(OPT(instance), model_);
+  }
+  if (!done)
+  {
+    Highs reader;
+    reader.setOptionValue("output_flag", false);
+    done = reader.readModel(OPT(instance)) != HighsStatus::kError;
+    if (done)
+      model_ = reader.getModel();
+  }
+  if (done)
+  {
+    // Passing the model through HiGHS normalises it as the coordinator's.
+    Highs normal;
+    normal.setOptionValue("output_flag", false);
+    normal.passModel(std::move(model_));
+    model_ = normal.getModel();
+    root_ = new Presolve(true);
+    if (cache == nullptr || !root_->LoadRoot(*cache, model_))
+    {
+      root_->LoadModel(model_, {});
+      root_->PresolveByHighs();
+    }
+    // Solutions are lifted by the coordinator, not here.
+    root_->Detach(false);
+  }
+  delete cache;
+  return done;
+}
+
+/* The coordinator may still be starting; keep trying until the cutoff. */
+bool WorkerProcess::Connect()
+{
+  while (!channel_.Connect(OPT(connect)))
+  {
+    if (ElapsedTime() > OPT(cutoff))
+      return false;
+    this_thread::sleep_for(chrono::milliseconds(200));
+  }
+  Message hello(MessageType::Hello);
+  hello.Put(model_.lp_.num_col_);
+  hello.Put(model_.lp_.num_row_);
+  hello.Put(model_.lp_.a_matrix_.numNz());
+  hello.Put((int32_t)getpid());
+  hello.Put(HashModel(model_.lp_));
+  hello.PutVector(vector<char>(OPT(token).begin(), OPT(token).end()));
+  return channel_.Send(hello);
+}
+
+bool WorkerProcess::Run()
+{
+  if (!ReadModel())
+  {
+    printf("c Remote: cannot read %s\n", OPT(instance).c_str());
+    return false;
+  }
+  printf("c %10.2lf    [%-10s] [ Var: %d; Range: %d; NonZero: %d ]\n",
+         ElapsedTime(), "Ori Model", model_.lp_.num_col_, model_.lp_.num_row_, model_.lp_.a_matrix_.numNz());
+  if (!Connect())
+  {
+    printf("c Remote: cannot connect to %s\n", OPT(connect).c_str());
+    return false;
+  }
+  printf("c Remote: connected to %s\n", OPT(connect).c_str());
+  Message message;
+  while (!quit_ && channel_.Receive(message))
+  {
+    if (message.type == MessageType::Node && !SolveNode(message))
+      break;
+    else if (message.type == MessageType::Bound)
+      message.Get(cutoff_);
+    else if (message.type == MessageType::Quit)
+      quit_ = true;
+  }
+  const bool done = quit_;
+  printf("c Remote: %s; %ld nodes; %ld presolves in %.2lf s; %.2lf s solving; %ld bytes sent, %ld received\n",
+         done ? "released by the coordinator" : "lost the coordinator",
+         nodeNum_, presolveNum_, presolveTime_, solveTime_,
+         channel_.GetBytesSent(), channel_.GetBytesReceived());
+  return done;
+}
+
+/* Reads what the coordinator sent while a node is being solved. Called
+   from the solver callback, so checks are spaced out. */
+bool WorkerProcess::PollCoordinator()
+{
+  if (ElapsedTime() - lastPoll_ < 0.05)
+    return channel_.IsOpen();
+  lastPoll_ = ElapsedTime();
+  Message message;
+  while (channel_.Poll(0) > 0)
+  {
+    if (!channel_.Receive(message))
+      break;
+    if (message.type == MessageType::Bound)
+    {
+      double cutoff;
+      if (message.Get(cutoff))
+        cutoff_ = min(cutoff_, cutoff);
+    }
+    else if (message.type == MessageType::Stop)
+      stopped_ = true;
+    else if (message.type == MessageType::Quit)
+      stopped_ = quit_ = true;
+  }
+  if (!channel_.IsOpen())
+    stopped_ = quit_ = true;
+  return channel_.IsOpen();
+}
+
+/* Only an incumbent strictly better than the node's own best solution
+   cuts the node off; if the incumbent is its own, HiGHS ends on its gap. */
+bool WorkerProcess::IsCutOff(const double _dualBound)
+{
+  if (cutoff_ < bestObj_ - 1e-6 && _dualBound >= cutoff_ - 1e-6)
+    cutOff_ = true;
+  return cutOff_;
+}
+
+void WorkerProcess::ReportSolution(const double *_colValue, const double _obj)
+{
+  if (_colValue == nullptr)
+    return;
+  bestObj_ = min(bestObj_, _obj);
+  Message solution(MessageType::Solution);
+  solution.Put(_obj);
+  solution.PutVector(vector<double>(_colValue, _colValue + highs_.getNumCol()));
+  channel_.Send(solution);
+}
+
+void WorkerProcess::ClearChain(const size_t _depth)
+{
+  for (size_t i = _depth; i < chain_.size(); ++i)
+    delete chain_[i];
+  chain_.resize(min(_depth, chain_.size()));
+  path_.resize(chain_.size());
+}
+
+/* Presolves the path's steps below the part it shares with the previous
+   node's path. Nullptr if a step ends in presolve, which the coordinator
+   would have seen too, so the replay has diverged. */
+const HighsModel *WorkerProcess::ReplayPath(const vector<BoundChange> &_path)
+{
+  size_t depth = 0;
+  while (depth < path_.size() && depth < _path.size() &&
+         path_[depth].col == _path[depth].col &&
+         path_[depth].lower == _path[depth].lower &&
+         path_[depth].upper == _path[depth].upper)
+    depth++;
+  ClearChain(depth);
+  const double startTime = ElapsedTime();
+  for (; depth < _path.size(); ++depth)
+  {
+    const Presolve *parent = depth == 0 ? root_ : chain_[depth - 1];
+    if (_path[depth].col < 0 || _path[depth].col >= parent->GetReducedModel().lp_.num_col_)
+      return nullptr;
+    // The coordinator propagated the branching bound before presolving.
+    vector<BoundChange> changes = {_path[depth]};
+    if (OPT(propagate) == 1 && !Propagator(parent->GetReducedModel().lp_).Propagate(changes))
+      return nullptr;
+    Presolve *presolve = new Presolve(true);
+    if (OPT(incrementalPresolve) > 0)
+      presolve->PresolveIncremental(parent->GetReducedModel(), changes, OPT(incrementalPresolve));
+    else
+    {
+      presolve->LoadModel(parent->GetReducedModel(), changes);
+      presolve->PresolveByHighs();
+    }
+    presolve->Detach(false);
+    chain_.push_back(presolve);
+    path_.push_back(_path[depth]);
+    presolveNum_++;
+    if (presolve->CheckPresolveInfeas() || presolve->CheckPresolveOptimal())
+      return nullptr;
+  }
+  presolveTime_ += ElapsedTime() - startTime;
+  return &(chain_.empty() ? root_ : chain_.back())->GetReducedModel();
+}
+
+bool WorkerProcess::SolveNode(Message &_node)
+{
+  uint64_t nodeID;
+  double timeLimit;
+  HighsInt colNum, rowNum, nonzeroNum;
+  vector<BoundChange> path;
+  vector<double> start;
+  if (!_node.Get(nodeID) || !_node.Get(cutoff_) || !_node.Get(timeLimit) ||
+      !_node.Get(colNum) || !_node.Get(rowNum) || !_node.Get(nonzeroNum) ||
+      !_node.GetVector(path) || !_node.GetVector(start))
+    return false;
+  const HighsModel *model = ReplayPath(path);
+  if (model == nullptr || model->lp_.num_col_ != colNum || model->lp_.num_row_ != rowNum ||
+      model->lp_.a_matrix_.numNz() != nonzeroNum)
+  {
+    printf("c Remote: node %ld does not replay on this model\n", (size_t)nodeID);
+    return false;
+  }
+  highs_.passModel(*model);
+  sense_ = (HighsInt)model->lp_.sense_;
+  if (OPT(defualtPrecision) == 0)
+  {
+    highs_.setOptionValue("mip_abs_gap", OPT(AbsMIPGap));
+    highs_.setOptionValue("mip_rel_gap", OPT(MIPGap));
+  }
+  else
+  {
+    highs_.setOptionValue("mip_abs_gap", 0.0);
+    highs_.setOptionValue("mip_rel_gap", 0.0);
+  }
+  highs_.setOptionValue("objective_bound", cutoff_);
+  highs_.setOptionValue("time_limit", max(timeLimit, 1.0));
+  if (start.size() == (size_t)colNum)
+  {
+    HighsSolution solution;
+    solution.col_value.swap(start);
+    solution.value_valid = true;
+    highs_.setSolution(solution);
+  }
+  stopped_ = false;
+  bestObj_ = INF;
+  cutOff_ = false;
+  highs_.setCallback(remoteNodeCallback, this);
+  highs_.startCallback(kCallbackMipInterrupt);
+  highs_.startCallback(kCallbackSimplexInterrupt);
+  highs_.startCallback(kCallbackIpmInterrupt);
+  highs_.startCallback(kCallbackMipImprovingSolution);
+  const double startTime = ElapsedTime();
+  highs_.run();
+  solveTime_ += ElapsedTime() - startTime;
+  nodeNum_++;
+  // Stopped by the cutoff: no better solution below the incumbent, the
+  // same as an LP stopped at the objective bound.
+  HighsModelStatus status = highs_.getModelStatus();
+  if (status == HighsModelStatus::kInterrupt && !stopped_ && cutOff_)
+    status = HighsModelStatus::kObjectiveBound;
+  const bool haveIncumbent = status == HighsModelStatus::kOptimal ||
+                             highs_.getInfo().primal_solution_status == SolutionStatus::kSolutionStatusFeasible;
+  const HighsSolution &solution = highs_.getSolution();
+  Message result(MessageType::Result);
+  result.Put((int32_t)status);
+  result.Put((uint8_t)haveIncumbent);
+  result.Put(sense_ * highs_.getObjectiveValue());
+  result.PutVector(haveIncumbent ? solution.col_value : vector<double>());
+  result.PutVector(haveIncumbent ? solution.row_value : vector<double>());
+  return channel_.Send(result);
+}
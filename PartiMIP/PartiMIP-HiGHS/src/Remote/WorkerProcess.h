@@ -0,0 +1,70 @@
+/*=====================================================================================
+
+    Filename:     WorkerProcess.h
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#pragma once
+#include "../utils/header.h"
+#include "../utils/paras.h"
+#include "Presolve/Presolve.h"
+#include "Propagator/Propagator.h"
+#include "ThreadPool/ThreadPool.h"
+#include "Remote/Channel.h"
+
+/* A process started with --connect. It reads the instance itself, presolves
+   the root as the coordinator does, and then solves the nodes it is sent.
+   A node's model is rebuilt by presolving again along its path of bound
+   changes; the presolvers of the previous node's path are kept, so that a
+   node next to the previous one only presolves the steps that differ. */
+class WorkerProcess
+{
+public:
+  WorkerProcess();
+  ~WorkerProcess();
+  bool Run();
+  bool PollCoordinator();
+  void ReportSolution(const double *_colValue, const double _obj);
+  bool IsCutOff(const double _dualBound);
+  inline double GetCutoff() const { return cutoff_; }
+  inline double GetSense() const { return sense_; }
+  inline bool IsStopped() const { return stopped_; }
+
+private:
+  Channel channel_;
+  ThreadPool *pool_;
+  HighsModel model_;
+  Presolve *root_;
+  vector<BoundChange> path_;
+  vector<Presolve *> chain_;
+  Highs highs_;
+  double cutoff_;
+  /* Best objective the node being solved has found, and whether a better
+     incumbent has cut it off. */
+  double bestObj_;
+  bool cutOff_;
+  /* Sense of the node's model; objectives are sent minimised. */
+  double sense_;
+  bool stopped_;
+  bool quit_;
+  double lastPoll_;
+  size_t nodeNum_;
+  size_t presolveNum_;
+  double presolveTime_;
+  double solveTime_;
+
+  bool ReadModel();
+  bool Connect();
+  bool SolveNode(Message &_node);
+  const HighsModel *ReplayPath(const vector<BoundChange> &_path);
+  void ClearChain(const size_t _depth);
+};
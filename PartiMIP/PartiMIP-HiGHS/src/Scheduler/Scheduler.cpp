@@ -18,6 +18,7 @@
 void *WorkerSolve(void *arg)
 {
   Worker *worker = (Worker *)arg;
+  Placement::Pin(worker->GetTid());
   worker->Run();
   return nullptr;
 }
@@ -25,10 +26,13 @@ void *WorkerSolve(void *arg)
 void *InitNodes(void *arg)
 {
   MIPTree *mipTree = (MIPTree *)arg;
+  Profiler::NameThread("init partition");
   mipTree->BuildInitNodes();
   return nullptr;
 }
 
+/* Remote workers come after the thread workers, one per worker process
+   that may connect at a time. */
 void Scheduler::InitWorkerSet()
 {
   rootWorker_ = new RootWorker(0, this);
@@ -38,32 +42,177 @@ void Scheduler::InitWorkerSet()
     GeneralWorker *generalWorker = new GeneralWorker(tid, this);
     workerSet_.push_back(generalWorker);
   }
+  if (OPT(listen).empty() || OPT(remoteNum) == 0)
+    return;
+  modelHash_ = HashModel(GetRootModel().lp_);
+  listenFd_ = Channel::Listen(OPT(listen));
+  if (listenFd_ < 0)
+  {
+    printf("c Remote: cannot listen on %s\n", OPT(listen).c_str());
+    return;
+  }
+  printf("c Remote: listening on %s for %d worker processes\n", OPT(listen).c_str(), OPT(remoteNum));
+  for (size_t i = 0; i < (size_t)OPT(remoteNum); ++i)
+    workerSet_.push_back(new RemoteWorker(threadNum_ + i, this, listenFd_));
+}
+
+/* A model found in the model cache is taken as it is. Otherwise the
+   parallel reader declines files it does not handle and HiGHS reads
+   them instead. gzip and bzip2 files are inflated while they are
+   parsed. With mpsReader=2 both read the file and the models are
+   compared, HiGHS' one being kept. */
+void Scheduler::ReadModel()
+{
+  PhaseTimer timer(Phase::ReadModel);
+  HighsModel model;
+  if (!OPT(modelCache).empty())
+  {
+    const double startTime = ElapsedTime();
+    modelCache_ = new ModelCache(OPT(modelCache), OPT(instance), Presolve::OptionKey(), MIPTree::GetThreadPool());
+    if (modelCache_->LoadModel(model))
+    {
+      printf("c Read Model: %.3lf s from the model cache\n", ElapsedTime() - startTime);
+      highs_.passModel(std::move(model));
+      return;
+    }
+  }
+  bool parallelRead = false;
+  double parallelTime = 0;
+  if (OPT(mpsReader) > 0)
+  {
+    const double startTime = ElapsedTime();
+    MPSReader reader(MIPTree::GetThreadPool());
+    parallelRead = reader.Read(OPT(instance), model);
+    parallelTime = ElapsedTime() - startTime;
+    if (parallelRead)
+      printf("c Read Model: %.3lf s by the parallel reader; %ld column chunks; %s; %ld bytes of text\n",
+             parallelTime, reader.GetChunkNum(),
+             reader.GetCompression() == nullptr ? "uncompressed" : reader.GetCompression(),
+             reader.GetBytes());
+    else
+      printf("c Read Model: parallel reader declined (%s)\n", reader.GetError().c_str());
+  }
+  if (parallelRead && OPT(mpsReader) == 1)
+  {
+    highs_.passModel(std::move(model));
+    return;
+  }
+  const double startTime = ElapsedTime();
+  const HighsStatus status = highs_.readModel(OPT(instance));
+  const double highsTime = ElapsedTime() - startTime;
+  printf("c Read Model: %.3lf s by HiGHS readModel\n", highsTime);
+  if (!parallelRead)
+    return;
+  if (status == HighsStatus::kError)
+  {
+    // HiGHS cannot read bzip2.
+    printf("c Read Model: HiGHS readModel failed; keeping the parallel reader's model\n");
+    highs_.passModel(std::move(model));
+    return;
+  }
+  Highs check;
+  check.setOptionValue("output_flag", false);
+  check.passModel(std::move(model));
+  HighsLp lp = check.getLp();
+  lp.model_name_ = highs_.getLp().model_name_;
+  const bool same = lp.equalButForScalingAndNames(highs_.getLp()) &&
+                    lp.integrality_ == highs_.getLp().integrality_ &&
+                    lp.equalNames(highs_.getLp());
+  printf("c Read Model: models %s; parallel reader %.2lfx as fast\n",
+         same ? "identical" : "DIFFER", highsTime / max(parallelTime, 1e-6));
 }
 
 void Scheduler::InitModel()
 {
-  highs_.readModel(OPT(instance));
+  ReadModel();
+  if (!OPT(solution).empty())
+    solutionWriter_ = new SolutionWriter(OPT(solution), OPT(solutionInterval), highs_.getLp());
   printf("c %10.2lf    [%-10s] [ Var: %d; Range: %d; NonZero: %d ]\n",
          ElapsedTime(), "Ori Model", highs_.getNumCol(), highs_.getNumRow(), highs_.getNumNz());
+  if (OPT(resume) && !OPT(checkpoint).empty())
+    LoadCheckpoint();
+}
+
+/* The tree itself is rebuilt by BuildInitNodes; here the checkpoint is
+   checked against the model and its incumbent is put back in place. */
+void Scheduler::LoadCheckpoint()
+{
+  if (!resume_.Read(OPT(checkpoint)))
+  {
+    printf("c Checkpoint: cannot read %s; starting afresh\n", OPT(checkpoint).c_str());
+    return;
+  }
+  if (resume_.colNum != highs_.getNumCol() || resume_.rowNum != highs_.getNumRow() ||
+      resume_.nonzeroNum != highs_.getNumNz())
+  {
+    printf("c Checkpoint: %s was written for another model; starting afresh\n", OPT(checkpoint).c_str());
+    return;
+  }
+  resumedTime_ = resume_.searchTime;
+  mipTree_->SetResume(&resume_);
+  if (resume_.incumbent.empty())
+    return;
+  solutionPool_->Add(resume_.incumbent, resume_.incumbentObj);
+  if (solutionWriter_ != nullptr)
+    solutionWriter_->Submit(resume_.incumbent, resume_.incumbentObj);
+  printf("c Checkpoint: resumed incumbent %lf\n", OriginalObj(resume_.incumbentObj));
+}
+
+/* The incumbent is the best solution lifted to the original model so far:
+   the solution pool's, or the tree's once it has been carried to the
+   root. */
+void Scheduler::WriteCheckpoint()
+{
+  const double startTime = ElapsedTime();
+  Checkpoint checkpoint;
+  checkpoint.colNum = highs_.getNumCol();
+  checkpoint.rowNum = highs_.getNumRow();
+  checkpoint.nonzeroNum = highs_.getNumNz();
+  checkpoint.searchTime = resumedTime_ + startTime;
+  if (!mipTree_->Snapshot(checkpoint))
+    return;
+  size_t version;
+  if (!solutionPool_->GetBest(checkpoint.incumbent, checkpoint.incumbentObj, version))
+    checkpoint.incumbentObj = INF;
+  vector<double> colValue;
+  double obj;
+  if (mipTree_->GetBestSolution(colValue, obj) && obj < checkpoint.incumbentObj)
+  {
+    checkpoint.incumbent.swap(colValue);
+    checkpoint.incumbentObj = obj;
+  }
+  if (!checkpoint.Write(OPT(checkpoint)))
+  {
+    printf("c Checkpoint: cannot write %s\n", OPT(checkpoint).c_str());
+    return;
+  }
+  checkpointNum_++;
+  checkpointTime_ += ElapsedTime() - startTime;
+  DEBUG_PRINT("c %10.2lf    [%-10s]    %ld nodes\n",
+              ElapsedTime(), "Checkpoint", checkpoint.nodes.size());
 }
 
 void Scheduler::TerminateWorker()
 {
-  for (size_t tid = 0; tid < threadNum_; ++tid)
+  for (size_t tid = 0; tid < workerSet_.size(); ++tid)
     workerSet_[tid]->Terminate();
+  Notify();
 }
 
 void Scheduler::Solve()
 {
   printf("c -----------------solve start----------------------\n");
-  vector<pthread_t> workerPtr(threadNum_);
-  for (size_t tid = 0; tid < threadNum_; tid++)
+  Profiler::NameThread("scheduler");
+  vector<pthread_t> workerPtr(workerSet_.size());
+  for (size_t tid = 0; tid < workerSet_.size(); tid++)
     pthread_create(&workerPtr[tid], nullptr, WorkerSolve, workerSet_[tid]);
   pthread_t initNodesPtr;
   pthread_create(&initNodesPtr, nullptr, InitNodes, mipTree_);
+  size_t eventSeq = GetEventSeq();
   while (!mipTree_->GetInitDone())
   {
-    this_thread::sleep_for(chrono::seconds(1));
+    WaitEvent(eventSeq, cutoff_ - 10 - ElapsedTime());
+    eventSeq = GetEventSeq();
     if (ElapsedTime() + 10 >= cutoff_)
     {
       terminated_ = true;
@@ -81,21 +230,32 @@ void Scheduler::Solve()
     {
       for (size_t tid = 1; tid < threadNum_ && tid - 1 < initNodes.size(); ++tid)
       {
-        GeneralWorker *generalWorker = dynamic_cast<GeneralWorker *>(workerSet_[tid]);
+        GeneralWorker *generalWorker = static_cast<GeneralWorker *>(workerSet_[tid]);
         generalWorker->SetNode(initNodes[tid - 1]);
         initNodes[tid - 1]->SetWorker(generalWorker);
         generalWorker->Busy();
       }
       for (size_t tid = initNodes.size() + 1; tid < threadNum_; ++tid)
       {
-        GeneralWorker *generalWorker = dynamic_cast<GeneralWorker *>(workerSet_[tid]);
+        GeneralWorker *generalWorker = static_cast<GeneralWorker *>(workerSet_[tid]);
         generalWorker->SetPhase2();
       }
     }
   }
+  nextCheckpoint_ = OPT(checkpoint).empty() ? INF : ElapsedTime() + OPT(checkpointInterval);
   while (!terminated_)
   {
-    this_thread::sleep_for(chrono::seconds(1));
+    if (ElapsedTime() < cutoff_ &&
+        !mipTree_->IsEnd() &&
+        !rootWorker_->IsDone())
+      WaitEvent(eventSeq, min(cutoff_, nextCheckpoint_) - ElapsedTime());
+    eventSeq = GetEventSeq();
+    CollectSolutions();
+    if (ElapsedTime() >= nextCheckpoint_)
+    {
+      WriteCheckpoint();
+      nextCheckpoint_ = ElapsedTime() + OPT(checkpointInterval);
+    }
     if (ElapsedTime() >= cutoff_ ||
         mipTree_->IsEnd() ||
         rootWorker_->IsDone())
@@ -107,17 +267,22 @@ void Scheduler::Solve()
   }
   printf("c -----------------ending solve----------------------\n");
   SimpleResult();
-  for (size_t i = 0; i < threadNum_; i++)
+  for (size_t i = 0; i < workerSet_.size(); i++)
     pthread_join(workerPtr[i], nullptr);
+  mipTree_->WaitPartition();
   printf("c -----------------ending join----------------------\n");
   PrintResult();
   pthread_join(initNodesPtr, nullptr);
+  if (!OPT(profile).empty())
+    Profiler::WriteReport(OPT(profile), threadNum_);
+  if (Profiler::IsTracing())
+    Profiler::WriteTrace(OPT(trace));
 }
 
 void Scheduler::SimpleResult()
 {
   if (HaveIncumbent())
-    printf("c GetIncumbent: %lf\n", GetIncumbent());
+    printf("c GetIncumbent: %lf\n", OriginalObj(GetIncumbent()));
   if (rootWorker_->IsEnd() || mipTree_->IsEnd())
   {
     double solveTime = mipTree_->GetSolveTime() < rootWorker_->GetSolveTime()
@@ -137,25 +302,38 @@ void Scheduler::PrintResult()
 {
   if (MIPNode::TreeBestNode_ != nullptr)
     MIPNode::TreeBestNode_->SolPropagation();
+  if (solutionWriter_ != nullptr)
+  {
+    CollectSolutions();
+    vector<double> colValue;
+    double obj;
+    if (mipTree_->GetBestSolution(colValue, obj))
+      solutionWriter_->Submit(colValue, obj);
+    solutionWriter_->Finish();
+  }
+  if (modelCache_ != nullptr)
+    modelCache_->Finish();
+  if (!OPT(checkpoint).empty() && mipTree_->GetInitDone())
+    WriteCheckpoint();
   printf("c-----------------------result-----------------------\n");
   rootWorker_->PrintResult();
   printf("c-----------------------------------------------------\n");
   if (mipTree_->IsEnd())
     if (mipTree_->IsOptimal() ||
         HaveIncumbent() && mipTree_->IsFeasible())
-      printf("c MIP Tree   : Optimal; %lf\n", mipTree_->GetBestObj());
+      printf("c MIP Tree   : Optimal; %lf\n", OriginalObj(mipTree_->GetBestObj()));
     else
     {
       assert(mipTree_->IsInfeasible());
       printf("c MIP Tree   : Infeasible\n");
     }
   else if (mipTree_->IsFeasible())
-    printf("c MIP Tree   : Feasible; %lf\n", mipTree_->GetBestObj());
+    printf("c MIP Tree   : Feasible; %lf\n", OriginalObj(mipTree_->GetBestObj()));
   else
     printf("c MIP Tree   : Unknown\n");
   printf("c-----------------------------------------------------\n");
   if (rootWorker_->IsFeasible() || mipTree_->IsFeasible() || HaveIncumbent())
-    printf("c Best Found Objective Value: %lf\n", GetFinalBestObj());
+    printf("c Best Found Objective Value: %lf\n", OriginalObj(GetFinalBestObj()));
   if (rootWorker_->IsUnknown() && mipTree_->IsUnknown())
     printf("c UNKNOWN\n");
   if (rootWorker_->IsEnd() || mipTree_->IsEnd())
@@ -171,11 +349,54 @@ void Scheduler::PrintResult()
       printf("c INFEASIBLE\n");
     printf("c Solve Time: %lf\n", solveTime);
   }
+  mipTree_->PrintStatistic();
+  solutionPool_->PrintStatistic(highs_.getLp().sense_);
+  if (solutionWriter_ != nullptr)
+    solutionWriter_->PrintStatistic();
+  if (modelCache_ != nullptr)
+    modelCache_->PrintStatistic();
+  if (!OPT(checkpoint).empty())
+    printf("c Checkpoint: %ld writes; %.3lf s writing; %.2lf s searched before this run\n",
+           checkpointNum_, checkpointTime_, resumedTime_);
+  double setupTime = 0, workerSolveTime = 0;
+  size_t nodeNum = 0, reuseNum = 0;
+  for (size_t tid = 1; tid < threadNum_; tid++)
+  {
+    GeneralWorker *generalWorker = (GeneralWorker *)workerSet_[tid];
+    setupTime += generalWorker->GetSetupTime();
+    workerSolveTime += generalWorker->GetSolveTime();
+    nodeNum += generalWorker->GetNodeNum();
+    reuseNum += generalWorker->GetReuseNum();
+  }
+  printf("c Worker Time: %.2lf s setup; %.2lf s solve; %ld nodes; %ld models reused\n",
+         setupTime, workerSolveTime, nodeNum, reuseNum);
+  if (workerSet_.size() > threadNum_)
+  {
+    size_t connectNum = 0, lostNum = 0, bytes = 0;
+    double remoteTime = 0;
+    nodeNum = 0;
+    for (size_t tid = threadNum_; tid < workerSet_.size(); tid++)
+    {
+      RemoteWorker *remoteWorker = (RemoteWorker *)workerSet_[tid];
+      connectNum += remoteWorker->GetConnectNum();
+      lostNum += remoteWorker->GetLostNum();
+      bytes += remoteWorker->GetBytes();
+      remoteTime += remoteWorker->GetSolveTime();
+      nodeNum += remoteWorker->GetNodeNum();
+    }
+    printf("c Remote: %ld worker processes joined, %ld lost; %ld nodes in %.2lf s; %ld bytes exchanged\n",
+           connectNum, lostNum, nodeNum, remoteTime, bytes);
+  }
+  if (dispatchNum_ > 0)
+    printf("c Dispatch Latency: %.1lf us avg; %.1lf us max; %ld dispatches\n",
+           (double)dispatchLatencySum_ / dispatchNum_, (double)dispatchLatencyMax_, (size_t)dispatchNum_);
   printf("c-----------------------------------------------------\n");
 }
 
 void Scheduler::Optimize()
 {
+  // Before the partition pool starts its threads in InitModel.
+  Placement::Init(threadNum_);
   InitModel();
   InitWorkerSet();
   Solve();
@@ -212,35 +433,58 @@ const double Scheduler::GetFinalBestObj() const
   return res;
 }
 
+/* The solution is lifted before the tree is locked, and the scheduler
+   lock is not taken at all: a worker handed a node that ends before it
+   is set on the node stops itself, see GetNodeToRun. */
 void Scheduler::NodeResult(
     MIPNode *_node, const HighsModelStatus &_status,
     const bool &_haveIncumbent, const HighsSolution &_solution,
     const double &_obj, const size_t &_tid) const
 {
   mipTree_->IncreaseInformWorkerNum();
-  boost::mutex::scoped_lock lock(mutexTree_);
   DEBUG_PRINT("c %10.2lf    [%-10s]    Worker(%3ld) ---> Node(%ld): %s\n",
               ElapsedTime(), "Result", _tid,
               _node->GetNodeID(), highs_.modelStatusToString(_status).c_str());
-  mipTree_->InformNodeResult(_node, _status, _haveIncumbent, _solution, _obj);
+  vector<double> oriColValue;
+  double oriObj = _obj;
+  if (_haveIncumbent || _status == HighsModelStatus::kOptimal)
+    mipTree_->LiftNodeSolution(_node, _solution.col_value, oriColValue, oriObj);
+  // The node's objective is the one its worker cut off with, see
+  // GeneralWorker::ObjCut; the original model must value the lifted
+  // solution the same.
+  if (!oriColValue.empty() && fabs(oriObj - _obj) > 1e-6 * max(1.0, fabs(oriObj)))
+  {
+    DEBUG_PRINT("c %10.2lf    [%-10s]    Node(%ld) objective %lf, %lf in the original model\n",
+                ElapsedTime(), "Warning", _node->GetNodeID(), _obj, oriObj);
+  }
+  mipTree_->InformNodeResult(_node, _status, _haveIncumbent, oriColValue, oriObj);
   mipTree_->DecreaseInformWorkerNum();
+  Notify();
+}
+
+bool Scheduler::PresolveNode(MIPNode *_node) const
+{
+  return mipTree_->PresolveNode(_node);
 }
 
 bool Scheduler::GetNodeToRun(const size_t &_tid) const
 {
-  boost::mutex::scoped_lock lock(mutexTree_);
-  if (mipTree_->GetInformWorkerNum() > 0)
-    return false;
-  GeneralWorker *generalWorker = dynamic_cast<GeneralWorker *>(workerSet_[_tid]);
+  GeneralWorker *generalWorker = static_cast<GeneralWorker *>(workerSet_[_tid]);
   if (!mipTree_->IsEnd() && !IsRootWorkerDone() && cutoff_ > ElapsedTime() + 10)
   {
-    MIPNode *node = mipTree_->GetNodeToRun();
+    MIPNode *node = mipTree_->GetNodeToRun(Placement::GetNumaNode(_tid));
     if (node != nullptr)
     {
       generalWorker->SetNode(node);
       node->SetWorker(generalWorker);
+      // Ended by a result since the tree handed it out, before anyone
+      // could stop its worker.
+      if (node->IsEnd())
+        generalWorker->EndRunning();
       generalWorker->Busy();
     }
+    else if (mipTree_->IsPartitioning() || mipTree_->IsPresolving())
+      return false;
   };
   return true;
 }
@@ -248,9 +492,9 @@ bool Scheduler::GetNodeToRun(const size_t &_tid) const
 const size_t Scheduler::GetIdleWorkerNum() const
 {
   size_t res = 0;
-  for (size_t tid = 1; tid < threadNum_; tid++)
+  for (size_t tid = 1; tid < workerSet_.size(); tid++)
   {
-    GeneralWorker *generalWorker = dynamic_cast<GeneralWorker *>(workerSet_[tid]);
+    GeneralWorker *generalWorker = static_cast<GeneralWorker *>(workerSet_[tid]);
     if (generalWorker->IsIdle())
       res++;
   }
@@ -262,11 +506,72 @@ const bool Scheduler::IsRootWorkerDone() const
   return rootWorker_->IsDone();
 }
 
+const bool Scheduler::IsInitDone() const
+{
+  return mipTree_->GetInitDone();
+}
+
+void Scheduler::RequeueNode(MIPNode *_node) const
+{
+  mipTree_->RequeueNode(_node);
+  Notify();
+}
+
+const size_t Scheduler::GetEventSeq() const
+{
+  boost::mutex::scoped_lock lock(mutexEvent_);
+  return eventSeq_;
+}
+
+void Scheduler::Notify() const
+{
+  {
+    boost::mutex::scoped_lock lock(mutexEvent_);
+    eventSeq_++;
+  }
+  condEvent_.notify_all();
+}
+
+void Scheduler::WaitEvent(const size_t &_eventSeq, const double &_timeout) const
+{
+  if (_timeout <= 0)
+    return;
+  boost::mutex::scoped_lock lock(mutexEvent_);
+  condEvent_.timed_wait(
+      lock, boost::posix_time::microseconds((int64_t)(_timeout * 1e6)),
+      [&]
+      { return eventSeq_ != _eventSeq; });
+}
+
+void Scheduler::RecordDispatchLatency(const double &_latency) const
+{
+  const uint64_t latency = (uint64_t)(_latency * 1e6);
+  dispatchNum_++;
+  dispatchLatencySum_ += latency;
+  uint64_t latencyMax = dispatchLatencyMax_.load();
+  while (latency > latencyMax &&
+         !dispatchLatencyMax_.compare_exchange_weak(latencyMax, latency))
+    ;
+}
+
 Scheduler::Scheduler()
-    : logPath_(OPT(logPath) + "0_root.log"),
+    : eventSeq_(0),
+      dispatchNum_(0),
+      dispatchLatencySum_(0),
+      dispatchLatencyMax_(0),
+      mipTree_(new MIPTree()),
+      solutionPool_(new SolutionPool(OPT(solutionPoolSize))),
+      solutionWriter_(nullptr),
+      modelCache_(nullptr),
+      listenFd_(-1),
+      modelHash_(0),
+      resumedTime_(0),
+      nextCheckpoint_(INF),
+      checkpointNum_(0),
+      checkpointTime_(0),
+      logPath_(OPT(logPath) + "0_root.log"),
       cutoff_(OPT(cutoff)),
       threadNum_(OPT(threadNum)),
-      mipTree_(new MIPTree()),
       terminated_(false),
       rootWorker_(nullptr),
       haveIncumbent_(false)
@@ -274,10 +579,65 @@ Scheduler::Scheduler()
   highs_.setOptionValue("log_to_console", "false");
   // highs_.setOptionValue("log_file", logPath_.c_str());
   mipTree_->scheduler_ = this;
+  if (!OPT(trace).empty())
+    Profiler::EnableTrace(OPT(traceBufferSize));
 }
 Scheduler::~Scheduler()
 {
   for (size_t tid = 0; tid < workerSet_.size(); tid++)
     delete (workerSet_[tid]);
   delete mipTree_;
+  delete solutionPool_;
+  delete solutionWriter_;
+  delete modelCache_;
+  Channel::StopListening(listenFd_, OPT(listen));
+}
+
+bool Scheduler::IsUsefulSolution(const double _obj) const
+{
+  return solutionPool_->IsUseful(_obj) ||
+         (solutionWriter_ != nullptr && solutionWriter_->IsUseful(_obj));
+}
+
+/* Called by workers from solver callbacks. Solutions of a tree node are
+   lifted to the original model by the scheduler thread, off the worker. */
+void Scheduler::SubmitSolution(
+    MIPNode *_node, const double *_colValue, const size_t _colNum, const double _obj) const
+{
+  if (_colValue == nullptr || (_node == nullptr && !IsUsefulSolution(_obj)))
+    return;
+  {
+    boost::mutex::scoped_lock lock(mutexPendingSolution_);
+    pendingSolutions_.push_back({_node, vector<double>(_colValue, _colValue + _colNum), _obj});
+  }
+  Notify();
+}
+
+void Scheduler::CollectSolutions()
+{
+  vector<PendingSolution> pending;
+  {
+    boost::mutex::scoped_lock lock(mutexPendingSolution_);
+    pending.swap(pendingSolutions_);
+  }
+  const HighsLp &lp = highs_.getLp();
+  for (PendingSolution &solution : pending)
+  {
+    if (solution.node != nullptr)
+      mipTree_->SetHintSolution(solution.node, solution.colValue, solution.obj);
+    if (!IsUsefulSolution(solution.obj))
+      continue;
+    if (solution.node != nullptr && !mipTree_->LiftSolution(solution.node, solution.colValue))
+      continue;
+    if (solution.colValue.size() != (size_t)lp.num_col_)
+      continue;
+    double obj = lp.offset_;
+    for (HighsInt iCol = 0; iCol < lp.num_col_; iCol++)
+      obj += lp.col_cost_[iCol] * solution.colValue[iCol];
+    obj *= (HighsInt)lp.sense_;
+    if (solutionPool_->Add(solution.colValue, obj))
+      Profiler::TraceCounter("incumbent", obj);
+    if (solutionWriter_ != nullptr)
+      solutionWriter_->Submit(solution.colValue, obj);
+  }
 }
@@ -26,86 +26,142 @@ HighsCallbackFunctionType userSubNodeCallback =
   if (callback_type == kCallbackMipInterrupt ||
       callback_type == kCallbackSimplexInterrupt ||
       callback_type == kCallbackIpmInterrupt)
+  {
     data_in->user_interrupt = data->STOP.load();
+    // Stop once the subproblem cannot beat an incumbent better than its own
+    // best solution. If the incumbent is its own, HiGHS ends on its own gap.
+    const double cutoff = callback_type == kCallbackMipInterrupt ? data->worker->GetCutoff() : INF;
+    if (cutoff < data->bestObj.load() - 1e-6 &&
+        data->sense * data_out->mip_dual_bound >= cutoff - 1e-6)
+    {
+      data->CUTOFF.store(true);
+      data_in->user_interrupt = true;
+    }
+  }
   else if (callback_type == kCallbackMipImprovingSolution)
-    if (data_out->objective_function_value < incumbentSubNode.load())
-      incumbentSubNode.store(data_out->objective_function_value);
+  {
+    const double obj = data->sense * data_out->objective_function_value;
+    if (obj < data->bestObj.load())
+      data->bestObj.store(obj);
+    data->worker->ReportSolution(data_out->mip_solution, obj);
+  }
+#ifdef PARTIMIP_USER_SOLUTION
+  else if (callback_type == kCallbackMipUserSolution)
+  {
+    // Only a pool solution better than the solve's own primal bound is
+    // handed over; HiGHS checks its feasibility.
+    if (data->worker->FetchSolution(data->userSolution, data->sense * data_out->mip_primal_bound))
+      data_in->user_solution = data->userSolution.data();
+  }
+#endif
   if (OPT(cutoff) + 10 < ElapsedTime())
     data_in->user_interrupt = true;
 };
 
 void GeneralWorker::Run()
 {
+  Profiler::NameThread("worker " + to_string(tid_));
   phase2_.store(false);
   while (!terminated_)
   {
-    usleep(100000);
+    WaitWakeUp();
     if (phase2_.load())
     {
-      while (!scheduler_->GetNodeToRun(tid_))
-        usleep(100000);
+      RequestNode();
       phase2_.store(false);
     }
     if (workerStatus_ == WorkerStatus::Busy)
     {
+      Profiler::TraceInstant("worker", "busy", node_->GetNodeID());
+      bool solved = false;
+      if (!endRuning && !PresolveNode())
+        endRuning = true;
       if (!endRuning)
       {
-        highs_.passModel(node_->GetModelToSolve());
+        const double setupStartTime = ElapsedTime();
+        LoadModel(node_->GetModelToSolve());
+        poolVersion_ = 0;
+        SetStartSolution();
         ObjCut();
         SetPrecision();
         SetCallback();
         SetParameter();
+        setupTime_ += ElapsedTime() - setupStartTime;
+        Profiler::RecordSpan(Phase::SolverSetup, setupStartTime, node_->GetNodeID());
       }
       if (!endRuning)
+      {
+        const double solveStartTime = ElapsedTime();
         highs_.run();
+        solveTime_ += ElapsedTime() - solveStartTime;
+        Profiler::RecordSpan(Phase::Solve, solveStartTime, node_->GetNodeID());
+        nodeNum_++;
+        solved = true;
+      }
       Idle();
-      DealResult();
-      while (!scheduler_->GetNodeToRun(tid_))
-        usleep(100000);
+      // A node that ended before it was solved has nothing to report, and
+      // the solver still holds the previous node's result.
+      if (solved)
+        DealResult();
+      else
+        scheduler_->NodeResult(node_, HighsModelStatus::kNotset, false, HighsSolution(), INF, tid_);
+      // Reset before the next node is taken, which may end, and stop this
+      // worker, before it runs.
       endRuning = false;
+      RequestNode();
     }
   }
   DEBUG_PRINT("c %10.2lf    [%-10s]    GeneralWorker(%ld)\n",
               ElapsedTime(), "End", tid_);
 }
 
-void GeneralWorker::ObjCut()
+void GeneralWorker::WaitWakeUp()
+{
+  PhaseTimer timer(Phase::WorkerIdle);
+  boost::mutex::scoped_lock lock(mutexWakeUp_);
+  condWakeUp_.wait(
+      lock, [&]
+      { return terminated_ || phase2_.load() || workerStatus_ == WorkerStatus::Busy; });
+}
+
+/* Waits for the next event rather than polling: every change that can
+   bring a node, a result, a finished presolve or partition, a refilled
+   group or the end of the run, notifies the scheduler. Only the dispatch
+   cutoff, 10 s before the time limit, is a matter of time. */
+void GeneralWorker::RequestNode()
 {
-  if (scheduler_->HaveIncumbent())
+  PhaseTimer timer(Phase::DispatchWait);
+  size_t eventSeq = scheduler_->GetEventSeq();
+  while (!scheduler_->GetNodeToRun(tid_))
   {
-    const double incunmbentValue = scheduler_->GetIncumbent();
-    if (incunmbentValue < node_->GetObjCutValue())
-    {
-      const vector<double> &col_cost = highs_.getLp().col_cost_;
-      HighsInt num_new_nz = 0;
-      for (HighsInt iCol = 0; iCol < highs_.getNumCol(); iCol++)
-        if (col_cost[iCol] != 0.0)
-          num_new_nz++;
-      HighsInt *indices = new HighsInt[num_new_nz];
-      double *values = new double[num_new_nz];
-      size_t idx = 0;
-      for (HighsInt iCol = 0; iCol < highs_.getNumCol(); iCol++)
-        if (col_cost[iCol] != 0.0)
-        {
-          indices[idx] = iCol;
-          values[idx] = col_cost[iCol];
-          idx++;
-        }
-      assert(idx == num_new_nz);
-      highs_.addRow(-INF, incunmbentValue - highs_.getLp().offset_, num_new_nz, indices, values);
-      DEBUG_PRINT("c %10.2lf    [%-10s]    Worker(%3ld) [%lf]\n",
-                  ElapsedTime(), "Obj Cut", tid_, incunmbentValue);
-      delete[] indices;
-      delete[] values;
-    }
+    scheduler_->WaitEvent(eventSeq, OPT(cutoff) - 10 - ElapsedTime());
+    eventSeq = scheduler_->GetEventSeq();
   }
 }
 
+/* The incumbent is passed as HiGHS' objective bound, so the subproblem
+   prunes against it natively. HiGHS compares the bound with the loaded
+   model's minimised objective, offset included, in which presolve keeps
+   the cost of every column it removes; the incumbent, minimised in the
+   original model, is thus the bound whatever the node model's sense. */
+void GeneralWorker::ObjCut()
+{
+  const double incunmbentValue = scheduler_->HaveIncumbent() ? scheduler_->GetIncumbent() : INF;
+  highs_.setOptionValue("objective_bound", incunmbentValue);
+  DEBUG_PRINT("c %10.2lf    [%-10s]    Worker(%3ld) [%lf]\n",
+              ElapsedTime(), "Obj Cut", tid_, incunmbentValue);
+}
+
 GeneralWorker::GeneralWorker(int _tid, Scheduler *_scheduler)
     : Worker(_tid, _scheduler),
-      node_(nullptr),
       terminated_(false),
-      endRuning(false)
+      node_(nullptr),
+      endRuning(false),
+      idleStartTime_(INF),
+      setupTime_(0),
+      solveTime_(0),
+      nodeNum_(0),
+      reuseNum_(0)
 {
   logPath_ = OPT(logPath) + to_string(tid_) + "_thread.log";
   // log_ = ofstream(logPath_);
@@ -116,11 +172,17 @@ GeneralWorker::GeneralWorker(int _tid, Scheduler *_scheduler)
 void GeneralWorker::SetCallback()
 {
   callbackData_->STOP.store(false);
+  callbackData_->CUTOFF.store(false);
+  callbackData_->bestObj.store(INF);
+  callbackData_->sense = (HighsInt)highs_.getLp().sense_;
   highs_.setCallback(userSubNodeCallback, callbackData_);
   highs_.startCallback(kCallbackMipInterrupt);
   highs_.startCallback(kCallbackSimplexInterrupt);
   highs_.startCallback(kCallbackIpmInterrupt);
   highs_.startCallback(kCallbackMipImprovingSolution);
+#ifdef PARTIMIP_USER_SOLUTION
+  highs_.startCallback(kCallbackMipUserSolution);
+#endif
 }
 
 void GeneralWorker::SetParameter()
@@ -136,14 +198,36 @@ void GeneralWorker::SetNode(MIPNode *_node)
 
 void GeneralWorker::Busy()
 {
-  workerStatus_ = WorkerStatus::Busy;
+  {
+    boost::mutex::scoped_lock lock(mutexWakeUp_);
+    if (idleStartTime_ < INF)
+      scheduler_->RecordDispatchLatency(ElapsedTime() - idleStartTime_);
+    idleStartTime_ = INF;
+    workerStatus_ = WorkerStatus::Busy;
+  }
+  condWakeUp_.notify_one();
   DEBUG_PRINT("c %10.2lf    [%-10s]    Worker(%3ld) ---> Node(%ld)\n",
               ElapsedTime(), "Busy", tid_, node_->GetNodeID());
 }
 
+void GeneralWorker::SetPhase2()
+{
+  {
+    boost::mutex::scoped_lock lock(mutexWakeUp_);
+    idleStartTime_ = ElapsedTime();
+    phase2_.store(true);
+  }
+  condWakeUp_.notify_one();
+}
+
 void GeneralWorker::Idle()
 {
-  workerStatus_ = WorkerStatus::Idle;
+  {
+    boost::mutex::scoped_lock lock(mutexWakeUp_);
+    workerStatus_ = WorkerStatus::Idle;
+    idleStartTime_ = ElapsedTime();
+  }
+  Profiler::TraceInstant("worker", "idle", node_->GetNodeID());
   DEBUG_PRINT("c %10.2lf    [%-10s]    Worker(%3ld)\n",
               ElapsedTime(), "Idle", tid_);
 }
@@ -158,6 +242,82 @@ double GeneralWorker::GetIncumbent()
   return incumbentSubNode.load();
 }
 
+void GeneralWorker::ReportSolution(const double *_colValue, const double _obj)
+{
+  double incumbent = incumbentSubNode.load();
+  while (_obj < incumbent && !incumbentSubNode.compare_exchange_weak(incumbent, _obj))
+    ;
+  scheduler_->SubmitSolution(node_, _colValue, node_->GetModelToSolve().lp_.num_col_, _obj);
+}
+
+/* The Highs instance and its options live as long as the worker; a node that
+   differs from the previous one in column bounds only just moves them. */
+void GeneralWorker::LoadModel(const HighsModel &_model)
+{
+  const HighsLp &lp = _model.lp_;
+  if (SameModelButBounds(lp, highs_.getLp()))
+  {
+    highs_.changeColsBounds(0, lp.num_col_ - 1, lp.col_lower_.data(), lp.col_upper_.data());
+    reuseNum_++;
+  }
+  else
+    highs_.passModel(_model);
+}
+
+/* HiGHS takes a single start solution. The pooled incumbent is preferred,
+   unless it violates this node's branching bounds, in which case the
+   solution inherited from the ancestor is used instead. */
+void GeneralWorker::SetStartSolution()
+{
+  HighsSolution start;
+  if (!PickStartSolution(start.col_value))
+    return;
+  start.value_valid = true;
+  highs_.setSolution(start);
+}
+
+/* A node deferred at split time is presolved here, as part of the setup.
+   False if it ended, in presolve or before. */
+bool GeneralWorker::PresolveNode()
+{
+  return !node_->IsDeferred() || scheduler_->PresolveNode(node_);
+}
+
+bool GeneralWorker::PickStartSolution(vector<double> &_colValue)
+{
+  node_->TakeWarmStart(warmStart_);
+  if (!FetchSolution(_colValue, INF))
+    _colValue.swap(warmStart_);
+  return !_colValue.empty();
+}
+
+bool GeneralWorker::WithinBounds(const vector<double> &_colValue)
+{
+  const HighsLp &lp = node_->GetModelToSolve().lp_;
+  for (HighsInt iCol = 0; iCol < lp.num_col_; iCol++)
+    if (_colValue[iCol] < lp.col_lower_[iCol] - 1e-6 ||
+        _colValue[iCol] > lp.col_upper_[iCol] + 1e-6)
+      return false;
+  return true;
+}
+
+/* The pooled solution is in the original model; keep only the columns that
+   survive in this node's reduced model. One that violates the node's
+   branching bounds is of no use to it. */
+bool GeneralWorker::FetchSolution(vector<double> &_colValue, const double _knownObj)
+{
+  if (!FetchPoolSolution(poolSolution_, _knownObj))
+    return false;
+  const vector<HighsInt> &colIndex = node_->GetOrigColIndex();
+  _colValue.resize(colIndex.size());
+  for (size_t i = 0; i < colIndex.size(); ++i)
+    _colValue[i] = poolSolution_[colIndex[i]];
+  if (!WithinBounds(_colValue))
+    return false;
+  scheduler_->GetSolutionPool()->RecordInjection();
+  return true;
+}
+
 void GeneralWorker::EndRunning()
 {
   if (workerStatus_ == WorkerStatus::Busy)
@@ -167,13 +327,24 @@ void GeneralWorker::EndRunning()
 
 void GeneralWorker::DealResult()
 {
+  // A subproblem cut off by a better incumbent has no solution of its own
+  // that beats it: it stopped at the objective bound, which the tree cuts
+  // the node off at. One whose own solution is the incumbent ends with the
+  // HiGHS status.
+  const HighsModelStatus status =
+      callbackData_->CUTOFF.load() ? HighsModelStatus::kObjectiveBound : highs_.getModelStatus();
   scheduler_->NodeResult(
-      node_, highs_.getModelStatus(), IsFeasible(), highs_.getSolution(), highs_.getObjectiveValue(), tid_);
+      node_, status, IsFeasible(), highs_.getSolution(),
+      callbackData_->sense * highs_.getObjectiveValue(), tid_);
 }
 
 void GeneralWorker::Terminate()
 {
   if (workerStatus_ == WorkerStatus::Busy)
     callbackData_->STOP.store(true);
-  terminated_ = true;
+  {
+    boost::mutex::scoped_lock lock(mutexWakeUp_);
+    terminated_ = true;
+  }
+  condWakeUp_.notify_one();
 }
\ No newline at end of file
@@ -27,19 +27,38 @@ HighsCallbackFunctionType userInterruptCallback =
       callback_type == kCallbackIpmInterrupt)
     data_in->user_interrupt = data->STOP.load();
   if (callback_type == kCallbackMipImprovingSolution)
-    incumbentRoot.store(data_out->objective_function_value);
+  {
+    const double obj = data->sense * data_out->objective_function_value;
+    incumbentRoot.store(obj);
+    data->worker->ReportSolution(data_out->mip_solution, obj);
+  }
+#ifdef PARTIMIP_USER_SOLUTION
+  else if (callback_type == kCallbackMipUserSolution)
+  {
+    if (data->worker->FetchSolution(data->userSolution, data->sense * data_out->mip_primal_bound))
+      data_in->user_solution = data->userSolution.data();
+  }
+#endif
 };
 
 void RootWorker::Run()
 {
+  Profiler::NameThread("root worker");
   SetPrecision();
   workerStatus_ = WorkerStatus::Busy;
+  callbackData_->sense = (HighsInt)highs_.getLp().sense_;
   highs_.setCallback(userInterruptCallback, callbackData_);
   highs_.startCallback(kCallbackMipInterrupt);
   highs_.startCallback(kCallbackSimplexInterrupt);
   highs_.startCallback(kCallbackIpmInterrupt);
   highs_.startCallback(kCallbackMipImprovingSolution);
-  highs_.run();
+#ifdef PARTIMIP_USER_SOLUTION
+  highs_.startCallback(kCallbackMipUserSolution);
+#endif
+  {
+    PhaseTimer timer(Phase::Solve);
+    highs_.run();
+  }
   const HighsModelStatus &model_status = highs_.getModelStatus();
   const HighsInfo &info = highs_.getInfo();
   const HighsLp &lp = highs_.getLp();
@@ -60,6 +79,7 @@ void RootWorker::Run()
   // }
   solveTime_ = ElapsedTime();
   workerStatus_ = WorkerStatus::Idle;
+  scheduler_->Notify();
   printf("c %10.2lf    [%-10s]    RootWorker %ld\n",
          ElapsedTime(), "End", tid_);
 }
@@ -101,7 +121,21 @@ bool RootWorker::IsOptimal()
 double RootWorker::GetFinalBestObj()
 {
   assert(IsFeasible());
-  return highs_.getObjectiveValue();
+  return (HighsInt)highs_.getLp().sense_ * highs_.getObjectiveValue();
+}
+
+void RootWorker::ReportSolution(const double *_colValue, const double _obj)
+{
+  scheduler_->SubmitSolution(nullptr, _colValue, scheduler_->GetRootModel().lp_.num_col_, _obj);
+}
+
+/* The pool holds solutions of the original model, which the root solves. */
+bool RootWorker::FetchSolution(vector<double> &_colValue, const double _knownObj)
+{
+  if (!FetchPoolSolution(_colValue, _knownObj))
+    return false;
+  scheduler_->GetSolutionPool()->RecordInjection();
+  return true;
 }
 
 double RootWorker::GetIncumbent()
@@ -16,11 +16,30 @@
 #include "Worker.h"
 
 Worker::Worker(int _tid, Scheduler *_scheduler)
-    : tid_(_tid), scheduler_(_scheduler),
+    : poolVersion_(0),
+      callbackData_(new CallbackData()),
       workerStatus_(WorkerStatus::Idle),
-      callbackData_(new CallbackData())
+      tid_(_tid), scheduler_(_scheduler)
 {
   highs_.setOptionValue("log_to_console", "false");
+  callbackData_->worker = this;
+}
+
+double Worker::GetCutoff()
+{
+  return scheduler_->HaveIncumbent() ? scheduler_->GetIncumbent() : INF;
+}
+
+/* The pool's best solution if this worker has not fetched it yet and it
+   is better than _knownObj, the best one the worker's solve already has,
+   as minimised. */
+bool Worker::FetchPoolSolution(vector<double> &_colValue, const double _knownObj)
+{
+  SolutionPool *pool = scheduler_->GetSolutionPool();
+  if (pool->GetVersion() == poolVersion_)
+    return false;
+  double obj;
+  return pool->GetBest(_colValue, obj, poolVersion_) && obj < _knownObj - 1e-9;
 }
 
 void Worker::Terminate()
@@ -16,14 +16,35 @@
 #pragma once
 #include "../Scheduler/Scheduler.h"
 #include "../utils/header.h"
+#include "Profiler/Profiler.h"
+#include "Remote/Channel.h"
+#include "Worker/ModelReuse.h"
 
 class Scheduler;
 class MIPNode;
 
+class Worker;
+
+/* HiGHS 1.10 lets a callback hand new solutions to a running MIP solve.
+   With the default HiGHS 1.9 a pool solution only seeds a node's start. */
+#if HIGHS_VERSION_MAJOR > 1 || (HIGHS_VERSION_MAJOR == 1 && HIGHS_VERSION_MINOR >= 10)
+#define PARTIMIP_USER_SOLUTION
+#endif
+
 struct CallbackData
 {
   atomic<bool> STOP;
-  CallbackData() : STOP(false) {}
+  atomic<bool> CUTOFF;
+  /* Best objective of the solutions this worker found in its subproblem. */
+  atomic<double> bestObj;
+  /* Sense of the model solved: HiGHS reports objectives and bounds in it,
+     and they are passed on multiplied by it, as minimised. */
+  double sense;
+  Worker *worker;
+  /* Pool solution handed to the running solve, which HiGHS reads after
+     the callback returns. */
+  vector<double> userSolution;
+  CallbackData() : STOP(false), CUTOFF(false), bestObj(INF), sense(1), worker(nullptr) {}
 };
 
 class Worker
@@ -33,13 +54,18 @@ public:
   virtual void Terminate();
   virtual bool HaveIncumbent() = 0;
   virtual double GetIncumbent() = 0;
+  virtual void ReportSolution(const double *_colValue, const double _obj) = 0;
+  virtual bool FetchSolution(vector<double> &_colValue, const double _knownObj) = 0;
+  double GetCutoff();
   Worker(int _tid, Scheduler *_scheduler);
   size_t GetTid() { return tid_; }
-  ~Worker();
+  virtual ~Worker();
   bool IsFeasible();
 
 protected:
   void SetPrecision();
+  bool FetchPoolSolution(vector<double> &_colValue, const double _knownObj);
+  size_t poolVersion_;
   CallbackData *callbackData_;
   string logPath_;
   ofstream log_;
@@ -64,6 +90,8 @@ public:
   double GetFinalBestObj();
   bool HaveIncumbent();
   double GetIncumbent();
+  void ReportSolution(const double *_colValue, const double _obj);
+  bool FetchSolution(vector<double> &_colValue, const double _knownObj);
   double GetSolveTime() const { return solveTime_; }
   void PrintResult();
   inline bool IsDone() { return workerStatus_ == WorkerStatus::Idle; }
@@ -81,17 +109,67 @@ public:
   void Idle();
   bool HaveIncumbent();
   double GetIncumbent();
-  inline bool IsIdle() { return workerStatus_ == WorkerStatus::Idle; }
-  inline void SetPhase2() { phase2_.store(true); }
-  
-private:
-  bool terminated_;
+  void ReportSolution(const double *_colValue, const double _obj);
+  bool FetchSolution(vector<double> &_colValue, const double _knownObj);
+  virtual bool IsIdle() { return workerStatus_ == WorkerStatus::Idle; }
+  void SetPhase2();
+  inline double GetSetupTime() const { return setupTime_; }
+  inline double GetSolveTime() const { return solveTime_; }
+  inline size_t GetNodeNum() const { return nodeNum_; }
+  inline size_t GetReuseNum() const { return reuseNum_; }
+
+protected:
+  atomic<bool> terminated_;
   MIPNode *node_;
   atomic<bool> endRuning;
   atomic<bool> phase2_;
+  boost::mutex mutexWakeUp_;
+  boost::condition_variable condWakeUp_;
+  double idleStartTime_;
+  vector<double> poolSolution_;
+  vector<double> warmStart_;
+  double setupTime_;
+  double solveTime_;
+  size_t nodeNum_;
+  size_t reuseNum_;
 
+  void WaitWakeUp();
+  void RequestNode();
   void DealResult();
+  void LoadModel(const HighsModel &_model);
   void ObjCut();
+  void SetStartSolution();
+  bool PickStartSolution(vector<double> &_colValue);
+  bool PresolveNode();
+  bool WithinBounds(const vector<double> &_colValue);
   void SetCallback();
   void SetParameter();
-};
\ No newline at end of file
+};
+
+/* Stands in the coordinator for one worker process connected over a
+   socket. It takes nodes from the tree like a thread worker and has the
+   worker process solve them. A worker process that goes away leaves its
+   node to be run again, and the slot waits for the next one to connect. */
+class RemoteWorker : public GeneralWorker
+{
+public:
+  void Run();
+  RemoteWorker(int _tid, Scheduler *_scheduler, const int _listenFd);
+  bool IsIdle() { return connected_ && GeneralWorker::IsIdle(); }
+  inline size_t GetConnectNum() const { return connectNum_; }
+  inline size_t GetLostNum() const { return lostNum_; }
+  inline size_t GetBytes() const { return channel_.GetBytesSent() + channel_.GetBytesReceived(); }
+
+private:
+  int listenFd_;
+  Channel channel_;
+  atomic<bool> connected_;
+  size_t connectNum_;
+  size_t lostNum_;
+
+  bool Handshake();
+  bool SolveRemote(
+      HighsModelStatus &_status, bool &_haveIncumbent,
+      HighsSolution &_solution, double &_obj);
+  void Disconnect();
+};
@@ -80,7 +80,7 @@ enum NodeStatus
   End
 };
 
-inline const double ElapsedTime()
+inline double ElapsedTime()
 {
   return std::chrono::duration_cast<std::chrono::duration<double>>(
              std::chrono::steady_clock::now() - timeStart)
@@ -88,4 +88,6 @@ inline const double ElapsedTime()
 }
 const char *NodeStatusToString(const NodeStatus &_nodeStatus);
 const char *ProblemStatusToString(const ProblemStatus &_problemStatus);
-void RecreateDirectory(const string &_path);
\ No newline at end of file
+void RecreateDirectory(const string &_path);
+uint64_t MixHash(uint64_t _hash);
+uint64_t HashBytes(const char *_data, const size_t _size);
@@ -14,6 +14,7 @@
 
 =====================================================================================*/
 #include "../Scheduler/Scheduler.h"
+#include "../Remote/WorkerProcess.h"
 
 std::chrono::steady_clock::time_point timeStart = std::chrono::steady_clock::now();
 
@@ -23,6 +24,8 @@ int main(int argc, char **argv)
 
     // __global_paras.print_change();
     // RecreateDirectory(OPT(logPath));
+    if (!OPT(connect).empty())
+        return WorkerProcess().Run() ? 0 : 1;
     Scheduler scheduler;
     scheduler.Optimize();
     return 0;
@@ -10,10 +10,31 @@
     PARA( defualtPrecision  ,   int      , '\0' ,  false , 1     , 0  , 1       , "defualt precision")\
     PARA( MIPGap            ,   double   , '\0' ,  false , 0     , 0  , 1       , "MIPGap")\
     PARA( AbsMIPGap         ,   double   , '\0' ,  false , 0     , 0  , 1       , "MIPGapAbs")\
+    PARA( poolThreadNum     ,   int      , '\0' ,  false , 0     , 0  , 192     , "Partition pool threads (0: threadNum - 1)")\
+    PARA( partitionAhead    ,   int      , '\0' ,  false , 0     , 0  , 1024    , "Waiting nodes kept ready by splitting ahead (0: off)")\
+    PARA( solutionPoolSize  ,   int      , '\0' ,  false , 10    , 0  , 1000    , "Solutions shared between workers (0: off)")\
+    PARA( traceBufferSize   ,   int      , '\0' ,  false , 65536 , 1024  , 1e8  , "Trace events kept per thread")\
+    PARA( mpsReader         ,   int      , '\0' ,  false , 1     , 0  , 2       , "MPS reader (0: HiGHS; 1: parallel mmap; 2: both, compared)")\
+    PARA( solutionInterval  ,   double   , '\0' ,  false , 1     , 0  , 3600    , "Minimum seconds between solution file rewrites")\
+    PARA( checkpointInterval,   double   , '\0' ,  false , 60    , 1  , 86400   , "Seconds between checkpoint writes")\
+    PARA( resume            ,   int      , '\0' ,  false , 0     , 0  , 1       , "Resume the search from the checkpoint file")\
+    PARA( lazyPresolve      ,   int      , '\0' ,  false , 1     , 0  , 1       , "Presolve children split after the initial partition on their workers")\
+    PARA( propagate         ,   int      , '\0' ,  false , 1     , 0  , 1       , "Propagate branching bounds before presolving a child")\
+    PARA( incrementalPresolve,  int      , '\0' ,  false , 0     , 0  , 100     , "Passes of the incremental presolve of children (0: HiGHS presolve)")\
+    PARA( pinThreads        ,   int      , '\0' ,  false , 0     , 0  , 1       , "Pin workers to cores, one NUMA node after another")\
+    PARA( remoteNum         ,   int      , '\0' ,  false , 0     , 0  , 65536   , "Worker processes served at a time (needs --listen)")\
 //            name,   short-name, must-need, default, comments
 #define STR_PARAS \
     STR_PARA( instance   , 'i'   ,  true    , "" , ".mps format instance")\
-    STR_PARA( logPath    , 'l'   ,  false    , "log/" , "")
+    STR_PARA( logPath    , 'l'   ,  false    , "log/" , "")\
+    STR_PARA( profile    , '\0'  ,  false    , ""     , "JSON phase profile written at exit (empty: off)")\
+    STR_PARA( trace      , '\0'  ,  false    , ""     , "Chrome trace written at exit (empty: off)")\
+    STR_PARA( solution   , '\0'  ,  false    , ""     , "Incumbent kept in this .sol or .sol.gz file (empty: off)")\
+    STR_PARA( modelCache , '\0'  ,  false    , ""     , "Directory caching the model and its presolved root (empty: off)")\
+    STR_PARA( checkpoint , '\0'  ,  false    , ""     , "Search state kept in this file (empty: off)")\
+    STR_PARA( listen     , '\0'  ,  false    , ""     , "Address worker processes connect to: unix:<path> or <host>:<port>")\
+    STR_PARA( connect    , '\0'  ,  false    , ""     , "Run as a worker process of the coordinator at this address")\
+    STR_PARA( token      , '\0'  ,  false    , ""     , "Secret a worker process must present to the coordinator (empty: none)")
     
 struct paras 
 {
@@ -15,53 +15,48 @@
 =====================================================================================*/
 #include "MIPNode.h"
 
-void MIPNode::DealOptimal(const HighsSolution &_reducedSolution)
+/* Results come with the worker's solution already lifted to the original
+   model and valued, which is done before the tree is locked; empty if it
+   could not be lifted. */
+void MIPNode::DealOptimal(vector<double> &_oriColValue, const double _obj)
 {
-  Postsolve(_reducedSolution);
+  TakeSolution(_oriColValue, _obj);
   Tree_->SetNodeStatus(this, NodeStatus::End);
   RealseModel();
   SetProblemStatus(ProblemStatus::Optimal);
   UpPropagation();
   DownPropagation();
-  if (Obj_ < TreeBestObj_)
-  {
-    TreeBestObj_ = Obj_;
-    TreeBestNode_ = this;
-  }
+  UpdateTreeBest();
 }
 
 void MIPNode::DealInfeasible()
 {
   Tree_->SetNodeStatus(this, NodeStatus::End);
-  RealseModel();
   SetProblemStatus(ProblemStatus::Infeasible);
+  RealseModel();
   UpPropagation();
   DownPropagation();
 }
 
-void MIPNode::DealFeasible(const HighsSolution &_reducedSolution)
+void MIPNode::DealFeasible(vector<double> &_oriColValue, const double _obj)
 {
-  Postsolve(_reducedSolution);
+  TakeSolution(_oriColValue, _obj);
   SetProblemStatus(ProblemStatus::Feasible);
-  if (Obj_ < TreeBestObj_)
-  {
-    TreeBestObj_ = Obj_;
-    TreeBestNode_ = this;
-  }
+  UpdateTreeBest();
 }
 
-void MIPNode::DealEndFeasible(const HighsSolution &_reducedSolution, const double _obj)
+void MIPNode::DealEndFeasible(vector<double> &_oriColValue, const double _obj)
 {
+  // A solution that could not be lifted has already been handed to the
+  // solution pool by the worker.
+  if (_oriColValue.empty())
+    return;
   if (_obj < TreeBestObj_ - 1e-4)
   {
     printf("c %10.2lf    [%-10s]    Node(%ld) [%lf] [%lf] [%lf]\n",
            ElapsedTime(), "End Feas", nodeID_, GetObj(), _obj, TreeBestObj_);
-    Postsolve(_reducedSolution);
-    if (Obj_ < TreeBestObj_)
-    {
-      TreeBestObj_ = Obj_;
-      TreeBestNode_ = this;
-    }
+    TakeSolution(_oriColValue, _obj);
+    UpdateTreeBest();
   }
 }
 
@@ -71,7 +66,120 @@ void MIPNode::DealUnknown()
 
 void MIPNode::RealseModel()
 {
-  highs_.clear();
+  if (inPartition_)
+  {
+    releasePending_ = true;
+    return;
+  }
+  vector<size_t>().swap(shortDegree_);
+  vector<size_t>().swap(varDegree_);
+  vector<char>().swap(varType_);
+  solveDone_ = true;
+  // An ended node is no longer presolved from its parent's model, unless
+  // a worker is presolving it right now.
+  if (baseModel_ != nullptr && !presolving_)
+  {
+    baseModel_ = nullptr;
+    if (parentNode_ != nullptr)
+      parentNode_->ReleaseUnusedModel();
+  }
+  ReleaseUnusedModel();
+  // An infeasible leaf never lifts a solution, so its map can go too.
+  if (IsInfeasible() && leftNode_ == nullptr)
+    ReleaseMap();
+}
+
+void MIPNode::ReleasePresolve()
+{
+  if (modelBytes_ == 0)
+    return;
+  if (presolvingChildNum_ > 0)
+  {
+    presolveReleasePending_ = true;
+    return;
+  }
+  presolve_.Release();
+  vector<double>().swap(warmStart_);
+  Tree_->ReleaseModelBytes(modelBytes_);
+  modelBytes_ = 0;
+}
+
+void MIPNode::ReleaseMap()
+{
+  postsolveMap_.reset();
+  vector<HighsInt>().swap(origColIndex_);
+  vector<double>().swap(hintSolution_);
+}
+
+/* An ended node's subtree is closed, so a HiGHS presolver its map kept
+   for the nodes below it is no longer needed. */
+void MIPNode::CloseMapStep()
+{
+  if (postsolveMap_ != nullptr)
+    postsolveMap_->CloseStep();
+}
+
+/* The reduced model of a node that is neither solved nor split any more
+   goes as soon as no child is still to be presolved from it. Solutions
+   found below are lifted by the children's own maps. */
+void MIPNode::ReleaseUnusedModel()
+{
+  if (modelBytes_ == 0 || inPartition_ ||
+      (!solveDone_ && GetNodeStatus() != NodeStatus::BranchedWaiting))
+    return;
+  if ((leftNode_ != nullptr && leftNode_->baseModel_ != nullptr) ||
+      (rightNode_ != nullptr && rightNode_->baseModel_ != nullptr))
+    return;
+  ReleasePresolve();
+}
+
+/* The worker of a node that has been split has reported; the node is not
+   run again. */
+void MIPNode::EndSolving()
+{
+  solveDone_ = true;
+  ReleaseUnusedModel();
+}
+
+void MIPNode::LinkToParent()
+{
+  if (parentNode_->leftNode_ == nullptr)
+    parentNode_->leftNode_ = this;
+  else
+  {
+    assert(parentNode_->rightNode_ == nullptr);
+    parentNode_->rightNode_ = this;
+  }
+}
+
+void MIPNode::DealParentEnd()
+{
+  DEBUG_PRINT("c %10.2lf    [%-10s]    Node(%ld) %s\n",
+              ElapsedTime(), "Down Prop", nodeID_,
+              ProblemStatusToString(parentNode_->GetProblemStatus()));
+  Tree_->SetNodeStatus(this, NodeStatus::End);
+  Discard();
+  SetProblemStatus(parentNode_->GetProblemStatus());
+}
+
+void MIPNode::Discard()
+{
+  RealseModel();
+  ReleasePresolve();
+  ReleaseMap();
+  Tree_->IncreaseDiscardNum();
+}
+
+void MIPNode::EndPartition()
+{
+  inPartition_ = false;
+  UpdateVarMsg();
+  if (releasePending_)
+  {
+    releasePending_ = false;
+    RealseModel();
+  }
+  ReleaseUnusedModel();
 }
 
 MIPTree *MIPNode::Tree_ = nullptr;
@@ -79,27 +187,41 @@ size_t MIPNode::NODEID_ = 0;
 double MIPNode::TreeBestObj_ = INF;
 MIPNode *MIPNode::TreeBestNode_ = nullptr;
 map<string, size_t> MIPNode::VarBranchInSolved_;
+boost::shared_mutex MIPNode::mutexVarBranchInSolved_;
 boost::mutex MIPNode::mutexNODEID__;
 
 MIPNode::MIPNode(
     const size_t _depth,
     MIPNode *_parent,
-    const HighsModel &_oriModel,
-    const double objCutValue_)
-    : depth_(_depth),
-      parentNode_(_parent),
-      presolve_(_oriModel, Tree_->GetInitDone()),
+    const HighsModel &_baseModel,
+    const vector<BoundChange> &_boundChanges)
+    : worker_(nullptr),
+      presolve_(Tree_->GetInitDone()),
+      depth_(_depth),
       problemStatus_(ProblemStatus::Unknown),
       nodeStatus_(NodeStatus::New),
+      parentNode_(_parent),
       leftNode_(nullptr),
       rightNode_(nullptr),
       varNum_(0),
       conNum_(0),
       nonzeroNum_(0),
+      baseModel_(&_baseModel),
+      boundChanges_(_boundChanges),
+      modelBytes_(0),
+      numaNode_(-1),
+      hintObj_(INF),
       Obj_(INF),
-      worker_(nullptr),
-      objCutValue_(objCutValue_),
-      runningStartTime_(INF)
+      runningStartTime_(INF),
+      inPartition_(false),
+      releasePending_(false),
+      deferred_(false),
+      unpresolved_(false),
+      splitInfeasible_(false),
+      solveDone_(false),
+      presolving_(false),
+      presolvingChildNum_(0),
+      presolveReleasePending_(false)
 {
   {
     boost::mutex::scoped_lock lock(mutexNODEID__);
@@ -120,16 +242,189 @@ MIPNode::~MIPNode()
 
 void MIPNode::ReducedModel()
 {
-  presolve_.PresolveByHighs();
+  if (splitInfeasible_)
+    return;
+  PresolveModel();
+  ApplyPresolve();
+}
+
+/* Everything of the presolve that touches only this node, so that a
+   worker can run it outside the tree lock. */
+void MIPNode::PresolveModel()
+{
+  PhaseTimer timer(IsRoot() ? Phase::RootPresolve : Phase::ChildPresolve, nodeID_);
+  ModelCache *cache = IsRoot() ? Tree_->scheduler_->GetModelCache() : nullptr;
+  if (!IsRoot() && OPT(incrementalPresolve) > 0)
+    presolve_.PresolveIncremental(*baseModel_, boundChanges_, OPT(incrementalPresolve));
+  else if (cache == nullptr || !presolve_.LoadRoot(*cache, *baseModel_))
+  {
+    presolve_.LoadModel(*baseModel_, boundChanges_);
+    presolve_.PresolveByHighs();
+    if (cache != nullptr)
+      presolve_.StoreRoot(*cache);
+  }
+  presolve_.Detach();
+  numaNode_ = Placement::GetCurrentNode();
+}
+
+/* Sizes the node by its reduced model; a deferred node had its parent's
+   sizes until now. Its memory is counted only from here, so that the tree
+   never releases a presolver a worker is still filling. The map is built
+   here too: the parent's is never changed, but a deferred node is
+   presolved outside the tree lock, under which the parent's is released.
+   The parent's model is no longer needed by this node. */
+void MIPNode::ApplyPresolve()
+{
+  baseModel_ = nullptr;
+  deferred_ = false;
+  // Counted before the map takes a kept presolver, which holds a copy of
+  // the parent's model.
+  modelBytes_ = presolve_.GetModelBytes();
+  Tree_->AddModelBytes(modelBytes_);
+  if (IsRoot() || parentNode_->postsolveMap_ != nullptr)
+    postsolveMap_ = PostsolveMap::Build(IsRoot() ? nullptr : parentNode_->postsolveMap_, presolve_);
+  varNum_ = 0;
+  conNum_ = 0;
+  nonzeroNum_ = 0;
+  if (!presolve_.CheckPresolveInfeas() && !presolve_.CheckPresolveOptimal())
+    InitModel();
+}
+
+/* A node whose solution could not be lifted through its presolve is run
+   again on the original model, within the bounds its reduced model gives
+   the columns it kept. Every solution of the reduced model lifts into that
+   region, so its optimum is no worse than the node's, and what is found
+   there needs no lifting. Only for a node not split yet, through
+   MIPTree::UnpresolveNode. */
+void MIPNode::Unpresolve()
+{
+  assert(!unpresolved_ && leftNode_ == nullptr);
+  const HighsLp &lp = presolve_.GetReducedModel().lp_;
+  vector<BoundChange> bounds;
+  for (size_t i = 0; i < origColIndex_.size(); ++i)
+    bounds.push_back({origColIndex_[i], lp.col_lower_[i], lp.col_upper_[i]});
+  ReleasePresolve();
+  presolve_.LoadUnreduced(Tree_->scheduler_->GetRootModel(), bounds);
+  postsolveMap_ = PostsolveMap::Build(nullptr, presolve_);
+  modelBytes_ = presolve_.GetModelBytes();
+  Tree_->AddModelBytes(modelBytes_);
+  vector<double>().swap(hintSolution_);
+  hintObj_ = INF;
+  unpresolved_ = true;
+  InitModel();
+  DEBUG_PRINT("c %10.2lf    [%-10s]    Node(%ld) solution cannot be lifted; run again on the original model\n",
+              ElapsedTime(), "Unpresolve", nodeID_);
+}
+
+/* Propagates the branching bounds over the parent's reduced model before
+   the child is presolved. An infeasible child is never presolved; the
+   integer bounds it tightens are added to the node's bound changes, which
+   the presolve then starts from. Every path that rebuilds a child's model
+   from its branching bound propagates it the same way. */
+void MIPNode::Propagate(Propagator &_propagator)
+{
+  if (OPT(propagate) == 1)
+    splitInfeasible_ = !_propagator.Propagate(boundChanges_);
+}
+
+void MIPNode::Propagate()
+{
+  if (OPT(propagate) == 0)
+    return;
+  Propagator propagator(baseModel_->lp_);
+  Propagate(propagator);
+}
+
+/* Instead of presolving, a child only has its branching bounds propagated
+   at split time; it is presolved by the worker that runs it, if it still
+   matters by then. Until then it is ordered by its parent's size. */
+void MIPNode::Defer()
+{
+  deferred_ = true;
+  varNum_ = parentNode_->varNum_;
+  conNum_ = parentNode_->conNum_;
+  nonzeroNum_ = parentNode_->nonzeroNum_;
+}
+
+/* A deferred node is presolved from its parent's reduced model, which the
+   parent keeps meanwhile even if its subtree ends. Both under the tree
+   lock. */
+void MIPNode::PinParentModel()
+{
+  presolving_ = true;
+  parentNode_->presolvingChildNum_++;
+}
+
+void MIPNode::UnpinParentModel()
+{
+  presolving_ = false;
+  if (--parentNode_->presolvingChildNum_ == 0 && parentNode_->presolveReleasePending_)
+  {
+    parentNode_->presolveReleasePending_ = false;
+    parentNode_->ReleasePresolve();
+  }
+}
+
+bool MIPNode::LiftSolution(vector<double> &_colValue)
+{
+  return postsolveMap_ != nullptr && postsolveMap_->Lift(_colValue);
+}
+
+void MIPNode::SetHintSolution(const vector<double> &_colValue, const double _obj)
+{
+  if (modelBytes_ == 0 || _obj >= hintObj_)
+    return;
+  hintSolution_ = _colValue;
+  hintObj_ = _obj;
+}
+
+/* Map the solution of the nearest ancestor that has one into this node's
+   reduced model. Both nodes know the original column of each of their
+   reduced columns, so the ancestors in between, whose presolve may be gone,
+   are not needed. */
+bool MIPNode::InheritWarmStart()
+{
+  const MIPNode *source = parentNode_;
+  while (source != nullptr && source->hintSolution_.empty())
+    source = source->parentNode_;
+  if (source == nullptr || modelBytes_ == 0 ||
+      source->origColIndex_.size() != source->hintSolution_.size())
+    return false;
+  vector<HighsInt> sourceCol(Tree_->scheduler_->GetRootModel().lp_.num_col_, -1);
+  for (size_t i = 0; i < source->origColIndex_.size(); ++i)
+    sourceCol[source->origColIndex_[i]] = i;
+  warmStart_.resize(origColIndex_.size());
+  for (size_t i = 0; i < origColIndex_.size(); ++i)
+  {
+    if (sourceCol[origColIndex_[i]] < 0)
+    {
+      warmStart_.clear();
+      return false;
+    }
+    warmStart_[i] = source->hintSolution_[sourceCol[origColIndex_[i]]];
+  }
+  return true;
+}
+
+bool MIPNode::TakeWarmStart(vector<double> &_colValue)
+{
+  _colValue.clear();
+  _colValue.swap(warmStart_);
+  return !_colValue.empty();
 }
 
 void MIPNode::Activate()
 {
-  if (CheckPresolveInfeas())
+  if (splitInfeasible_)
+  {
+    SetInfeasible();
     return;
-  if (CheckPresolveOptimal())
+  }
+  if (deferred_)
     return;
-  InitModel();
+  if (CheckPresolveInfeas())
+    return;
+  CheckPresolveOptimal();
 }
 
 vector<MIPNode *> MIPNode::SelectVarToBrach()
@@ -140,13 +435,16 @@ vector<MIPNode *> MIPNode::SelectVarToBrach()
   bestType_ = 'R';
   bestVarBranchInSolved_ = 0;
   candidateVars_.clear();
+  const HighsModel &reducedModel = presolve_.GetReducedModel();
+  const HighsLp &lp = reducedModel.lp_;
+  boost::shared_lock<boost::shared_mutex> lock(mutexVarBranchInSolved_);
   for (size_t idx = 0; idx < varNum_; ++idx)
   {
     const size_t &shortDegree = shortDegree_[idx];
     const size_t &varDegree = varDegree_[idx];
-    const string &varName = highs_.getLp().col_names_[idx];
-    if (highs_.getLp().col_lower_[idx] + 0.5 > highs_.getLp().col_upper_[idx] ||
-        (-INF >= highs_.getLp().col_lower_[idx] || highs_.getLp().col_upper_[idx] >= INF))
+    const string &varName = lp.col_names_[idx];
+    if (lp.col_lower_[idx] + 0.5 > lp.col_upper_[idx] ||
+        (-INF >= lp.col_lower_[idx] || lp.col_upper_[idx] >= INF))
       continue;
     const char &type = varType_[idx];
     size_t varBranchInSolved = 0;
@@ -169,7 +467,7 @@ vector<MIPNode *> MIPNode::SelectVarToBrach()
     {
       const size_t &shortDegree = shortDegree_[idx];
       const size_t &varDegree = varDegree_[idx];
-      const string &varName = highs_.getLp().col_names_[idx];
+      const string &varName = lp.col_names_[idx];
       const char &type = varType_[idx];
       size_t varBranchInSolved = 0;
       const auto it = VarBranchInSolved_.find(varName);
@@ -189,9 +487,9 @@ vector<MIPNode *> MIPNode::SelectVarToBrach()
   assert(bestIndex_ != -1);
   candidateVars_.push_back(bestIndex_);
   bestIndex_ = candidateVars_[rand() % candidateVars_.size()];
-  branchVarName_ = highs_.getLp().col_names_[bestIndex_];
-  const double bestLB = highs_.getLp().col_lower_[bestIndex_];
-  const double bestUB = highs_.getLp().col_upper_[bestIndex_];
+  branchVarName_ = lp.col_names_[bestIndex_];
+  const double bestLB = lp.col_lower_[bestIndex_];
+  const double bestUB = lp.col_upper_[bestIndex_];
   double mid = GetMid(bestLB, bestUB);
   bestType_ = varType_[bestIndex_];
   bestShortDegree_ = shortDegree_[bestIndex_];
@@ -200,79 +498,40 @@ vector<MIPNode *> MIPNode::SelectVarToBrach()
     bestVarBranchInSolved_ = VarBranchInSolved_[branchVarName_];
   else
     bestVarBranchInSolved_ = 0;
+  lock.unlock();
   DEBUG_PRINT("c %10.2lf    [%-10s]    Node(%ld) ---> Var(%s) \
    [ %.2lf | %.2lf | %.2lf ] [ %c | %ld | %ld | %ld ] (#%ld) \n",
               ElapsedTime(), "Branch", nodeID_, branchVarName_.c_str(), bestLB, mid, bestUB,
               bestType_, bestVarBranchInSolved_, bestShortDegree_, bestVarDegree_, candidateVars_.size());
   vector<MIPNode *> newNodes;
-  ObjCut();
-  if (highs_.getLp().integrality_.size() == varNum_ &&
-      highs_.getLp().integrality_[bestIndex_] == HighsVarType::kInteger)
-    highs_.changeColBounds(bestIndex_, bestLB, floor(mid));
-  else
-    highs_.changeColBounds(bestIndex_, bestLB, mid);
-  MIPNode *left = new MIPNode(depth_ + 1, this, highs_.getModel(), objCutValue_);
+  const bool integerVar = lp.integrality_.size() == varNum_ &&
+                          lp.integrality_[bestIndex_] == HighsVarType::kInteger;
+  MIPNode *left = new MIPNode(
+      depth_ + 1, this, reducedModel,
+      {{(HighsInt)bestIndex_, bestLB, integerVar ? floor(mid) : mid}});
   newNodes.push_back(left);
-  this->leftNode_ = left;
-  if (highs_.getLp().integrality_.size() == varNum_ &&
-      highs_.getLp().integrality_[bestIndex_] == HighsVarType::kInteger)
-    highs_.changeColBounds(bestIndex_, ceil(mid), bestUB);
-  else
-    highs_.changeColBounds(bestIndex_, mid, bestUB);
-  MIPNode *right = new MIPNode(depth_ + 1, this, highs_.getModel(), objCutValue_);
+  MIPNode *right = new MIPNode(
+      depth_ + 1, this, reducedModel,
+      {{(HighsInt)bestIndex_, integerVar ? ceil(mid) : mid, bestUB}});
   newNodes.push_back(right);
-  this->rightNode_ = right;
-
-  highs_.changeColBounds(bestIndex_, bestLB, bestUB);
   return newNodes;
 }
 
-void MIPNode::ObjCut()
-{
-  if (Tree_->HaveGlobalIncumbent())
-  {
-    const double incunmbentValue = Tree_->GetGlobalIncumbent();
-    if (incunmbentValue < objCutValue_)
-    {
-      objCutValue_ = incunmbentValue;
-      const vector<double> &col_cost = highs_.getLp().col_cost_;
-      HighsInt num_new_nz = 0;
-      for (HighsInt iCol = 0; iCol < highs_.getNumCol(); iCol++)
-        if (col_cost[iCol] != 0.0)
-          num_new_nz++;
-      HighsInt *indices = new HighsInt[num_new_nz];
-      double *values = new double[num_new_nz];
-      size_t idx = 0;
-      for (HighsInt iCol = 0; iCol < highs_.getNumCol(); iCol++)
-        if (col_cost[iCol] != 0.0)
-        {
-          indices[idx] = iCol;
-          values[idx] = col_cost[iCol];
-          idx++;
-        }
-      assert(idx == num_new_nz);
-      highs_.addRow(-INF, incunmbentValue - highs_.getLp().offset_, num_new_nz, indices, values);
-      DEBUG_PRINT("c %10.2lf    [%-10s]    Node(%ld) [%lf]\n",
-                  ElapsedTime(), "Obj Cut", nodeID_, incunmbentValue);
-      delete[] indices;
-      delete[] values;
-    }
-  }
-}
-
 void MIPNode::InitModel()
 {
-  highs_.setOptionValue("log_to_console", "false");
-  if (Tree_->GetInitDone())
-    highs_.setOptionValue("threads", 1);
-  else
-    highs_.setOptionValue("threads", OPT(threadNum) / 2);
-  highs_.passModel(presolve_.GetReducedModel());
-  varNum_ = highs_.getNumCol();
+  const HighsLp &lp = presolve_.GetReducedModel().lp_;
+  varNum_ = lp.num_col_;
+  const vector<HighsInt> &colIndex = presolve_.GetStepColIndex();
+  origColIndex_.resize(varNum_);
+  for (size_t i = 0; i < varNum_; ++i)
+    origColIndex_[i] = parentNode_ == nullptr || unpresolved_
+                           ? colIndex[i]
+                           : parentNode_->origColIndex_[colIndex[i]];
+  conNum_ = lp.num_row_;
+  nonzeroNum_ = lp.a_matrix_.numNz();
   shortDegree_.resize(varNum_, 0);
   varDegree_.resize(varNum_, 0);
   varType_.resize(varNum_, 'R');
-  const HighsLp &lp = highs_.getLp();
   if (lp.integrality_.size() == varNum_)
     for (size_t i = 0; i < varNum_; ++i)
     {
@@ -281,25 +540,29 @@ void MIPNode::InitModel()
               ? 'I'
               : 'R';
     }
-  conNum_ = highs_.getNumRow();
-  nonzeroNum_ = highs_.getNumNz();
-  for (int i = 0; i < varNum_; i++)
-    varDegree_[i] = lp.a_matrix_.start_[i + 1] - lp.a_matrix_.start_[i];
-  assert(highs_.getLp().a_matrix_.format_ == MatrixFormat::kColwise);
-  highs_.setMatrixFormat(MatrixFormat::kRowwise);
-  assert(highs_.getLp().a_matrix_.format_ == MatrixFormat::kRowwise);
+  if (lp.a_matrix_.isColwise())
+    for (int i = 0; i < varNum_; i++)
+      varDegree_[i] = lp.a_matrix_.start_[i + 1] - lp.a_matrix_.start_[i];
+  else
+    for (size_t k = 0; k < nonzeroNum_; k++)
+      varDegree_[lp.a_matrix_.index_[k]]++;
+}
+
+void MIPNode::SetInfeasible()
+{
+  Tree_->SetNodeStatus(this, NodeStatus::End);
+  SetProblemStatus(ProblemStatus::Infeasible);
+  RealseModel();
+  DEBUG_PRINT("c %10.2lf    [%-10s]    Node(%ld) Presolve Infeasible\n",
+              ElapsedTime(), "End", nodeID_);
+  UpPropagation();
 }
 
 bool MIPNode::CheckPresolveInfeas()
 {
   if (presolve_.CheckPresolveInfeas())
   {
-    Tree_->SetNodeStatus(this, NodeStatus::End);
-    RealseModel();
-    SetProblemStatus(ProblemStatus::Infeasible);
-    DEBUG_PRINT("c %10.2lf    [%-10s]    Node(%ld) Presolve Infeasible\n",
-                ElapsedTime(), "End", nodeID_);
-    UpPropagation();
+    SetInfeasible();
     return true;
   }
   return false;
@@ -310,18 +573,20 @@ bool MIPNode::CheckPresolveOptimal()
   if (presolve_.CheckPresolveOptimal())
   {
     assert(!IsEnd() && varNum_ == 0);
-    Postsolve();
+    Postsolve({});
+    // Not ended as optimal without its solution in the original model.
+    if (oriColValue_.empty())
+    {
+      Tree_->UnpresolveNode(this);
+      return false;
+    }
     Tree_->SetNodeStatus(this, NodeStatus::End);
     RealseModel();
     SetProblemStatus(ProblemStatus::Optimal);
     DEBUG_PRINT("c %10.2lf    [%-10s]    Node(%ld) Presolve Optimal\n",
                 ElapsedTime(), "End", nodeID_);
     UpPropagation();
-    if (Obj_ < TreeBestObj_)
-    {
-      TreeBestObj_ = Obj_;
-      TreeBestNode_ = this;
-    }
+    UpdateTreeBest();
     return true;
   }
   return false;
@@ -374,6 +639,8 @@ void MIPNode::DownPropagation()
     if (leftNode_->GetNodeStatus() == NodeStatus::Running ||
         leftNode_->GetNodeStatus() == NodeStatus::BranchedRunning)
       leftNode_->worker_->EndRunning();
+    if (leftNode_->GetNodeStatus() == NodeStatus::Waiting)
+      leftNode_->Discard();
     Tree_->SetNodeStatus(leftNode_, NodeStatus::End);
     leftNode_->SetProblemStatus(problemStatus_);
     leftNode_->DownPropagation();
@@ -386,12 +653,16 @@ void MIPNode::DownPropagation()
     if (rightNode_->GetNodeStatus() == NodeStatus::Running ||
         rightNode_->GetNodeStatus() == NodeStatus::BranchedRunning)
       rightNode_->worker_->EndRunning();
+    if (rightNode_->GetNodeStatus() == NodeStatus::Waiting)
+      rightNode_->Discard();
     Tree_->SetNodeStatus(rightNode_, NodeStatus::End);
     rightNode_->SetProblemStatus(problemStatus_);
     rightNode_->DownPropagation();
   }
 }
 
+/* Ancestors only take the objective; the solution itself stays on the
+   best node, already in the original model. */
 void MIPNode::SolPropagation()
 {
   MIPNode *now = this;
@@ -407,7 +678,6 @@ void MIPNode::SolPropagation()
       if (!parent->IsOptimal())
         parent->SetProblemStatus(ProblemStatus::Feasible);
       parent->Obj_ = tempObj;
-      parent->Postsolve(now->presolve_.GetOriSolution());
       now = parent;
       parent = parent->parentNode_;
     }
@@ -416,24 +686,54 @@ void MIPNode::SolPropagation()
   }
 }
 
-void MIPNode::Postsolve()
+/* Lifts a solution of the reduced model to the original one, whose
+   objective it is then valued by. */
+void MIPNode::Postsolve(const vector<double> &_colValue)
 {
-  presolve_.PostSolveByHighs();
-  Obj_ = presolve_.GetOriObj();
-  DEBUG_PRINT("c %10.2lf    [%-10s]    Node(%ld) [%lf]\n",
-              ElapsedTime(), "UPDATE OBJ", nodeID_, GetObj());
+  vector<double> oriColValue = _colValue;
+  if (!LiftSolution(oriColValue))
+    oriColValue.clear();
+  TakeSolution(oriColValue, oriColValue.empty() ? INF : OriginalObj(oriColValue));
+}
+
+/* In the model's sense, as SCIP reports objectives and the tree keeps
+   them. */
+double MIPNode::OriginalObj(const vector<double> &_oriColValue)
+{
+  const HighsLp &lp = Tree_->scheduler_->GetRootModel().lp_;
+  double obj = lp.offset_;
+  for (HighsInt i = 0; i < lp.num_col_; ++i)
+    obj += lp.col_cost_[i] * _oriColValue[i];
+  return obj;
 }
 
-void MIPNode::Postsolve(const HighsSolution &_reducedSolution)
+void MIPNode::TakeSolution(vector<double> &_oriColValue, const double _obj)
 {
-  presolve_.PostSolveByHighs(_reducedSolution);
-  Obj_ = presolve_.GetOriObj();
+  oriColValue_.swap(_oriColValue);
+  if (oriColValue_.empty())
+    return;
+  Obj_ = _obj;
   DEBUG_PRINT("c %10.2lf    [%-10s]    Node(%ld) [%lf]\n",
               ElapsedTime(), "UPDATE OBJ", nodeID_, GetObj());
 }
 
+/* Only the tree's best node keeps its solution in the original model. */
+void MIPNode::UpdateTreeBest()
+{
+  if (Obj_ < TreeBestObj_)
+  {
+    if (TreeBestNode_ != nullptr && TreeBestNode_ != this)
+      vector<double>().swap(TreeBestNode_->oriColValue_);
+    TreeBestObj_ = Obj_;
+    TreeBestNode_ = this;
+  }
+  else if (TreeBestNode_ != this)
+    vector<double>().swap(oriColValue_);
+}
+
 void MIPNode::IncreaseVarBranchInSolved()
 {
+  boost::unique_lock<boost::shared_mutex> lock(mutexVarBranchInSolved_);
   if (VarBranchInSolved_.find(branchVarName_) != VarBranchInSolved_.end())
     VarBranchInSolved_[branchVarName_] += 1;
   else
@@ -445,6 +745,7 @@ void MIPNode::IncreaseVarBranchInSolved()
 
 void MIPNode::UpdateVarMsg()
 {
+  boost::unique_lock<boost::shared_mutex> lock(mutexVarBranchInSolved_);
   if (VarBranchInSolved_.find(branchVarName_) != VarBranchInSolved_.end() &&
       VarBranchInSolved_[branchVarName_] > 0)
   {
@@ -454,3 +755,56 @@ void MIPNode::UpdateVarMsg()
                 VarBranchInSolved_[branchVarName_]);
   }
 }
+
+/* Gives a node rebuilt from a checkpoint its saved state. An ended node
+   is not presolved again; an open one must come out of presolve as it
+   did when the checkpoint was taken. */
+bool MIPNode::Restore(const CheckpointNode &_record)
+{
+  if (parentNode_ != nullptr)
+  {
+    if (boundChanges_.empty() || boundChanges_[0].col < 0 ||
+        boundChanges_[0].col >= (HighsInt)parentNode_->varNum_)
+      return false;
+    parentNode_->branchVarName_ =
+        parentNode_->presolve_.GetReducedModel().lp_.col_names_[boundChanges_[0].col];
+  }
+  if (_record.end)
+  {
+    baseModel_ = nullptr;
+    Tree_->SetNodeStatus(this, NodeStatus::End);
+    SetProblemStatus(_record.problemStatus);
+    Obj_ = _record.obj;
+    return true;
+  }
+  // Saved before its presolve: whatever presolve makes of it now is as
+  // good, and RestoreNodes activates it once the tree is linked.
+  if (_record.varNum == 0 && _record.conNum == 0 && _record.nonzeroNum == 0)
+    return modelBytes_ > 0;
+  return modelBytes_ > 0 &&
+         !presolve_.CheckPresolveInfeas() && !presolve_.CheckPresolveOptimal() &&
+         varNum_ == _record.varNum && conNum_ == _record.conNum &&
+         nonzeroNum_ == _record.nonzeroNum;
+}
+
+void MIPNode::ReleaseSubtree()
+{
+  ReleasePresolve();
+  ReleaseMap();
+  if (leftNode_ != nullptr)
+    leftNode_->ReleaseSubtree();
+  if (rightNode_ != nullptr)
+    rightNode_->ReleaseSubtree();
+}
+
+map<string, size_t> MIPNode::GetVarBranchInSolved()
+{
+  boost::shared_lock<boost::shared_mutex> lock(mutexVarBranchInSolved_);
+  return VarBranchInSolved_;
+}
+
+void MIPNode::SetVarBranchInSolved(const map<string, size_t> &_varBranchInSolved)
+{
+  boost::unique_lock<boost::shared_mutex> lock(mutexVarBranchInSolved_);
+  VarBranchInSolved_ = _varBranchInSolved;
+}
@@ -20,29 +20,70 @@ boost::mutex MIPTree::mutexTempNewNodes_;
 
 bool LaunchStart = false;
 
-void *Global_ActivateNode(void *arg)
+ThreadPool *MIPTree::threadPool_ = nullptr;
+
+void Global_ActivateNode(MIPNode *node)
 {
-  MIPNode *node = (MIPNode *)arg;
   node->ReducedModel();
-  return nullptr;
 }
 
-void *Global_PartitionNode(void *arg)
+void Global_PartitionNode(MIPNode *node)
 {
-  MIPNode *node = (MIPNode *)arg;
+  PhaseTimer timer(Phase::Partition, node->GetNodeID());
   DEBUG_PRINT("c %10.2lf    [%-10s]    Partition Node(%ld) \n",
               ElapsedTime(), "Partition", node->GetNodeID());
   vector<MIPNode *> newNodes = node->SelectVarToBrach();
-  MIPTree::ActivateNodes(newNodes);
+  if (OPT(propagate) == 1)
+  {
+    Propagator propagator(node->GetModelToSolve().lp_);
+    for (MIPNode *newNode : newNodes)
+      newNode->Propagate(propagator);
+  }
+  // The initial partition splits its children again at once, so they are
+  // presolved here; later children are left to their workers.
+  if (OPT(lazyPresolve) == 1 && MIPNode::Tree_->GetInitDone())
+    for (MIPNode *newNode : newNodes)
+      newNode->Defer();
+  else
+    MIPTree::ActivateNodes(newNodes);
   MIPTree::InsertTempNewNodes(newNodes);
-  return nullptr;
 }
 
 void MIPTree::InsertTempNewNodes(const vector<MIPNode *> &_newNodes)
 {
-  boost::mutex::scoped_lock lock(mutexTempNewNodes_);
-  for (MIPNode *node : _newNodes)
-    tempNewNodes_.push_back(node);
+  {
+    boost::mutex::scoped_lock lock(mutexTempNewNodes_);
+    for (MIPNode *node : _newNodes)
+      tempNewNodes_.push_back(node);
+  }
+  MIPNode::Tree_->scheduler_->Notify();
+}
+
+void MIPTree::PublishNewNodes()
+{
+  vector<MIPNode *> newNodes;
+  {
+    boost::mutex::scoped_lock lock(mutexTempNewNodes_);
+    newNodes.swap(tempNewNodes_);
+  }
+  for (MIPNode *node : newNodes)
+    node->LinkToParent();
+  for (MIPNode *node : newNodes)
+    if (node->GetParentNode()->GetLeftNode() == node)
+    {
+      node->GetParentNode()->EndPartition();
+      partitionNum_--;
+    }
+  for (MIPNode *node : newNodes)
+  {
+    if (node->IsDeferred())
+      deferNum_++;
+    if (node->GetParentNode()->IsEnd())
+      node->DealParentEnd();
+    else
+      node->Activate();
+    InsertWaitingNodes(node);
+  }
 }
 
 MIPTree::MIPTree()
@@ -51,34 +92,194 @@ MIPTree::MIPTree()
       solveTime_(INF),
       scheduler_(nullptr),
       rootNode_(nullptr),
-      informWorkerNum_(0)
+      informWorkerNum_(0),
+      partitionNum_(0),
+      speculativeNum_(0),
+      discardNum_(0),
+      deferNum_(0),
+      lazyPresolveNum_(0),
+      unpresolveNum_(0),
+      deferredRunningNum_(0),
+      warmStartNum_(0),
+      numaLocalNum_(0),
+      numaRemoteNum_(0),
+      modelBytes_(0),
+      modelNum_(0),
+      peakModelBytes_(0),
+      peakModelNum_(0),
+      maxNodeBytes_(0),
+      resume_(nullptr),
+      resumedObj_(INF)
 {
   MIPNode::Tree_ = this;
+  // Before the partition pool starts its threads.
+  Placement::Init(OPT(threadNum));
+  threadPool_ = new ThreadPool(OPT(poolThreadNum) > 0 ? OPT(poolThreadNum) : coreNum_);
 }
 
 MIPTree::~MIPTree()
 {
   delete rootNode_;
+  delete threadPool_;
+  threadPool_ = nullptr;
 }
 
 void MIPTree::BuildRootNode()
 {
-  rootNode_ = new MIPNode(1, nullptr, scheduler_->GetRootModel(), INF);
+  rootNode_ = new MIPNode(1, nullptr, scheduler_->GetRootModel(), {});
   rootNode_->ReducedModel();
   rootNode_->Activate();
   InsertWaitingNodes(rootNode_);
   if (!waitingNodes_.empty())
   {
-    MIPNode *selectedNode = SelectWaitingNodeToBranch();
-    vector<MIPNode *> newNodes = selectedNode->SelectVarToBrach();
-    selectedNode->UpdateVarMsg();
-    ActivateNodes(newNodes);
-    for (MIPNode *node : newNodes)
+    PhaseTimer timer(Phase::InitPartition);
+    PartitionNodes({SelectWaitingNodeToBranch()});
+    PublishNewNodes();
+  }
+}
+
+/* A root taken from the model cache still has to be presolved by HiGHS
+   before its solutions can be postsolved. That runs on the pool while the
+   first nodes are partitioned, rather than on the first lift. */
+void MIPTree::PresolveCachedRoot()
+{
+  shared_ptr<const PostsolveMap> map = rootNode_->GetPostsolveMap();
+  if (map != nullptr && scheduler_->GetModelCache() != nullptr)
+    threadPool_->Submit(rootMapGroup_, [map]
+                        { map->PresolvePending(); });
+}
+
+/* Rebuilds the open part of a checkpointed tree. The records are in
+   breadth-first order, so each batch of records whose parents are built
+   is presolved on the pool at once. Open leaves wait to be dispatched;
+   open inner nodes wait for their children, as after a partition. */
+bool MIPTree::RestoreNodes()
+{
+  const vector<CheckpointNode> &records = resume_->nodes;
+  if (records[0].parent != -1)
+    return false;
+  vector<MIPNode *> nodes(records.size(), nullptr);
+  rootNode_ = new MIPNode(1, nullptr, scheduler_->GetRootModel(), {});
+  rootNode_->ReducedModel();
+  nodes[0] = rootNode_;
+  bool ok = rootNode_->Restore(records[0]);
+  size_t begin = 1;
+  while (ok && begin < records.size())
+  {
+    size_t end = begin;
+    while (end < records.size() && records[end].parent >= 0 && records[end].parent < (long long)begin)
+      end++;
+    if (end == begin)
+    {
+      ok = false;
+      break;
+    }
+    vector<MIPNode *> openNodes;
+    for (size_t i = begin; i < end; ++i)
+    {
+      MIPNode *parent = nodes[records[i].parent];
+      if (parent->IsEnd() || parent->GetRightNode() != nullptr)
+      {
+        ok = false;
+        break;
+      }
+      nodes[i] = new MIPNode(parent->GetDepth() + 1, parent, parent->GetModelToSolve(), {records[i].change});
+      nodes[i]->LinkToParent();
+      nodes[i]->Propagate();
+      if (!records[i].end)
+        openNodes.push_back(nodes[i]);
+    }
+    if (!ok)
+      break;
+    ActivateNodes(openNodes);
+    for (size_t i = begin; ok && i < end; ++i)
+      ok = nodes[i]->Restore(records[i]);
+    begin = end;
+  }
+  for (size_t i = 0; ok && i < records.size(); ++i)
+    ok = records[i].end || nodes[i]->GetLeftNode() == nullptr || nodes[i]->GetRightNode() != nullptr;
+  // Nodes saved before their presolve may come out of it ended.
+  for (size_t i = 0; ok && i < records.size(); ++i)
+    if (!records[i].end && !nodes[i]->IsEnd() && records[i].varNum == 0 &&
+        records[i].conNum == 0 && records[i].nonzeroNum == 0)
+      nodes[i]->Activate();
+  if (!ok)
+  {
+    rootNode_->ReleaseSubtree();
+    delete rootNode_;
+    rootNode_ = nullptr;
+    endNodes_.clear();
+    return false;
+  }
+  size_t leafNum = 0, innerNum = 0, endNum = 0;
+  for (MIPNode *node : nodes)
+    if (node->IsEnd())
+      endNum++;
+    else if (node->GetLeftNode() != nullptr)
+    {
+      SetNodeStatus(node, NodeStatus::BranchedWaiting);
+      node->ReleaseUnusedModel();
+      innerNum++;
+    }
+    else
     {
-      node->Activate();
       InsertWaitingNodes(node);
+      leafNum++;
+    }
+  MIPNode::SetVarBranchInSolved(resume_->varBranchInSolved);
+  printf("c Checkpoint: resumed %ld open leaves, %ld open inner nodes and %ld ended subtrees after %.2lf s of search\n",
+         leafNum, innerNum, endNum, resume_->searchTime);
+  return true;
+}
+
+/* The checkpoint's incumbent is ranked minimised, like the pool's. */
+void MIPTree::SetResume(const Checkpoint *_checkpoint)
+{
+  resume_ = _checkpoint;
+  if (resume_->incumbent.empty())
+    return;
+  resumedSolution_ = resume_->incumbent;
+  resumedObj_ = (HighsInt)scheduler_->GetRootModel().lp_.sense_ * resume_->incumbentObj;
+  MIPNode::TreeBestObj_ = min(MIPNode::TreeBestObj_, resumedObj_);
+}
+
+/* Records the tree as it stands under the tree lock. Children that are
+   still being partitioned, or split from an unpresolved node, are left
+   out; their parent is saved as a leaf. */
+bool MIPTree::Snapshot(Checkpoint &_checkpoint)
+{
+  boost::mutex::scoped_lock lock(mutexTree_);
+  if (rootNode_ == nullptr)
+    return false;
+  _checkpoint.nodes.clear();
+  // Each node is queued with the queue index of its parent.
+  vector<pair<const MIPNode *, long long>> queue = {{rootNode_, -1}};
+  for (size_t i = 0; i < queue.size(); ++i)
+  {
+    const MIPNode *node = queue[i].first;
+    CheckpointNode record;
+    record.parent = queue[i].second;
+    record.change = {-1, 0, 0};
+    if (node->GetParent() != nullptr)
+      record.change = node->GetBoundChanges()[0];
+    record.end = node->IsEnd();
+    record.problemStatus = node->GetProblemStatus();
+    record.obj = node->GetObj();
+    // A deferred node's sizes are its parent's; zero marks it unpresolved.
+    record.varNum = node->IsDeferred() ? 0 : node->GetVarNum();
+    record.conNum = node->IsDeferred() ? 0 : node->GetConNum();
+    record.nonzeroNum = node->IsDeferred() ? 0 : node->GetNonzeroNum();
+    _checkpoint.nodes.push_back(record);
+    // The children of an unpresolved node branch on the original model,
+    // which a restored node, presolved again, is not.
+    if (!node->IsEnd() && !node->IsUnpresolved() && node->GetLeftNode() != nullptr && node->GetRightNode() != nullptr)
+    {
+      queue.push_back({node->GetLeftNode(), (long long)i});
+      queue.push_back({node->GetRightNode(), (long long)i});
     }
   }
+  _checkpoint.varBranchInSolved = MIPNode::GetVarBranchInSolved();
+  return true;
 }
 
 void MIPTree::InsertWaitingNodes(MIPNode *_mipNode)
@@ -113,10 +314,17 @@ MIPNode *MIPTree::SelectWaitingNodeToBranch()
   return selectedNode;
 }
 
+/* A running node its worker is still presolving cannot be split yet;
+   nullptr if every running node is such a node. */
 MIPNode *MIPTree::SelectRunningNodeToBranch()
 {
   assert(!runningNodes_.empty());
-  MIPNode *selectedNode = *(runningNodes_.begin());
+  auto it = runningNodes_.begin();
+  while (it != runningNodes_.end() && (*it)->IsDeferred())
+    ++it;
+  if (it == runningNodes_.end())
+    return nullptr;
+  MIPNode *selectedNode = *it;
   assert(selectedNode->GetNodeStatus() == NodeStatus::Running);
   SetNodeStatus(selectedNode, NodeStatus::BranchedRunning);
   DEBUG_PRINT("c %10.2lf    [%-10s]    Running Node(%ld)\n",
@@ -126,19 +334,25 @@ MIPNode *MIPTree::SelectRunningNodeToBranch()
 
 void MIPTree::ActivateNodes(const vector<MIPNode *> &_newNodes)
 {
-  pthread_t *activatePtr = new pthread_t[_newNodes.size()];
-  for (size_t i = 0; i < _newNodes.size(); ++i)
-    pthread_create(&activatePtr[i], NULL, Global_ActivateNode, _newNodes[i]);
-  for (size_t i = 0; i < _newNodes.size(); ++i)
-    pthread_join(activatePtr[i], NULL);
-  delete[] activatePtr;
+  TaskGroup group;
+  for (MIPNode *node : _newNodes)
+    threadPool_->Submit(group, [node]
+                        { Global_ActivateNode(node); });
+  threadPool_->Wait(group);
 }
 
 void MIPTree::BuildInitNodes()
 {
   boost::mutex::scoped_lock lock(mutexTree_);
   auto t1 = chrono::high_resolution_clock::now();
-  BuildRootNode();
+  if (resume_ == nullptr || !RestoreNodes())
+  {
+    if (resume_ != nullptr)
+      printf("c Checkpoint: the tree does not replay on this model; starting afresh\n");
+    BuildRootNode();
+  }
+  PresolveCachedRoot();
+  PhaseTimer timer(Phase::InitPartition);
   size_t totalNodes = coreNum_ * 0.5;
   while (
       !scheduler_->IsRootWorkerDone() &&
@@ -153,13 +367,8 @@ void MIPTree::BuildInitNodes()
       selectNodes.push_back(SelectWaitingNodeToBranch());
     DEBUG_PRINT("c %10.2lf    [%-10s]    Partition %ld nodes, remaining %ld nodes in waiting.\n",
                 ElapsedTime(), "Init Parti", selectNodes.size(), waitingNodes_.size());
-    tempNewNodes_.clear();
     PartitionNodes(selectNodes);
-    for (MIPNode *node : tempNewNodes_)
-    {
-      node->Activate();
-      InsertWaitingNodes(node);
-    }
+    PublishNewNodes();
   }
   auto t2 = chrono::high_resolution_clock::now();
   DEBUG_PRINT("c %10.2lf    [%-10s]    [%ld]\n",
@@ -167,18 +376,59 @@ void MIPTree::BuildInitNodes()
   if (rootNode_->IsEnd())
     solveTime_ = ElapsedTime();
   initDone_ = true;
+  scheduler_->Notify();
 }
 
 void MIPTree::PartitionNodes(const vector<MIPNode *> &_selectNodes)
 {
-  pthread_t *partitionPtr = new pthread_t[_selectNodes.size()];
-  for (size_t i = 0; i < _selectNodes.size(); ++i)
-    pthread_create(&partitionPtr[i], NULL, Global_PartitionNode, _selectNodes[i]);
-  for (size_t i = 0; i < _selectNodes.size(); ++i)
-    pthread_join(partitionPtr[i], NULL);
-  delete[] partitionPtr;
+  TaskGroup group;
   for (MIPNode *node : _selectNodes)
-    node->UpdateVarMsg();
+  {
+    node->StartPartition();
+    partitionNum_++;
+    threadPool_->Submit(group, [node]
+                        { Global_PartitionNode(node); });
+  }
+  threadPool_->Wait(group);
+}
+
+void MIPTree::PartitionNodesAsync(const vector<MIPNode *> &_selectNodes)
+{
+  for (MIPNode *node : _selectNodes)
+  {
+    node->StartPartition();
+    partitionNum_++;
+    threadPool_->Submit(partitionGroup_, [node]
+                        { Global_PartitionNode(node); });
+  }
+}
+
+void MIPTree::PartitionAhead()
+{
+  if (OPT(partitionAhead) == 0 || !initDone_ || IsEnd())
+    return;
+  vector<MIPNode *> selectNodes;
+  while (!runningNodes_.empty() &&
+         waitingNodes_.size() + (partitionNum_ + selectNodes.size()) * 2 < (size_t)OPT(partitionAhead))
+  {
+    MIPNode *selectNode = SelectRunningNodeToBranch();
+    if (selectNode == nullptr)
+      break;
+    selectNodes.push_back(selectNode);
+  }
+  if (selectNodes.empty())
+    return;
+  DEBUG_PRINT("c %10.2lf    [%-10s]    Partition %ld nodes, %ld nodes in waiting, %ld partitioning.\n",
+              ElapsedTime(), "Ahead Parti", selectNodes.size(), waitingNodes_.size(), (size_t)partitionNum_);
+  speculativeNum_ += selectNodes.size() * 2;
+  PartitionNodesAsync(selectNodes);
+}
+
+void MIPTree::WaitPartition()
+{
+  threadPool_->Wait(partitionGroup_);
+  boost::mutex::scoped_lock lock(mutexTree_);
+  PublishNewNodes();
 }
 
 vector<MIPNode *> MIPTree::GetInitNodesToRun()
@@ -202,6 +452,35 @@ vector<MIPNode *> MIPTree::GetInitNodesToRun()
   return initNodes;
 }
 
+/* A node whose worker was lost before it reported goes back to waiting;
+   one that has been split since waits for its children instead. */
+void MIPTree::RequeueNode(MIPNode *_node)
+{
+  boost::mutex::scoped_lock lock(mutexTree_);
+  _node->SetWorker(nullptr);
+  if (_node->GetNodeStatus() == NodeStatus::Running)
+    InsertWaitingNodes(_node);
+  else if (_node->GetNodeStatus() == NodeStatus::BranchedRunning)
+    SetNodeStatus(_node, NodeStatus::BranchedWaiting);
+}
+
+/* Runs a node again on the original model. Its sizes, which order the
+   queue it is in, change, so it leaves the queue meanwhile. */
+void MIPTree::UnpresolveNode(MIPNode *_node)
+{
+  const NodeStatus status = _node->GetNodeStatus();
+  if (status == NodeStatus::Waiting)
+    waitingNodes_.erase(_node);
+  else if (status == NodeStatus::Running)
+    runningNodes_.erase(_node);
+  _node->Unpresolve();
+  if (status == NodeStatus::Waiting)
+    waitingNodes_.insert(_node);
+  else if (status == NodeStatus::Running)
+    runningNodes_.insert(_node);
+  unpresolveNum_++;
+}
+
 void MIPTree::SetNodeStatus(MIPNode *_node, NodeStatus _nodeStatus)
 {
   if (_node->GetNodeStatus() == _nodeStatus)
@@ -217,6 +496,8 @@ void MIPTree::SetNodeStatus(MIPNode *_node, NodeStatus _nodeStatus)
   case NodeStatus::Running:
     // assert(runningNodes_.find(_node) != runningNodes_.end());
     runningNodes_.erase(_node);
+    if (_node->IsDeferred())
+      deferredRunningNum_--;
     break;
   case NodeStatus::BranchedWaiting:
     // assert(branchedWaitingNodes_.find(_node) != branchedWaitingNodes_.end());
@@ -233,6 +514,7 @@ void MIPTree::SetNodeStatus(MIPNode *_node, NodeStatus _nodeStatus)
     break;
   }
   _node->SetNodeStatus(_nodeStatus);
+  Profiler::TraceInstant("node", NodeStatusToString(_nodeStatus), _node->GetNodeID());
   switch (_nodeStatus)
   {
   case NodeStatus::New:
@@ -244,6 +526,8 @@ void MIPTree::SetNodeStatus(MIPNode *_node, NodeStatus _nodeStatus)
   case NodeStatus::Running:
     _node->SetRunningStartTime();
     runningNodes_.insert(_node);
+    if (_node->IsDeferred())
+      deferredRunningNum_++;
     break;
   case NodeStatus::BranchedWaiting:
     branchedWaitingNodes_.insert(_node);
@@ -253,58 +537,73 @@ void MIPTree::SetNodeStatus(MIPNode *_node, NodeStatus _nodeStatus)
     break;
   case NodeStatus::End:
     endNodes_.insert(_node);
+    _node->CloseMapStep();
     break;
   default:
     break;
   }
   if (rootNode_ == _node && _nodeStatus == NodeStatus::End)
+  {
     solveTime_ = ElapsedTime();
+    scheduler_->Notify();
+  }
 }
 
-MIPNode *MIPTree::GetNodeToRun()
+/* Given the NUMA node of the taker, a node presolved on it comes first
+   among the best few waiting nodes, so a subtree tends to stay on the
+   socket whose memory holds its models. */
+MIPNode *MIPTree::GetNodeToRun(const int _numaNode)
 {
   boost::mutex::scoped_lock lock(mutexTree_);
   if (IsEnd() || scheduler_->IsRootWorkerDone() ||
       OPT(cutoff) < ElapsedTime() + 10)
     return nullptr;
+  PublishNewNodes();
+  if (IsEnd())
+    return nullptr;
   MIPNode *resNode = nullptr;
   bool success = false;
-  if (!waitingNodes_.empty())
-  {
-    resNode = *(waitingNodes_.begin());
-    SetNodeStatus(resNode, NodeStatus::Running);
-    success = true;
-  }
-  else
+  if (waitingNodes_.empty() && !runningNodes_.empty())
   {
-    while (waitingNodes_.empty() && !runningNodes_.empty())
+    vector<MIPNode *> selectNodes;
+    auto idleNum_ = scheduler_->GetIdleWorkerNum();
+    while (!runningNodes_.empty() &&
+           (partitionNum_ + selectNodes.size()) * 2 < idleNum_)
     {
-      vector<MIPNode *> selectNodes;
-      auto idleNum_ = scheduler_->GetIdleWorkerNum();
-      while (!runningNodes_.empty() &&
-             selectNodes.size() * 2 < idleNum_)
-        selectNodes.push_back(SelectRunningNodeToBranch());
-      DEBUG_PRINT("c %10.2lf    [%-10s]    Partition %ld nodes, remaining %ld nodes in running, %ld inform, %ld idle.\n",
-                  ElapsedTime(), "Dyna Parti", selectNodes.size(), runningNodes_.size(), (size_t)informWorkerNum_, idleNum_);
-      tempNewNodes_.clear();
-      PartitionNodes(selectNodes);
-      for (MIPNode *node : tempNewNodes_)
-      {
-        node->Activate();
-        InsertWaitingNodes(node);
-      }
+      MIPNode *selectNode = SelectRunningNodeToBranch();
+      if (selectNode == nullptr)
+        break;
+      selectNodes.push_back(selectNode);
     }
-    if (!waitingNodes_.empty())
+    DEBUG_PRINT("c %10.2lf    [%-10s]    Partition %ld nodes, remaining %ld nodes in running, %ld partitioning, %ld idle.\n",
+                ElapsedTime(), "Dyna Parti", selectNodes.size(), runningNodes_.size(), (size_t)partitionNum_, idleNum_);
+    PartitionNodesAsync(selectNodes);
+  }
+  if (!waitingNodes_.empty())
+  {
+    resNode = *(waitingNodes_.begin());
+    if (_numaNode >= 0)
     {
-      resNode = *(waitingNodes_.begin());
-      SetNodeStatus(resNode, NodeStatus::Running);
-      success = true;
+      size_t seen = 0;
+      for (auto it = waitingNodes_.begin(); it != waitingNodes_.end() && seen < 8; ++it, ++seen)
+        if ((*it)->GetNumaNode() == _numaNode)
+        {
+          resNode = *it;
+          break;
+        }
     }
+    SetNodeStatus(resNode, NodeStatus::Running);
+    if (resNode->InheritWarmStart())
+      warmStartNum_++;
+    if (_numaNode >= 0 && resNode->GetNumaNode() >= 0)
+      (resNode->GetNumaNode() == _numaNode ? numaLocalNum_ : numaRemoteNum_)++;
+    success = true;
   }
+  PartitionAhead();
   if (success)
     DEBUG_PRINT("c %10.2lf    [%-10s]    Send Node(%ld) to run, remaining %ld nodes in waiting, %ld inform.\n",
                 ElapsedTime(), "Run", (resNode)->GetNodeID(), waitingNodes_.size(), (size_t)informWorkerNum_);
-  else
+  else if (partitionNum_ == 0 && deferredRunningNum_ == 0)
   {
     DEBUG_PRINT("c %10.2lf    [%-10s]    no nodes in waiting and waitrunning.\n",
                 ElapsedTime(), "NOTHING");
@@ -322,33 +621,94 @@ MIPNode *MIPTree::GetNodeToRun()
   return resNode;
 }
 
+/* Presolves a deferred node on the thread of the worker about to solve
+   it. The presolve itself runs outside the tree lock: nothing else reads a
+   deferred node's model, the node is not split before it is done, and its
+   parent keeps the reduced model it is presolved from. Its sizes change
+   under the lock, where it is resorted among the running nodes. False if
+   the node ended, in presolve or while presolving. */
+bool MIPTree::PresolveNode(MIPNode *_node)
+{
+  {
+    boost::mutex::scoped_lock lock(mutexTree_);
+    if (_node->IsEnd())
+      return false;
+    _node->PinParentModel();
+  }
+  _node->PresolveModel();
+  boost::mutex::scoped_lock lock(mutexTree_);
+  _node->UnpinParentModel();
+  const bool running = _node->GetNodeStatus() == NodeStatus::Running;
+  if (running)
+  {
+    runningNodes_.erase(_node);
+    deferredRunningNum_--;
+  }
+  _node->ApplyPresolve();
+  _node->GetParentNode()->ReleaseUnusedModel();
+  if (running)
+    runningNodes_.insert(_node);
+  lazyPresolveNum_++;
+  scheduler_->Notify();
+  if (_node->IsEnd())
+  {
+    _node->ReleasePresolve();
+    return false;
+  }
+  _node->Activate();
+  if (_node->IsEnd())
+    return false;
+  if (_node->InheritWarmStart())
+    warmStartNum_++;
+  return true;
+}
+
+/* Only the bookkeeping of a result runs under the tree lock: the solution
+   comes lifted by LiftNodeSolution. */
 void MIPTree::InformNodeResult(
     MIPNode *_node, const HighsModelStatus &_status,
-    bool _haveIncumbent, const HighsSolution &_reducedSolution, double _obj)
+    bool _haveIncumbent, vector<double> &_oriColValue,
+    const double _obj)
 {
   boost::mutex::scoped_lock lock(mutexTree_);
   if (_node->IsEnd())
   {
-    _node->RealseModel();
     if (_haveIncumbent)
-      _node->DealEndFeasible(_reducedSolution, _obj);
+      _node->DealEndFeasible(_oriColValue, _obj);
+    _node->RealseModel();
     return;
   }
-  if (_status == HighsModelStatus::kOptimal)
-    _node->DealOptimal(_reducedSolution);
-  else if (_status == HighsModelStatus::kInfeasible ||
-           _status == HighsModelStatus::kUnboundedOrInfeasible)
+  const bool cutOff = _status == HighsModelStatus::kInfeasible ||
+                      _status == HighsModelStatus::kUnboundedOrInfeasible;
+  // A node is never ended, nor valued, by a solution that could not be
+  // lifted to the original model. One not split yet is queued again to
+  // run on the original model; a split one is settled by its children.
+  if (!cutOff && (_status == HighsModelStatus::kOptimal || _haveIncumbent) && _oriColValue.empty())
+  {
+    if (_node->GetNodeStatus() == NodeStatus::Running)
+    {
+      UnpresolveNode(_node);
+      InsertWaitingNodes(_node);
+      return;
+    }
+    _node->DealUnknown();
+  }
+  else if (_status == HighsModelStatus::kOptimal)
+    _node->DealOptimal(_oriColValue, _obj);
+  else if (cutOff)
     _node->DealInfeasible();
   else if (_haveIncumbent)
   {
     assert(_status == HighsModelStatus::kTimeLimit ||
            _status == HighsModelStatus::kInterrupt);
-    _node->DealFeasible(_reducedSolution);
+    _node->DealFeasible(_oriColValue, _obj);
   }
   else if (!_haveIncumbent)
     _node->DealUnknown();
   else
     assert(false);
+  if (_node->GetNodeStatus() == NodeStatus::BranchedRunning)
+    _node->EndSolving();
 }
 
 const bool MIPTree::HaveGlobalIncumbent() { return scheduler_->HaveIncumbent(); }
@@ -384,16 +744,119 @@ bool NodeSelection_Running::operator()(const MIPNode *a, const MIPNode *b) const
     return a->GetNodeID() < b->GetNodeID();
 }
 
-bool MIPTree::IsEnd() { return rootNode_->IsEnd(); }
+void MIPTree::PrintPoolStatistic() { threadPool_->PrintStatistic(); }
+
+/* A map never changes once built, so the lift itself runs outside the
+   tree lock. */
+bool MIPTree::LiftSolution(MIPNode *_node, vector<double> &_colValue)
+{
+  shared_ptr<const PostsolveMap> map;
+  {
+    boost::mutex::scoped_lock lock(mutexTree_);
+    map = _node->GetPostsolveMap();
+  }
+  return map != nullptr && map->Lift(_colValue);
+}
+
+/* A worker's solution of its node, lifted to the original model and
+   valued there, before its result takes the tree lock. */
+bool MIPTree::LiftNodeSolution(
+    MIPNode *_node, const vector<double> &_colValue, vector<double> &_oriColValue, double &_obj)
+{
+  _oriColValue = _colValue;
+  if (!LiftSolution(_node, _oriColValue))
+  {
+    _oriColValue.clear();
+    return false;
+  }
+  _obj = MIPNode::OriginalObj(_oriColValue);
+  return true;
+}
+
+/* The best node's solution, which its postsolve map has already lifted to
+   the original model, or the resumed incumbent if that is better. */
+bool MIPTree::GetBestSolution(vector<double> &_colValue, double &_obj)
+{
+  boost::mutex::scoped_lock lock(mutexTree_);
+  if (rootNode_ == nullptr)
+    return false;
+  const MIPNode *best = MIPNode::TreeBestNode_;
+  if (best != nullptr && !best->GetOriColValue().empty() && best->GetObj() < resumedObj_)
+  {
+    _colValue = best->GetOriColValue();
+    _obj = best->GetObj();
+    return true;
+  }
+  if (resumedSolution_.empty())
+    return false;
+  _colValue = resumedSolution_;
+  _obj = resumedObj_;
+  return true;
+}
+
+void MIPTree::SetHintSolution(MIPNode *_node, const vector<double> &_colValue, const double _obj)
+{
+  boost::mutex::scoped_lock lock(mutexTree_);
+  _node->SetHintSolution(_colValue, _obj);
+}
+
+void MIPTree::AddModelBytes(const size_t _bytes)
+{
+  boost::mutex::scoped_lock lock(mutexModelBytes_);
+  modelBytes_ += _bytes;
+  modelNum_++;
+  maxNodeBytes_ = max(maxNodeBytes_, _bytes);
+  if (modelBytes_ > peakModelBytes_)
+  {
+    peakModelBytes_ = modelBytes_;
+    peakModelNum_ = modelNum_;
+  }
+}
+
+void MIPTree::ReleaseModelBytes(const size_t _bytes)
+{
+  boost::mutex::scoped_lock lock(mutexModelBytes_);
+  modelBytes_ -= _bytes;
+  modelNum_--;
+}
+
+void MIPTree::PrintStatistic()
+{
+  PrintPoolStatistic();
+  printf("c Node Memory: peak %.2lf MB in %ld nodes; %.1lf KB per node avg, %.1lf KB max\n",
+         peakModelBytes_ / 1048576.0, peakModelNum_,
+         peakModelNum_ > 0 ? peakModelBytes_ / 1024.0 / peakModelNum_ : 0.0,
+         maxNodeBytes_ / 1024.0);
+  if (OPT(partitionAhead) > 0)
+    printf("c Partition Ahead: %ld speculative nodes; %ld waiting nodes discarded\n",
+           speculativeNum_, discardNum_);
+  if (OPT(lazyPresolve) == 1)
+    printf("c Lazy Presolve: %ld children deferred at split time; %ld presolved by their workers\n",
+           deferNum_, lazyPresolveNum_);
+  if (OPT(propagate) == 1)
+    Propagator::PrintStatistic();
+  Presolve::PrintStatistic();
+  PostsolveMap::PrintStatistic();
+  if (unpresolveNum_ > 0)
+    printf("c Unpresolve: %ld nodes whose solution could not be lifted run again on the original model\n",
+           unpresolveNum_);
+  printf("c Warm Start: %ld nodes started from an ancestor's solution\n", warmStartNum_);
+  if (Placement::IsEnabled())
+    printf("c NUMA: %ld nodes run on the NUMA node that presolved them, %ld on another\n",
+           numaLocalNum_, numaRemoteNum_);
+}
+
+// The scheduler may give up before InitNodes has created the root node.
+bool MIPTree::IsEnd() { return rootNode_ != nullptr && rootNode_->IsEnd(); }
 
-bool MIPTree::IsOptimal() { return rootNode_->IsOptimal(); }
+bool MIPTree::IsOptimal() { return rootNode_ != nullptr && rootNode_->IsOptimal(); }
 
-bool MIPTree::IsInfeasible() { return rootNode_->IsInfeasible(); }
+bool MIPTree::IsInfeasible() { return rootNode_ != nullptr && rootNode_->IsInfeasible(); }
 
 const char *MIPTree::GetStatus() { return ProblemStatusToString(rootNode_->GetProblemStatus()); }
 
-bool MIPTree::IsUnknown() { return rootNode_->IsUnknown(); }
+bool MIPTree::IsUnknown() { return rootNode_ == nullptr || rootNode_->IsUnknown(); }
 
-bool MIPTree::IsFeasible() { return rootNode_->IsFeasible() || rootNode_->IsOptimal() || MIPNode::TreeBestNode_ != nullptr; }
+bool MIPTree::IsFeasible() { return (rootNode_ != nullptr && (rootNode_->IsFeasible() || rootNode_->IsOptimal())) || MIPNode::TreeBestNode_ != nullptr || !resumedSolution_.empty(); }
 
 double MIPTree::GetBestObj() { return MIPNode::TreeBestObj_; }
@@ -16,7 +16,8 @@
 #pragma once
 #include "../utils/header.h"
 #include "../utils/paras.h"
-#include "../Presolve/Presolve.h"
+#include "Presolve/Presolve.h"
+#include "ThreadPool/ThreadPool.h"
 #include "MIPNode.h"
 #include "../Scheduler/Scheduler.h"
 class MIPNode;
@@ -48,11 +49,15 @@ public:
   double GetBestObj();
   inline double GetSolveTime() { return solveTime_; }
   void SetNodeStatus(MIPNode *_node, NodeStatus _nodeStatus);
+  void UnpresolveNode(MIPNode *_node);
+  void RequeueNode(MIPNode *_node);
+  bool PresolveNode(MIPNode *_node);
   vector<MIPNode *> GetInitNodesToRun();
-  MIPNode *GetNodeToRun();
+  MIPNode *GetNodeToRun(const int _numaNode = -1);
   void InformNodeResult(
       MIPNode *_node, const HighsModelStatus &_status,
-      bool _haveIncumbent, const HighsSolution &_reducedSolution, double _obj);
+      bool _haveIncumbent, vector<double> &_oriColValue,
+      const double _obj);
   const bool HaveGlobalIncumbent();
   const double GetGlobalIncumbent();
   inline const size_t GetInformWorkerNum() { return informWorkerNum_; }
@@ -69,12 +74,46 @@ public:
   Scheduler *scheduler_;
   static void ActivateNodes(const vector<MIPNode *> &_newNodes);
   static void InsertTempNewNodes(const vector<MIPNode *> &_newNodes);
-  static void PartitionNodes(const vector<MIPNode *> &_selectNodes);
+  static void PrintPoolStatistic();
+  inline static ThreadPool *GetThreadPool() { return threadPool_; }
+  inline bool IsPartitioning() { return partitionNum_ > 0; }
+  /* Running nodes still to be presolved by their workers; they are split
+     once presolved, so an idle worker waits for them. */
+  inline bool IsPresolving() { return deferredRunningNum_ > 0; }
+  void WaitPartition();
+  inline void IncreaseDiscardNum() { discardNum_++; }
+  bool LiftSolution(MIPNode *_node, vector<double> &_colValue);
+  bool LiftNodeSolution(MIPNode *_node, const vector<double> &_colValue, vector<double> &_oriColValue, double &_obj);
+  bool GetBestSolution(vector<double> &_colValue, double &_obj);
+  void SetHintSolution(MIPNode *_node, const vector<double> &_colValue, const double _obj);
+  void SetResume(const Checkpoint *_checkpoint);
+  bool Snapshot(Checkpoint &_checkpoint);
+  void AddModelBytes(const size_t _bytes);
+  void ReleaseModelBytes(const size_t _bytes);
+  void PrintStatistic();
 
 private:
   int coreNum_;
-  bool initDone_;
+  atomic<bool> initDone_;
   atomic<size_t> informWorkerNum_;
+  atomic<size_t> partitionNum_;
+  TaskGroup partitionGroup_;
+  TaskGroup rootMapGroup_;
+  size_t speculativeNum_;
+  size_t discardNum_;
+  size_t deferNum_;
+  size_t lazyPresolveNum_;
+  size_t unpresolveNum_;
+  atomic<size_t> deferredRunningNum_;
+  size_t warmStartNum_;
+  size_t numaLocalNum_;
+  size_t numaRemoteNum_;
+  boost::mutex mutexModelBytes_;
+  size_t modelBytes_;
+  size_t modelNum_;
+  size_t peakModelBytes_;
+  size_t peakModelNum_;
+  size_t maxNodeBytes_;
   mutable boost::mutex mutexInformWorkerNum_;
   mutable boost::mutex mutexTree_;
   MIPNode *rootNode_;
@@ -84,12 +123,25 @@ private:
   unordered_set<MIPNode *> branchedRunningNodes_;
   unordered_set<MIPNode *> endNodes_;
   double solveTime_;
+  /* Checkpoint the tree is rebuilt from, and its incumbent, which no node
+     of the rebuilt tree holds. Its objective is in the model's sense, as
+     the nodes' are. */
+  const Checkpoint *resume_;
+  vector<double> resumedSolution_;
+  double resumedObj_;
 
   static vector<MIPNode *> tempNewNodes_;
   static boost::mutex mutexTempNewNodes_;
+  static ThreadPool *threadPool_;
 
   void BuildRootNode();
+  void PresolveCachedRoot();
+  bool RestoreNodes();
   void InsertWaitingNodes(MIPNode *_mipNode);
   MIPNode *SelectWaitingNodeToBranch();
   MIPNode *SelectRunningNodeToBranch();
+  void PartitionNodes(const vector<MIPNode *> &_selectNodes);
+  void PartitionNodesAsync(const vector<MIPNode *> &_selectNodes);
+  void PublishNewNodes();
+  void PartitionAhead();
 };
@@ -0,0 +1,357 @@
+/*=====================================================================================
+
+    Filename:     WorkerProcess.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "WorkerProcess.h"
+#include "Reader/MPSReader.h"
+#include "ModelCache/ModelCache.h"
+#include "../Worker/Worker.h"
+#include <unistd.h>
+
+SCIP_DECL_EVENTEXEC(remoteNodeEvent)
+{
+  ((WorkerProcess *)eventdata)->SyncSolution(SCIPeventGetType(event));
+  return SCIP_OKAY;
+}
+
+WorkerProcess::WorkerProcess()
+    : pool_(new ThreadPool(OPT(poolThreadNum) > 0 ? OPT(poolThreadNum) : max(2u, thread::hardware_concurrency()))),
+      root_(nullptr),
+      scip_(nullptr),
+      objLimit_(INF),
+      stopped_(false),
+      quit_(false),
+      lastPoll_(0),
+      nodeNum_(0),
+      presolveNum_(0),
+      presolveTime_(0),
+      solveTime_(0)
+{
+}
+
+WorkerProcess::~WorkerProcess()
+{
+  ReleaseProblem();
+  if (scip_ != nullptr)
+    SCIP_CALL_ABORT(SCIPfree(&scip_));
+  ClearChain(0);
+  delete root_;
+  delete pool_;
+}
+
+/* The same sources as the coordinator, so that both start from the same
+   root model: the model cache, then the parallel reader, then HiGHS, whose
+   model the coordinator keeps when it reads with both. */
+bool WorkerProcess::ReadModel()
+{
+  ModelCache *cache = nullptr;
+  bool done = false;
+  if (!OPT(modelCache).empty())
+  {
+    cache = new ModelCache(OPT(modelCache), OPT(instance), Presolve::OptionKey(), pool_);
+    done = cache->LoadModel(model_);
+  }
+  if (!done && OPT(mpsReader) == 1)
+  {
+    MPSReader reader(pool_);
+    done = reader.Read(OPT(instance), model_);
+  }
+  if (!done)
+  {
+    Highs reader;
+    reader.setOptionValue("output_flag", false);
+    done = reader.readModel(OPT(instance)) != HighsStatus::kError;
+    if (done)
+      model_ = reader.getModel();
+  }
+  if (done)
+  {
+    // Passing the model through HiGHS normalises it as the coordinator's.
+    Highs normal;
+    normal.setOptionValue("output_flag", false);
+    normal.passModel(std::move(model_));
+    model_ = normal.getModel();
+    root_ = new Presolve(true);
+    if (cache == nullptr || !root_->LoadRoot(*cache, model_))
+    {
+      root_->LoadModel(model_, {});
+      root_->PresolveByHighs();
+    }
+    // Solutions are lifted by the coordinator, not here.
+    root_->Detach(false);
+  }
+  delete cache;
+  return done;
+}
+
+/* The coordinator may still be starting; keep trying until the cutoff. */
+bool WorkerProcess::Connect()
+{
+  while (!channel_.Connect(OPT(connect)))
+  {
+    if (ElapsedTime() > OPT(cutoff))
+      return false;
+    this_thread::sleep_for(chrono::milliseconds(200));
+  }
+  Message hello(MessageType::Hello);
+  hello.Put(model_.lp_.num_col_);
+  hello.Put(model_.lp_.num_row_);
+  hello.Put(model_.lp_.a_matrix_.numNz());
+  hello.Put((int32_t)getpid());
+  hello.Put(HashModel(model_.lp_));
+  hello.PutVector(vector<char>(OPT(token).begin(), OPT(token).end()));
+  return channel_.Send(hello);
+}
+
+bool WorkerProcess::Run()
+{
+  if (!ReadModel())
+  {
+    printf("c Remote: cannot read %s\n", OPT(instance).c_str());
+    return false;
+  }
+  printf("c %10.2lf    [%-10s] [ Var: %d; Range: %d; NonZero: %d ]\n",
+         ElapsedTime(), "Ori Model", model_.lp_.num_col_, model_.lp_.num_row_, model_.lp_.a_matrix_.numNz());
+  if (!Connect())
+  {
+    printf("c Remote: cannot connect to %s\n", OPT(connect).c_str());
+    return false;
+  }
+  printf("c Remote: connected to %s\n", OPT(connect).c_str());
+  Message message;
+  while (!quit_ && channel_.Receive(message))
+  {
+    if (message.type == MessageType::Node && !SolveNode(message))
+      break;
+    else if (message.type == MessageType::Bound)
+      message.Get(objLimit_);
+    else if (message.type == MessageType::Quit)
+      quit_ = true;
+  }
+  const bool done = quit_;
+  printf("c Remote: %s; %ld nodes; %ld presolves in %.2lf s; %.2lf s solving; %ld bytes sent, %ld received\n",
+         done ? "released by the coordinator" : "lost the coordinator",
+         nodeNum_, presolveNum_, presolveTime_, solveTime_,
+         channel_.GetBytesSent(), channel_.GetBytesReceived());
+  return done;
+}
+
+/* Reads what the coordinator sent while a node is being solved. Called
+   from the event handler, so checks are spaced out. */
+bool WorkerProcess::PollCoordinator()
+{
+  if (ElapsedTime() - lastPoll_ < 0.05)
+    return channel_.IsOpen();
+  lastPoll_ = ElapsedTime();
+  Message message;
+  while (channel_.Poll(0) > 0)
+  {
+    if (!channel_.Receive(message))
+      break;
+    if (message.type == MessageType::Bound)
+    {
+      double objLimit;
+      if (message.Get(objLimit))
+        objLimit_ = min(objLimit_, objLimit);
+    }
+    else if (message.type == MessageType::Stop)
+      stopped_ = true;
+    else if (message.type == MessageType::Quit)
+      stopped_ = quit_ = true;
+  }
+  if (!channel_.IsOpen())
+    stopped_ = quit_ = true;
+  return channel_.IsOpen();
+}
+
+/* New solutions go to the coordinator as found. Between LPs the
+   coordinator is polled; the objective limit is lowered only once a node
+   is solved, where a thread worker lowers it too. */
+void WorkerProcess::SyncSolution(const SCIP_EVENTTYPE _eventType)
+{
+  if (_eventType == SCIP_EVENTTYPE_BESTSOLFOUND)
+  {
+    SCIP_SOL *bestsol = SCIPgetBestSol(scip_);
+    if (bestsol == nullptr)
+      return;
+    vector<double> colValue(scipVars_.size());
+    SCIP_CALL_ABORT(SCIPgetSolVals(scip_, bestsol, scipVars_.size(), scipVars_.data(), colValue.data()));
+    Message solution(MessageType::Solution);
+    solution.Put(SCIPgetSolOrigObj(scip_, bestsol));
+    solution.PutVector(colValue);
+    channel_.Send(solution);
+    return;
+  }
+  PollCoordinator();
+  if (stopped_)
+  {
+    SCIP_CALL_ABORT(SCIPinterruptSolve(scip_));
+    return;
+  }
+  if (_eventType == SCIP_EVENTTYPE_NODESOLVED && objLimit_ < INF &&
+      objLimit_ < SCIPgetObjlimit(scip_))
+    SCIP_CALL_ABORT(SCIPsetObjlimit(scip_, objLimit_));
+}
+
+void WorkerProcess::ClearChain(const size_t _depth)
+{
+  for (size_t i = _depth; i < chain_.size(); ++i)
+    delete chain_[i];
+  chain_.resize(min(_depth, chain_.size()));
+  path_.resize(chain_.size());
+}
+
+/* Presolves the path's steps below the part it shares with the previous
+   node's path. Nullptr if a step ends in presolve, which the coordinator
+   would have seen too, so the replay has diverged. */
+const HighsModel *WorkerProcess::ReplayPath(const vector<BoundChange> &_path)
+{
+  size_t depth = 0;
+  while (depth < path_.size() && depth < _path.size() &&
+         path_[depth].col == _path[depth].col &&
+         path_[depth].lower == _path[depth].lower &&
+         path_[depth].upper == _path[depth].upper)
+    depth++;
+  ClearChain(depth);
+  const double startTime = ElapsedTime();
+  for (; depth < _path.size(); ++depth)
+  {
+    const Presolve *parent = depth == 0 ? root_ : chain_[depth - 1];
+    if (_path[depth].col < 0 || _path[depth].col >= parent->GetReducedModel().lp_.num_col_)
+      return nullptr;
+    // The coordinator propagated the branching bound before presolving.
+    vector<BoundChange> changes = {_path[depth]};
+    if (OPT(propagate) == 1 && !Propagator(parent->GetReducedModel().lp_).Propagate(changes))
+      return nullptr;
+    Presolve *presolve = new Presolve(true);
+    if (OPT(incrementalPresolve) > 0)
+      presolve->PresolveIncremental(parent->GetReducedModel(), changes, OPT(incrementalPresolve));
+    else
+    {
+      presolve->LoadModel(parent->GetReducedModel(), changes);
+      presolve->PresolveByHighs();
+    }
+    presolve->Detach(false);
+    chain_.push_back(presolve);
+    path_.push_back(_path[depth]);
+    presolveNum_++;
+    if (presolve->CheckPresolveInfeas() || presolve->CheckPresolveOptimal())
+      return nullptr;
+  }
+  presolveTime_ += ElapsedTime() - startTime;
+  return &(chain_.empty() ? root_ : chain_.back())->GetReducedModel();
+}
+
+/* The SCIP instance, with its plugins, lives as long as the process; the
+   problem is rebuilt for every node. */
+void WorkerProcess::LoadModel(const HighsModel &_model)
+{
+  if (scip_ == nullptr)
+  {
+    SCIP_CALL_ABORT(SCIPcreate(&scip_));
+    SCIP_CALL_ABORT(SCIPincludeDefaultPlugins(scip_));
+    SCIP_CALL_ABORT(SCIPsetIntParam(scip_, "parallel/maxnthreads", 1));
+    SCIP_CALL_ABORT(SCIPsetIntParam(scip_, "display/verblevel", 0));
+    SCIP_EVENTHDLR *eventHandler = nullptr;
+    SCIP_CALL_ABORT(
+        SCIPincludeEventhdlrBasic(
+            scip_, &eventHandler, "RemoteNodeHandler",
+            "Reports solutions of a worker process and polls its coordinator", remoteNodeEvent, nullptr));
+  }
+  else
+  {
+    ReleaseProblem();
+    SCIP_CALL_ABORT(SCIPfreeProb(scip_));
+  }
+  BuildSCIPProblem(scip_, _model.lp_, "SCIP_remote", scipVars_, scipCons_);
+}
+
+void WorkerProcess::ReleaseProblem()
+{
+  for (auto &scipCons : scipCons_)
+    if (scipCons != nullptr)
+      SCIP_CALL_ABORT(SCIPreleaseCons(scip_, &scipCons));
+  for (auto &scipVar : scipVars_)
+    if (scipVar != nullptr)
+      SCIP_CALL_ABORT(SCIPreleaseVar(scip_, &scipVar));
+  scipCons_.clear();
+  scipVars_.clear();
+}
+
+void WorkerProcess::AddSolution(const vector<double> &_colValue)
+{
+  if (_colValue.size() != scipVars_.size())
+    return;
+  SCIP_SOL *sol = nullptr;
+  SCIP_Bool stored = FALSE;
+  SCIP_CALL_ABORT(SCIPcreateOrigSol(scip_, &sol, nullptr));
+  SCIP_CALL_ABORT(SCIPsetSolVals(scip_, sol, scipVars_.size(), scipVars_.data(), const_cast<double *>(_colValue.data())));
+  SCIP_CALL_ABORT(SCIPaddSolFree(scip_, &sol, &stored));
+}
+
+bool WorkerProcess::SolveNode(Message &_node)
+{
+  uint64_t nodeID;
+  double timeLimit;
+  HighsInt colNum, rowNum, nonzeroNum;
+  vector<BoundChange> path;
+  vector<double> poolSolution, warmStart;
+  if (!_node.Get(nodeID) || !_node.Get(objLimit_) || !_node.Get(timeLimit) ||
+      !_node.Get(colNum) || !_node.Get(rowNum) || !_node.Get(nonzeroNum) ||
+      !_node.GetVector(path) || !_node.GetVector(poolSolution) || !_node.GetVector(warmStart))
+    return false;
+  const HighsModel *model = ReplayPath(path);
+  if (model == nullptr || model->lp_.num_col_ != colNum || model->lp_.num_row_ != rowNum ||
+      model->lp_.a_matrix_.numNz() != nonzeroNum)
+  {
+    printf("c Remote: node %ld does not replay on this model\n", (size_t)nodeID);
+    return false;
+  }
+  LoadModel(*model);
+  SCIP_CALL_ABORT(SCIPsetRealParam(scip_, "limits/gap", OPT(defualtPrecision) == 0 ? OPT(MIPGap) : 0.0));
+  SCIP_CALL_ABORT(SCIPsetRealParam(scip_, "limits/time", max(timeLimit, 1.0)));
+  if (objLimit_ < INF)
+    SCIP_CALL_ABORT(SCIPsetObjlimit(scip_, objLimit_));
+  AddSolution(poolSolution);
+  AddSolution(warmStart);
+  stopped_ = false;
+  SCIP_CALL_ABORT(SCIPtransformProb(scip_));
+  SCIP_CALL_ABORT(SCIPcatchEvent(
+      scip_, SCIP_EVENTTYPE_BESTSOLFOUND | SCIP_EVENTTYPE_NODESOLVED | SCIP_EVENTTYPE_LPSOLVED,
+      SCIPfindEventhdlr(scip_, "RemoteNodeHandler"), (SCIP_EVENTDATA *)this, nullptr));
+  const double startTime = ElapsedTime();
+  SCIP_CALL_ABORT(SCIPsolve(scip_));
+  solveTime_ += ElapsedTime() - startTime;
+  nodeNum_++;
+  // Nothing better than the objective limit is infeasible to SCIP, which
+  // the tree takes as it does from a thread worker.
+  const HighsModelStatus status = SCIPStatusToHighs(SCIPgetStatus(scip_));
+  SCIP_SOL *bestsol = SCIPgetBestSol(scip_);
+  const bool haveIncumbent = bestsol != nullptr;
+  vector<double> colValue;
+  double obj = INF;
+  if (haveIncumbent)
+  {
+    colValue.resize(scipVars_.size());
+    SCIP_CALL_ABORT(SCIPgetSolVals(scip_, bestsol, scipVars_.size(), scipVars_.data(), colValue.data()));
+    obj = SCIPgetSolOrigObj(scip_, bestsol);
+  }
+  SCIP_CALL_ABORT(SCIPfreeTransform(scip_));
+  Message result(MessageType::Result);
+  result.Put((int32_t)status);
+  result.Put((uint8_t)haveIncumbent);
+  result.Put(obj);
+  result.PutVector(colValue);
+  return channel_.Send(result);
+}
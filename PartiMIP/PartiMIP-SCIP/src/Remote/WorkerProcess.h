@@ -0,0 +1,68 @@
+/*=====================================================================================
+
+    Filename:     WorkerProcess.h
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#pragma once
+#include "../utils/header.h"
+#include "../utils/paras.h"
+#include "Presolve/Presolve.h"
+#include "Propagator/Propagator.h"
+#include "ThreadPool/ThreadPool.h"
+#include "Remote/Channel.h"
+
+/* A process started with --connect. It reads the instance itself, presolves
+   the root as the coordinator does, and then solves the nodes it is sent
+   with SCIP. A node's model is rebuilt by presolving again along its path
+   of bound changes; the presolvers of the previous node's path are kept,
+   so that a node next to the previous one only presolves the steps that
+   differ. */
+class WorkerProcess
+{
+public:
+  WorkerProcess();
+  ~WorkerProcess();
+  bool Run();
+  bool PollCoordinator();
+  void SyncSolution(const SCIP_EVENTTYPE _eventType);
+
+private:
+  Channel channel_;
+  ThreadPool *pool_;
+  HighsModel model_;
+  Presolve *root_;
+  vector<BoundChange> path_;
+  vector<Presolve *> chain_;
+  SCIP *scip_;
+  vector<SCIP_VAR *> scipVars_;
+  vector<SCIP_CONS *> scipCons_;
+  /* Objective limit sent by the coordinator, in the model's sense; INF
+     while it has no incumbent. */
+  double objLimit_;
+  bool stopped_;
+  bool quit_;
+  double lastPoll_;
+  size_t nodeNum_;
+  size_t presolveNum_;
+  double presolveTime_;
+  double solveTime_;
+
+  bool ReadModel();
+  bool Connect();
+  bool SolveNode(Message &_node);
+  const HighsModel *ReplayPath(const vector<BoundChange> &_path);
+  void ClearChain(const size_t _depth);
+  void LoadModel(const HighsModel &_model);
+  void ReleaseProblem();
+  void AddSolution(const vector<double> &_colValue);
+};
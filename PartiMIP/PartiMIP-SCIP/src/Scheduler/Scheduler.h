@@ -18,6 +18,12 @@
 #include "../utils/paras.h"
 #include "../Worker/Worker.h"
 #include "../MIPTree/MIPTree.h"
+#include "SolutionPool/SolutionPool.h"
+#include "SolutionWriter/SolutionWriter.h"
+#include "Profiler/Profiler.h"
+#include "Reader/MPSReader.h"
+#include "ModelCache/ModelCache.h"
+#include "Placement/Placement.h"
 class Worker;
 class RootWorker;
 class GeneralWorker;
@@ -42,11 +48,50 @@ public:
       const size_t &_tid) const;
   const size_t GetIdleWorkerNum() const;
   const bool IsRootWorkerDone() const;
+  const bool IsInitDone() const;
+  void RequeueNode(MIPNode *_node) const;
+  bool PresolveNode(MIPNode *_node) const;
   inline const HighsModel &GetRootModel() const { return highs_.getModel(); }
+  const size_t GetEventSeq() const;
+  void Notify() const;
+  void WaitEvent(const size_t &_eventSeq, const double &_timeout) const;
+  void RecordDispatchLatency(const double &_latency) const;
+  void SubmitSolution(MIPNode *_node, const double *_colValue, const size_t _colNum, const double _obj) const;
+  inline SolutionPool *GetSolutionPool() const { return solutionPool_; }
+  bool IsUsefulSolution(const double _obj) const;
+  inline ModelCache *GetModelCache() const { return modelCache_; }
+  inline uint64_t GetModelHash() const { return modelHash_; }
 
 private:
   mutable boost::mutex mutexTree_;
+  mutable boost::mutex mutexEvent_;
+  mutable boost::condition_variable condEvent_;
+  mutable size_t eventSeq_;
+  mutable atomic<size_t> dispatchNum_;
+  mutable atomic<uint64_t> dispatchLatencySum_;
+  mutable atomic<uint64_t> dispatchLatencyMax_;
   MIPTree *mipTree_;
+  SolutionPool *solutionPool_;
+  SolutionWriter *solutionWriter_;
+  ModelCache *modelCache_;
+  /* Socket worker processes connect to, served by the remote workers. */
+  int listenFd_;
+  /* Hash of the root model a worker process must match. */
+  uint64_t modelHash_;
+  /* Checkpoint read when resuming; it outlives the tree rebuilt from it. */
+  Checkpoint resume_;
+  double resumedTime_;
+  double nextCheckpoint_;
+  size_t checkpointNum_;
+  double checkpointTime_;
+  struct PendingSolution
+  {
+    MIPNode *node;
+    vector<double> colValue;
+    double obj;
+  };
+  mutable boost::mutex mutexPendingSolution_;
+  mutable vector<PendingSolution> pendingSolutions_;
   string logPath_;
   double cutoff_;
   size_t threadNum_;
@@ -58,8 +103,12 @@ private:
 
   void InitWorkerSet();
   void InitModel();
+  void ReadModel();
   void Solve();
   void TerminateWorker();
   void PrintResult();
-  void SimpleResult(); 
+  void SimpleResult();
+  void CollectSolutions(); 
+  void LoadCheckpoint();
+  void WriteCheckpoint();
 };
\ No newline at end of file
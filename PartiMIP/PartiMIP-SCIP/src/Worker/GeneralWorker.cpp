@@ -19,45 +19,71 @@ atomic<double> incumbentSubNode(INF);
 
 SCIP_DECL_EVENTEXEC(eventExecCallback_2)
 {
-  SCIP_SOL *bestsol = SCIPgetBestSol(scip);
-  if (bestsol != nullptr)
-    incumbentSubNode.store(min(SCIPgetSolOrigObj(scip, bestsol), incumbentSubNode.load()));
+  if (SCIPeventGetType(event) == SCIP_EVENTTYPE_BESTSOLFOUND)
+  {
+    SCIP_SOL *bestsol = SCIPgetBestSol(scip);
+    if (bestsol != nullptr)
+      incumbentSubNode.store(min(SCIPgetSolOrigObj(scip, bestsol), incumbentSubNode.load()));
+  }
+  ((Worker *)eventdata)->SyncSolution(SCIPeventGetType(event));
   return SCIP_OKAY;
 }
 
 void GeneralWorker::Run()
 {
+  Profiler::NameThread("worker " + to_string(tid_));
   phase2_.store(false);
   while (!terminated_)
   {
-    usleep(100000);
+    WaitWakeUp();
     if (phase2_.load())
     {
-      while (!scheduler_->GetNodeToRun(tid_))
-        usleep(100000);
+      RequestNode();
       phase2_.store(false);
     }
     if (workerStatus_ == WorkerStatus::Busy)
     {
+      Profiler::TraceInstant("worker", "busy", node_->GetNodeID());
+      bool solved = false;
+      if (!endRuning && !PresolveNode())
+        endRuning = true;
       if (!endRuning)
       {
-        HighsToSCIP(node_->GetHighsToSolve());
+        const double setupStartTime = ElapsedTime();
+        LoadModel(node_->GetModelToSolve());
         ObjCut();
         SetPrecision();
         SetParameter();
+        poolVersion_ = 0;
+        if (FetchSolution(poolSolution_))
+          AddPoolSolution(poolSolution_);
+        if (node_->TakeWarmStart(warmStart_))
+          AddSolution(warmStart_);
         SetCallback();
+        setupTime_ += ElapsedTime() - setupStartTime;
+        Profiler::RecordSpan(Phase::SolverSetup, setupStartTime, node_->GetNodeID());
       }
       if (!scipSolveStarted_ && !endRuning)
       {
+        const double solveStartTime = ElapsedTime();
         scipSolveStarted_ = true;
         SCIP_CALL_ABORT(SCIPsolve(scip_));
         scipSolveStarted_ = false;
+        solveTime_ += ElapsedTime() - solveStartTime;
+        Profiler::RecordSpan(Phase::Solve, solveStartTime, node_->GetNodeID());
+        nodeNum_++;
+        solved = true;
       }
       Idle();
-      DealResult();
-      ReleaseSCIP();
-      while (!scheduler_->GetNodeToRun(tid_))
-        usleep(100000);
+      // A node that ended before it was solved has nothing to report, and
+      // SCIP still holds the previous node's result.
+      if (solved)
+        DealResult();
+      else
+        scheduler_->NodeResult(node_, HighsModelStatus::kNotset, false, HighsSolution(), tid_, INF);
+      if (scip_ != nullptr)
+        SCIP_CALL_ABORT(SCIPfreeTransform(scip_));
+      RequestNode();
       endRuning = false;
     }
   }
@@ -65,49 +91,74 @@ void GeneralWorker::Run()
               ElapsedTime(), "End", tid_);
 }
 
+void GeneralWorker::WaitWakeUp()
+{
+  PhaseTimer timer(Phase::WorkerIdle);
+  boost::mutex::scoped_lock lock(mutexWakeUp_);
+  condWakeUp_.wait(
+      lock, [&]
+      { return terminated_ || phase2_.load() || workerStatus_ == WorkerStatus::Busy; });
+}
+
+/* Waits for the next event rather than polling: every change that can
+   bring a node, a result, a finished presolve or partition, or the end of
+   the run, notifies the scheduler. Only the dispatch cutoff, 10 s before
+   the time limit, is a matter of time. */
+void GeneralWorker::RequestNode()
+{
+  PhaseTimer timer(Phase::DispatchWait);
+  size_t eventSeq = scheduler_->GetEventSeq();
+  while (!scheduler_->GetNodeToRun(tid_))
+  {
+    scheduler_->WaitEvent(eventSeq, OPT(cutoff) - 10 - ElapsedTime());
+    eventSeq = scheduler_->GetEventSeq();
+  }
+}
+
+/* A node deferred at split time is presolved here, as part of the setup.
+   False if it ended, in presolve or before. */
+bool GeneralWorker::PresolveNode()
+{
+  return !node_->IsDeferred() || scheduler_->PresolveNode(node_);
+}
+
 void GeneralWorker::ObjCut()
 {
-  if (scheduler_->HaveIncumbent())
+  if (!scheduler_->HaveIncumbent())
+    return;
+  const double incumbentValue = scheduler_->GetIncumbent();
+  if (incumbentValue < SCIPgetObjlimit(scip_))
   {
-    const double incumbentValue = scheduler_->GetIncumbent();
-    if (incumbentValue < node_->GetObjCutValue())
-    {
-      SCIP_CONS *objCutCons = nullptr;
-      vector<double> col_cost_copy(node_->GetHighsToSolve().getLp().col_cost_);
-      SCIP_CALL_ABORT(SCIPcreateConsBasicLinear(
-          scip_,
-          &objCutCons,
-          "obj_cut",
-          numVars_,
-          scipVars_.data(),
-          col_cost_copy.data(),
-          -SCIPinfinity(scip_),
-          incumbentValue - node_->GetHighsToSolve().getLp().offset_));
-      SCIP_CALL_ABORT(SCIPaddCons(scip_, objCutCons));
-      scipCons_.push_back(objCutCons);
-      DEBUG_PRINT("c %10.2lf    [%-10s]    Worker(%3ld) [%lf]\n",
-                  ElapsedTime(), "Obj Cut", tid_, incumbentValue);
-    }
+    SCIP_CALL_ABORT(SCIPsetObjlimit(scip_, incumbentValue));
+    DEBUG_PRINT("c %10.2lf    [%-10s]    Worker(%3ld) [%lf]\n",
+                ElapsedTime(), "Obj Cut", tid_, incumbentValue);
   }
 }
 
 GeneralWorker::GeneralWorker(int _tid, Scheduler *_scheduler)
     : Worker(_tid, _scheduler),
-      node_(nullptr),
       terminated_(false),
-      endRuning(false)
+      node_(nullptr),
+      endRuning(false),
+      idleStartTime_(INF),
+      setupTime_(0),
+      solveTime_(0),
+      nodeNum_(0),
+      reuseNum_(0)
 {
 }
 
 void GeneralWorker::SetCallback()
 {
-  SCIP_EVENTHDLR *eventHandler = nullptr;
-  SCIP_CALL_ABORT(
-      SCIPincludeEventhdlrBasic(
-          scip_, &eventHandler, "BestSolutionHandler_2",
-          "Handles updates to the best solution found of general worker", eventExecCallback_2, nullptr));
+  SCIP_EVENTHDLR *eventHandler = SCIPfindEventhdlr(scip_, "BestSolutionHandler_2");
+  if (eventHandler == nullptr)
+    SCIP_CALL_ABORT(
+        SCIPincludeEventhdlrBasic(
+            scip_, &eventHandler, "BestSolutionHandler_2",
+            "Handles updates to the best solution found of general worker", eventExecCallback_2, nullptr));
   SCIP_CALL_ABORT(SCIPtransformProb(scip_));
-  SCIP_CALL_ABORT(SCIPcatchEvent(scip_, SCIP_EVENTTYPE_BESTSOLFOUND, eventHandler, nullptr, nullptr));
+  SCIP_CALL_ABORT(SCIPcatchEvent(scip_, SCIP_EVENTTYPE_BESTSOLFOUND | SCIP_EVENTTYPE_NODESOLVED,
+                                 eventHandler, (SCIP_EVENTDATA *)this, nullptr));
 }
 
 void GeneralWorker::SetParameter()
@@ -123,14 +174,36 @@ void GeneralWorker::SetNode(MIPNode *_node)
 
 void GeneralWorker::Busy()
 {
-  workerStatus_ = WorkerStatus::Busy;
+  {
+    boost::mutex::scoped_lock lock(mutexWakeUp_);
+    if (idleStartTime_ < INF)
+      scheduler_->RecordDispatchLatency(ElapsedTime() - idleStartTime_);
+    idleStartTime_ = INF;
+    workerStatus_ = WorkerStatus::Busy;
+  }
+  condWakeUp_.notify_one();
   DEBUG_PRINT("c %10.2lf    [%-10s]    Worker(%3ld) ---> Node(%ld)\n",
               ElapsedTime(), "Busy", tid_, node_->GetNodeID());
 }
 
+void GeneralWorker::SetPhase2()
+{
+  {
+    boost::mutex::scoped_lock lock(mutexWakeUp_);
+    idleStartTime_ = ElapsedTime();
+    phase2_.store(true);
+  }
+  condWakeUp_.notify_one();
+}
+
 void GeneralWorker::Idle()
 {
-  workerStatus_ = WorkerStatus::Idle;
+  {
+    boost::mutex::scoped_lock lock(mutexWakeUp_);
+    workerStatus_ = WorkerStatus::Idle;
+    idleStartTime_ = ElapsedTime();
+  }
+  Profiler::TraceInstant("worker", "idle", node_->GetNodeID());
   DEBUG_PRINT("c %10.2lf    [%-10s]    Worker(%3ld)\n",
               ElapsedTime(), "Idle", tid_);
 }
@@ -145,6 +218,32 @@ double GeneralWorker::GetIncumbent()
   return incumbentSubNode.load();
 }
 
+void GeneralWorker::SyncSolution(const SCIP_EVENTTYPE _eventType)
+{
+  if (_eventType == SCIP_EVENTTYPE_BESTSOLFOUND)
+  {
+    SubmitBestSolution(node_);
+    return;
+  }
+  ObjCut();
+  if (FetchSolution(poolSolution_))
+    AddPoolSolution(poolSolution_);
+}
+
+/* The pooled solution is in the original model; keep only the columns that
+   survive in this node's reduced model. */
+bool GeneralWorker::FetchSolution(vector<double> &_colValue)
+{
+  vector<double> oriValue;
+  if (!FetchPoolSolution(oriValue))
+    return false;
+  const vector<HighsInt> &colIndex = node_->GetOrigColIndex();
+  _colValue.resize(colIndex.size());
+  for (size_t i = 0; i < colIndex.size(); ++i)
+    _colValue[i] = oriValue[colIndex[i]];
+  return true;
+}
+
 void GeneralWorker::EndRunning()
 {
   if (workerStatus_ == WorkerStatus::Busy && scipSolveStarted_ && scip_ != nullptr)
@@ -161,37 +260,9 @@ void GeneralWorker::DealResult()
   double obj = INF;
   if (scip_ != nullptr)
   {
-    SCIP_STATUS scipStatus = SCIPgetStatus(scip_);
+    highsStatus = SCIPStatusToHighs(SCIPgetStatus(scip_));
     feasible = IsFeasible();
 
-    switch (scipStatus)
-    {
-    case SCIP_STATUS_OPTIMAL:
-      highsStatus = HighsModelStatus::kOptimal;
-      break;
-    case SCIP_STATUS_INFEASIBLE:
-      highsStatus = HighsModelStatus::kInfeasible;
-      break;
-    case SCIP_STATUS_INFORUNBD:
-      highsStatus = HighsModelStatus::kUnboundedOrInfeasible;
-      break;
-    case SCIP_STATUS_UNBOUNDED:
-      highsStatus = HighsModelStatus::kUnbounded;
-      break;
-    case SCIP_STATUS_TIMELIMIT:
-      highsStatus = HighsModelStatus::kTimeLimit;
-      break;
-    case SCIP_STATUS_MEMLIMIT:
-      highsStatus = HighsModelStatus::kMemoryLimit;
-      break;
-    case SCIP_STATUS_USERINTERRUPT:
-      highsStatus = HighsModelStatus::kInterrupt;
-      break;
-    default:
-      highsStatus = HighsModelStatus::kUnknown;
-      break;
-    }
-
     if (feasible)
     {
       double *solVals = new double[numVars_];
@@ -211,5 +282,9 @@ void GeneralWorker::Terminate()
   if (workerStatus_ == WorkerStatus::Busy && scipSolveStarted_ && scip_ != nullptr)
     SCIP_CALL_ABORT(SCIPinterruptSolve(scip_));
   scipSolveStarted_ = false;
-  terminated_ = true;
+  {
+    boost::mutex::scoped_lock lock(mutexWakeUp_);
+    terminated_ = true;
+  }
+  condWakeUp_.notify_one();
 }
\ No newline at end of file
@@ -0,0 +1,238 @@
+/*=====================================================================================
+
+    Filename:     RemoteWorker.cpp
+
+    Description:
+        Version:  1.0
+
+    Author:       Peng Lin, linpeng@ios.ac.cn
+
+    Organization: Shaowei Cai Group,
+                  Institute of Software,
+                  Chinese Academy of Sciences,
+                  Beijing, China.
+
+=====================================================================================*/
+#include "Worker.h"
+
+extern atomic<double> incumbentSubNode;
+
+RemoteWorker::RemoteWorker(int _tid, Scheduler *_scheduler, const int _listenFd)
+    : GeneralWorker(_tid, _scheduler),
+      listenFd_(_listenFd),
+      connected_(false),
+      connectNum_(0),
+      lostNum_(0)
+{
+}
+
+void RemoteWorker::Run()
+{
+  Profiler::NameThread("remote " + to_string(tid_));
+  while (!terminated_)
+  {
+    if (!channel_.Accept(listenFd_, 1))
+      continue;
+    if (!Handshake())
+    {
+      channel_.Close();
+      continue;
+    }
+    size_t eventSeq = scheduler_->GetEventSeq();
+    while (!terminated_ && !scheduler_->IsInitDone())
+    {
+      scheduler_->WaitEvent(eventSeq, 1);
+      eventSeq = scheduler_->GetEventSeq();
+    }
+    connected_ = true;
+    {
+      boost::mutex::scoped_lock lock(mutexWakeUp_);
+      idleStartTime_ = ElapsedTime();
+    }
+    if (!terminated_)
+      RequestNode();
+    while (!terminated_ && connected_)
+    {
+      WaitWakeUp();
+      if (workerStatus_ != WorkerStatus::Busy)
+        continue;
+      Profiler::TraceInstant("worker", "busy", node_->GetNodeID());
+      HighsModelStatus status = HighsModelStatus::kNotset;
+      bool haveIncumbent = false;
+      HighsSolution solution;
+      double obj = INF;
+      const double solveStartTime = ElapsedTime();
+      // The coordinator presolves a deferred node too: solutions come back
+      // in its reduced model.
+      if (!endRuning && !PresolveNode())
+        endRuning = true;
+      if (!endRuning && !SolveRemote(status, haveIncumbent, solution, obj))
+      {
+        Idle();
+        scheduler_->RequeueNode(node_);
+        Disconnect();
+        endRuning = false;
+        break;
+      }
+      solveTime_ += ElapsedTime() - solveStartTime;
+      nodeNum_++;
+      Idle();
+      scheduler_->NodeResult(node_, status, haveIncumbent, solution, tid_, obj);
+      endRuning = false;
+      RequestNode();
+    }
+  }
+  if (channel_.IsOpen())
+  {
+    channel_.Send(Message(MessageType::Quit));
+    Disconnect();
+  }
+  DEBUG_PRINT("c %10.2lf    [%-10s]    RemoteWorker(%ld)\n",
+              ElapsedTime(), "End", tid_);
+}
+
+/* The peer is served only if it presents the coordinator's token and
+   reads the same model, down to its values. Tokens are compared in time
+   independent of where they differ. */
+bool RemoteWorker::Handshake()
+{
+  Message hello;
+  HighsInt colNum, rowNum, nonzeroNum;
+  int32_t pid;
+  uint64_t modelHash;
+  vector<char> token;
+  // Until it is checked, a peer may send no more than a Hello with a token
+  // as long as the coordinator's, and it sends that as soon as it connects.
+  channel_.SetMaxMessageSize(3 * sizeof(HighsInt) + sizeof(int32_t) + 2 * sizeof(uint64_t) +
+                             OPT(token).size());
+  if (channel_.Poll(2) <= 0 || !channel_.Receive(hello) || hello.type != MessageType::Hello ||
+      !hello.Get(colNum) || !hello.Get(rowNum) || !hello.Get(nonzeroNum) || !hello.Get(pid) ||
+      !hello.Get(modelHash) || !hello.GetVector(token))
+    return false;
+  char diff = token.size() != OPT(token).size();
+  for (size_t i = 0; i < token.size() && i < OPT(token).size(); ++i)
+    diff |= token[i] ^ OPT(token)[i];
+  if (diff != 0)
+  {
+    printf("c Remote: refused worker process %d; wrong token\n", pid);
+    return false;
+  }
+  const HighsLp &lp = scheduler_->GetRootModel().lp_;
+  if (colNum != lp.num_col_ || rowNum != lp.num_row_ || nonzeroNum != lp.a_matrix_.numNz() ||
+      modelHash != scheduler_->GetModelHash())
+  {
+    printf("c Remote: refused worker process %d; its model (%d vars, %d cons, %d nonzeros) differs\n",
+           pid, colNum, rowNum, nonzeroNum);
+    return false;
+  }
+  // Nothing the worker process sends is larger than a result in the root
+  // model; a node's reduced model is never larger.
+  channel_.SetMaxMessageSize(1024 + sizeof(double) * ((size_t)lp.num_col_ + lp.num_row_));
+  connectNum_++;
+  printf("c %10.2lf    [%-10s]    worker process %d as worker %ld\n",
+         ElapsedTime(), "Remote", pid, tid_);
+  return true;
+}
+
+/* The objective limit a thread worker would set (ObjCut), in the model's
+   sense; INF while there is no incumbent. */
+double RemoteWorker::GetObjLimit()
+{
+  return scheduler_->HaveIncumbent() ? scheduler_->GetIncumbent() : INF;
+}
+
+/* Sends the node as its path of bound changes from the root, with the
+   pooled solution and the warm start, and relays the worker process'
+   solutions until its result arrives. Meanwhile a better incumbent is
+   passed on as a new objective limit, and a node that ended elsewhere is
+   stopped. False if the worker process is lost. */
+bool RemoteWorker::SolveRemote(
+    HighsModelStatus &_status, bool &_haveIncumbent,
+    HighsSolution &_solution, double &_obj)
+{
+  vector<BoundChange> path;
+  for (const MIPNode *node = node_; node->GetParent() != nullptr; node = node->GetParent())
+    path.push_back(node->GetBoundChanges()[0]);
+  reverse(path.begin(), path.end());
+  const HighsLp &lp = node_->GetModelToSolve().lp_;
+  poolVersion_ = 0;
+  if (!FetchSolution(poolSolution_))
+    poolSolution_.clear();
+  if (!node_->TakeWarmStart(warmStart_))
+    warmStart_.clear();
+  double objLimit = GetObjLimit();
+  Message request(MessageType::Node);
+  request.Put((uint64_t)node_->GetNodeID());
+  request.Put(objLimit);
+  request.Put(OPT(cutoff) - ElapsedTime());
+  request.Put(lp.num_col_);
+  request.Put(lp.num_row_);
+  request.Put(lp.a_matrix_.numNz());
+  request.PutVector(path);
+  request.PutVector(poolSolution_);
+  request.PutVector(warmStart_);
+  if (!channel_.Send(request))
+    return false;
+  double stopTime = INF;
+  Message message;
+  while (true)
+  {
+    if ((endRuning || terminated_) && stopTime == INF)
+    {
+      if (!channel_.Send(Message(MessageType::Stop)))
+        return false;
+      stopTime = ElapsedTime();
+    }
+    else if (ElapsedTime() > stopTime + 10)
+      return false;
+    if (GetObjLimit() < objLimit)
+    {
+      objLimit = GetObjLimit();
+      Message bound(MessageType::Bound);
+      bound.Put(objLimit);
+      if (!channel_.Send(bound))
+        return false;
+    }
+    const int ready = channel_.Poll(0.1);
+    if (ready < 0)
+      return false;
+    if (ready == 0)
+      continue;
+    if (!channel_.Receive(message))
+      return false;
+    if (message.type == MessageType::Solution)
+    {
+      double obj;
+      vector<double> colValue;
+      if (message.Get(obj) && message.GetVector(colValue) && colValue.size() == (size_t)lp.num_col_)
+      {
+        incumbentSubNode.store(min(obj, incumbentSubNode.load()));
+        scheduler_->SubmitSolution(node_, colValue.data(), colValue.size(), obj);
+      }
+    }
+    else if (message.type == MessageType::Result)
+    {
+      int32_t status;
+      uint8_t haveIncumbent;
+      if (!message.Get(status) || !message.Get(haveIncumbent) || !message.Get(_obj) ||
+          !message.GetVector(_solution.col_value))
+        return false;
+      _status = (HighsModelStatus)status;
+      _haveIncumbent = haveIncumbent != 0 && _solution.col_value.size() == (size_t)lp.num_col_;
+      _solution.value_valid = _haveIncumbent;
+      return true;
+    }
+  }
+}
+
+void RemoteWorker::Disconnect()
+{
+  if (connected_ && !terminated_)
+  {
+    lostNum_++;
+    printf("c %10.2lf    [%-10s]    worker %ld lost its worker process\n",
+           ElapsedTime(), "Remote", tid_);
+  }
+  connected_ = false;
+  channel_.Close();
+}
@@ -18,19 +18,28 @@ atomic<double> incumbentRoot(INF);
 
 SCIP_DECL_EVENTEXEC(eventExecCallback)
 {
-  SCIP_SOL *bestsol = SCIPgetBestSol(scip);
-  if (bestsol != nullptr)
+  if (SCIPeventGetType(event) == SCIP_EVENTTYPE_BESTSOLFOUND)
   {
-    double a = SCIPgetSolOrigObj(scip, bestsol);
-    if (a < incumbentRoot.load())
-      incumbentRoot.store(a);
+    SCIP_SOL *bestsol = SCIPgetBestSol(scip);
+    if (bestsol != nullptr)
+    {
+      double a = SCIPgetSolOrigObj(scip, bestsol);
+      if (a < incumbentRoot.load())
+        incumbentRoot.store(a);
+    }
   }
+  ((Worker *)eventdata)->SyncSolution(SCIPeventGetType(event));
   return SCIP_OKAY;
 }
 
 void RootWorker::Run()
 {
-  HighsToSCIP(scheduler_->GetRootModel());
+  Profiler::NameThread("root worker");
+  {
+    PhaseTimer timer(Phase::SolverSetup);
+    CreateSCIP();
+    HighsToSCIP(scheduler_->GetRootModel());
+  }
   SCIP_CALL_ABORT(SCIPsetRealParam(scip_, "limits/time", OPT(cutoff) - ElapsedTime()));
   SetPrecision();
   SCIP_EVENTHDLR *eventHandler = nullptr;
@@ -39,15 +48,18 @@ void RootWorker::Run()
           scip_, &eventHandler, "BestSolutionHandler",
           "Handles updates to the best solution found", eventExecCallback, nullptr));
   SCIP_CALL_ABORT(SCIPtransformProb(scip_));
-  SCIP_CALL_ABORT(SCIPcatchEvent(scip_, SCIP_EVENTTYPE_BESTSOLFOUND, eventHandler, nullptr, nullptr));
+  SCIP_CALL_ABORT(SCIPcatchEvent(scip_, SCIP_EVENTTYPE_BESTSOLFOUND | SCIP_EVENTTYPE_NODESOLVED,
+                                 eventHandler, (SCIP_EVENTDATA *)this, nullptr));
   if (!scipSolveStarted_)
   {
+    PhaseTimer timer(Phase::Solve);
     scipSolveStarted_ = true;
     SCIP_CALL_ABORT(SCIPsolve(scip_));
     scipSolveStarted_ = false;
   }
   solveTime_ = ElapsedTime();
   workerStatus_ = WorkerStatus::Idle;
+  scheduler_->Notify();
   printf("c %10.2lf    [%-10s]    RootWorker %ld\n",
          ElapsedTime(), "End", tid_);
 }
@@ -56,7 +68,6 @@ RootWorker::RootWorker(int _tid, Scheduler *_scheduler)
     : Worker(_tid, _scheduler), solveTime_(INF)
 {
   workerStatus_ = WorkerStatus::Busy;
-  highs_.setOptionValue("log_to_console", "false");
 }
 
 bool RootWorker::IsUnknown()
@@ -89,6 +100,14 @@ double RootWorker::GetFinalBestObj()
   return objValue;
 }
 
+void RootWorker::SyncSolution(const SCIP_EVENTTYPE _eventType)
+{
+  if (_eventType == SCIP_EVENTTYPE_BESTSOLFOUND)
+    SubmitBestSolution(nullptr);
+  else if (FetchPoolSolution(poolSolution_))
+    AddPoolSolution(poolSolution_);
+}
+
 double RootWorker::GetIncumbent()
 {
   return incumbentRoot.load();
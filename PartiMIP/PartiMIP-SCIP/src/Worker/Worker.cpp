@@ -16,15 +16,56 @@
 #include "Worker.h"
 
 Worker::Worker(int _tid, Scheduler *_scheduler)
-    : tid_(_tid), scheduler_(_scheduler),
+    : poolVersion_(0),
       workerStatus_(WorkerStatus::Idle),
       scip_(nullptr),
+      tid_(_tid),
       numVars_(0),
       numCons_(0),
-      scipSolveStarted_(false)
+      scipSolveStarted_(false),
+      scheduler_(_scheduler)
 {
 }
 
+bool Worker::FetchPoolSolution(vector<double> &_colValue)
+{
+  SolutionPool *pool = scheduler_->GetSolutionPool();
+  if (pool->GetVersion() == poolVersion_)
+    return false;
+  double obj;
+  return pool->GetBest(_colValue, obj, poolVersion_);
+}
+
+void Worker::SubmitBestSolution(MIPNode *_node)
+{
+  SCIP_SOL *bestsol = SCIPgetBestSol(scip_);
+  if (bestsol == nullptr)
+    return;
+  vector<double> solVals(numVars_);
+  SCIP_CALL_ABORT(SCIPgetSolVals(scip_, bestsol, numVars_, scipVars_.data(), solVals.data()));
+  scheduler_->SubmitSolution(_node, solVals.data(), numVars_, SCIPgetSolOrigObj(scip_, bestsol));
+}
+
+/* Before solving the solution is only stored (SCIPaddSol); while solving it
+   has to be checked against the current problem first (SCIPtrySol). */
+void Worker::AddSolution(const vector<double> &_colValue)
+{
+  SCIP_SOL *sol = nullptr;
+  SCIP_Bool stored = FALSE;
+  SCIP_CALL_ABORT(SCIPcreateOrigSol(scip_, &sol, nullptr));
+  SCIP_CALL_ABORT(SCIPsetSolVals(scip_, sol, numVars_, scipVars_.data(), const_cast<double *>(_colValue.data())));
+  if (SCIPgetStage(scip_) == SCIP_STAGE_SOLVING)
+    SCIP_CALL_ABORT(SCIPtrySolFree(scip_, &sol, FALSE, FALSE, TRUE, TRUE, TRUE, &stored));
+  else
+    SCIP_CALL_ABORT(SCIPaddSolFree(scip_, &sol, &stored));
+}
+
+void Worker::AddPoolSolution(const vector<double> &_colValue)
+{
+  AddSolution(_colValue);
+  scheduler_->GetSolutionPool()->RecordInjection();
+}
+
 void Worker::Terminate()
 {
   if (workerStatus_ == WorkerStatus::Busy && scipSolveStarted_ && scip_ != nullptr)
@@ -38,6 +79,14 @@ Worker::~Worker()
 }
 
 void Worker::ReleaseSCIP()
+{
+  ReleaseProblem();
+  if (scip_ != nullptr)
+    SCIP_CALL_ABORT(SCIPfree(&scip_));
+  scip_ = nullptr;
+}
+
+void Worker::ReleaseProblem()
 {
   for (auto &scipCons : scipCons_)
   {
@@ -56,9 +105,6 @@ void Worker::ReleaseSCIP()
       scipVar = nullptr;
     }
   }
-  if (scip_ != nullptr)
-    SCIP_CALL_ABORT(SCIPfree(&scip_));
-  scip_ = nullptr;
 }
 
 void Worker::SetPrecision()
@@ -73,133 +119,87 @@ void Worker::SetPrecision()
   }
 }
 
-void RootWorker::HighsToSCIP(const HighsModel &_highsmodel)
+/* The SCIP instance, with its plugins and parameters, lives as long as the
+   worker. Only the problem is rebuilt between nodes, and not even that when
+   the new node differs from the previous one in column bounds only. */
+void GeneralWorker::LoadModel(const HighsModel &_highsmodel)
 {
-  highs_.setOptionValue("log_to_console", "false");
-  highs_.passModel(_highsmodel);
-  highs_.setMatrixFormat(MatrixFormat::kRowwise);
-  SCIP_CALL_ABORT(SCIPcreate(&scip_));
-  SCIP_CALL_ABORT(SCIPincludeDefaultPlugins(scip_));
-  SCIP_CALL_ABORT(SCIPsetIntParam(scip_, "parallel/maxnthreads", 1));
-  SCIP_CALL_ABORT(SCIPsetIntParam(scip_, "display/verblevel", 0));
-  SCIP_CALL_ABORT(SCIPcreateProbBasic(
-      scip_, ("SCIP_worker" + to_string(tid_)).c_str()));
-
-  const HighsLp &lp = highs_.getLp();
-  numVars_ = lp.num_col_;
-  numCons_ = lp.num_row_;
-
-  const vector<double> &obj = lp.col_cost_;
-  const vector<double> &lb = lp.col_lower_;
-  const vector<double> &ub = lp.col_upper_;
-  const vector<HighsVarType> &varTypes = lp.integrality_;
-
-  const vector<double> &rowLb = lp.row_lower_;
-  const vector<double> &rowUb = lp.row_upper_;
-  const vector<int> &startIndices = lp.a_matrix_.start_;
-  const vector<int> &indices = lp.a_matrix_.index_;
-  const vector<double> &values = lp.a_matrix_.value_;
-
-  scipVars_.resize(numVars_, nullptr);
-  scipCons_.resize(numCons_, nullptr);
-
-  SCIP_VARTYPE defaultVarType = SCIP_VARTYPE_CONTINUOUS;
-  bool hasIntegerVars = (varTypes.size() == numVars_);
-  for (size_t i = 0; i < numVars_; ++i)
+  const HighsLp &lp = _highsmodel.lp_;
+  if (scip_ == nullptr)
+    CreateSCIP();
+  else if (SameModelButBounds(lp, loadedLp_))
   {
-    SCIP_VAR *var = nullptr;
-    SCIP_VARTYPE scipVarType = defaultVarType;
-
-    if (hasIntegerVars)
+    for (size_t i = 0; i < numVars_; ++i)
     {
-      scipVarType = (varTypes[i] == HighsVarType::kInteger)
-                        ? SCIP_VARTYPE_INTEGER
-                        : SCIP_VARTYPE_CONTINUOUS;
+      // Move the bound that keeps [lower, upper] non-empty first.
+      if (lp.col_lower_[i] > loadedLp_.col_upper_[i])
+      {
+        SCIP_CALL_ABORT(SCIPchgVarUb(scip_, scipVars_[i], lp.col_upper_[i]));
+        SCIP_CALL_ABORT(SCIPchgVarLb(scip_, scipVars_[i], lp.col_lower_[i]));
+      }
+      else
+      {
+        SCIP_CALL_ABORT(SCIPchgVarLb(scip_, scipVars_[i], lp.col_lower_[i]));
+        SCIP_CALL_ABORT(SCIPchgVarUb(scip_, scipVars_[i], lp.col_upper_[i]));
+      }
     }
-
-    SCIP_CALL_ABORT(SCIPcreateVarBasic(
-        scip_,
-        &var,
-        lp.col_names_[i].c_str(),
-        lb[i],
-        ub[i],
-        obj[i],
-        scipVarType));
-
-    SCIP_CALL_ABORT(SCIPaddVar(scip_, var));
-    scipVars_[i] = var;
+    loadedLp_.col_lower_ = lp.col_lower_;
+    loadedLp_.col_upper_ = lp.col_upper_;
+    reuseNum_++;
+    return;
   }
-
-  for (size_t i = 0; i < numCons_; ++i)
+  else
   {
-    size_t startIdx = startIndices[i];
-    size_t endIdx = (i == numCons_ - 1) ? indices.size() : startIndices[i + 1];
-
-    vector<SCIP_VAR *> consVars;
-    vector<double> consCoeffs;
-    consVars.reserve(endIdx - startIdx);
-    consCoeffs.reserve(endIdx - startIdx);
-
-    for (size_t j = startIdx; j < endIdx; ++j)
-    {
-      consVars.emplace_back(scipVars_[indices[j]]);
-      consCoeffs.emplace_back(values[j]);
-    }
-
-    SCIP_CONS *cons = nullptr;
-    SCIP_CALL_ABORT(SCIPcreateConsBasicLinear(
-        scip_,
-        &cons,
-        lp.row_names_[i].c_str(),
-        consVars.size(),
-        consVars.data(),
-        consCoeffs.data(),
-        rowLb[i],
-        rowUb[i]));
-
-    SCIP_CALL_ABORT(SCIPaddCons(scip_, cons));
-    scipCons_[i] = cons;
+    ReleaseProblem();
+    SCIP_CALL_ABORT(SCIPfreeProb(scip_));
   }
-
-  if (lp.sense_ == ObjSense::kMinimize)
-    SCIP_CALL_ABORT(SCIPsetObjsense(scip_, SCIP_OBJSENSE_MINIMIZE));
-  else if (lp.sense_ == ObjSense::kMaximize)
-    SCIP_CALL_ABORT(SCIPsetObjsense(scip_, SCIP_OBJSENSE_MAXIMIZE));
-
-  SCIP_CALL_ABORT(SCIPaddOrigObjoffset(scip_, lp.offset_));
+  HighsToSCIP(_highsmodel);
+  loadedLp_ = lp;
 }
 
-void GeneralWorker::HighsToSCIP(const Highs &_highs)
+/* A single-threaded SCIP instance with the default plugins and no output. */
+void Worker::CreateSCIP()
 {
   SCIP_CALL_ABORT(SCIPcreate(&scip_));
   SCIP_CALL_ABORT(SCIPincludeDefaultPlugins(scip_));
   SCIP_CALL_ABORT(SCIPsetIntParam(scip_, "parallel/maxnthreads", 1));
   SCIP_CALL_ABORT(SCIPsetIntParam(scip_, "display/verblevel", 0));
-  SCIP_CALL_ABORT(SCIPcreateProbBasic(
-      scip_, ("SCIP_worker" + to_string(tid_)).c_str()));
+}
 
-  numVars_ = _highs.getNumCol();
-  numCons_ = _highs.getNumRow();
-  HighsInt num_nz = _highs.getNumNz();
+void Worker::HighsToSCIP(const HighsModel &_highsmodel)
+{
+  numVars_ = _highsmodel.lp_.num_col_;
+  numCons_ = _highsmodel.lp_.num_row_;
+  BuildSCIPProblem(scip_, _highsmodel.lp_, "SCIP_worker" + to_string(tid_), scipVars_, scipCons_);
+}
 
-  scipVars_.resize(numVars_, nullptr);
-  scipCons_.resize(numCons_, nullptr);
+/* Shared by the thread workers and the worker processes. */
+void BuildSCIPProblem(
+    SCIP *_scip, const HighsLp &_lp, const string &_name,
+    vector<SCIP_VAR *> &_scipVars, vector<SCIP_CONS *> &_scipCons)
+{
+  SCIP_CALL_ABORT(SCIPcreateProbBasic(_scip, _name.c_str()));
 
-  const vector<double> &colCost = _highs.getLp().col_cost_;
-  const vector<double> &colLower = _highs.getLp().col_lower_;
-  const vector<double> &colUpper = _highs.getLp().col_upper_;
+  const size_t numVars = _lp.num_col_;
+  const size_t numCons = _lp.num_row_;
 
-  for (size_t i = 0; i < numVars_; ++i)
+  _scipVars.resize(numVars, nullptr);
+  _scipCons.resize(numCons, nullptr);
+
+  const vector<double> &colCost = _lp.col_cost_;
+  const vector<double> &colLower = _lp.col_lower_;
+  const vector<double> &colUpper = _lp.col_upper_;
+  const bool hasIntegerVars = (_lp.integrality_.size() == numVars);
+
+  for (size_t i = 0; i < numVars; ++i)
   {
     SCIP_VAR *var = nullptr;
     SCIP_VARTYPE scipVarType = SCIP_VARTYPE_CONTINUOUS;
-    HighsVarType integrality;
-    _highs.getColIntegrality(i, integrality);
-    if (integrality == HighsVarType::kInteger)
+    if (hasIntegerVars && _lp.integrality_[i] == HighsVarType::kInteger)
       scipVarType = SCIP_VARTYPE_INTEGER;
 
     SCIP_CALL_ABORT(SCIPcreateVarBasic(
-        scip_,
+        _scip,
         &var,
         "",
         colLower[i],
@@ -207,28 +207,25 @@ void GeneralWorker::HighsToSCIP(const Highs &_highs)
         colCost[i],
         scipVarType));
 
-    SCIP_CALL_ABORT(SCIPaddVar(scip_, var));
-    scipVars_[i] = var;
+    SCIP_CALL_ABORT(SCIPaddVar(_scip, var));
+    _scipVars[i] = var;
   }
 
-  vector<double> rowLower(numCons_);
-  vector<double> rowUpper(numCons_);
-  vector<HighsInt> rowStart(numCons_);
-  vector<HighsInt> rowIndex(num_nz);
-  vector<double> rowValue(num_nz);
-
-  HighsInt numRow;
-  _highs.getRows(0, numCons_ - 1, numRow, rowLower.data(), rowUpper.data(), 
-                 num_nz, rowStart.data(), rowIndex.data(), rowValue.data());
+  // The node model is stored column-wise; transpose a local copy for the rows.
+  HighsSparseMatrix rowMatrix = _lp.a_matrix_;
+  rowMatrix.ensureRowwise();
+  const vector<HighsInt> &rowStart = rowMatrix.start_;
+  const vector<HighsInt> &rowIndex = rowMatrix.index_;
+  const vector<double> &rowValue = rowMatrix.value_;
 
   vector<double> consCoeffs;
   vector<SCIP_VAR *> consVars;
-  consVars.reserve(numVars_);
-  consCoeffs.reserve(numVars_);
-  for (size_t i = 0; i < numCons_; ++i)
+  consVars.reserve(numVars);
+  consCoeffs.reserve(numVars);
+  for (size_t i = 0; i < numCons; ++i)
   {
     size_t startIdx = rowStart[i];
-    size_t endIdx = (i == numCons_ - 1) ? rowIndex.size() : rowStart[i + 1];
+    size_t endIdx = rowStart[i + 1];
     assert(endIdx <= rowValue.size());
 
     consVars.resize(endIdx - startIdx);
@@ -237,33 +234,51 @@ void GeneralWorker::HighsToSCIP(const Highs &_highs)
     size_t idx = 0;
     for (size_t j = startIdx; j < endIdx; ++j, ++idx)
     {
-      consVars[idx] = scipVars_[rowIndex[j]];
+      consVars[idx] = _scipVars[rowIndex[j]];
       consCoeffs[idx] = rowValue[j];
-      assert(j < rowValue.size());
     }
     SCIP_CONS *cons = nullptr;
     SCIP_CALL_ABORT(SCIPcreateConsBasicLinear(
-        scip_,
+        _scip,
         &cons,
         "",
         consVars.size(),
         consVars.data(),
         consCoeffs.data(),
-        rowLower[i],
-        rowUpper[i]));
+        _lp.row_lower_[i],
+        _lp.row_upper_[i]));
 
-    SCIP_CALL_ABORT(SCIPaddCons(scip_, cons));
-    scipCons_[i] = cons;
+    SCIP_CALL_ABORT(SCIPaddCons(_scip, cons));
+    _scipCons[i] = cons;
   }
 
-  ObjSense sense;
-  _highs.getObjectiveSense(sense);
-  if (sense == ObjSense::kMinimize)
-    SCIP_CALL_ABORT(SCIPsetObjsense(scip_, SCIP_OBJSENSE_MINIMIZE));
-  else if (sense == ObjSense::kMaximize)
-    SCIP_CALL_ABORT(SCIPsetObjsense(scip_, SCIP_OBJSENSE_MAXIMIZE));
+  if (_lp.sense_ == ObjSense::kMinimize)
+    SCIP_CALL_ABORT(SCIPsetObjsense(_scip, SCIP_OBJSENSE_MINIMIZE));
+  else if (_lp.sense_ == ObjSense::kMaximize)
+    SCIP_CALL_ABORT(SCIPsetObjsense(_scip, SCIP_OBJSENSE_MAXIMIZE));
 
-  double offset;
-  _highs.getObjectiveOffset(offset);
-  SCIP_CALL_ABORT(SCIPaddOrigObjoffset(scip_, offset));
+  SCIP_CALL_ABORT(SCIPaddOrigObjoffset(_scip, _lp.offset_));
 }
+
+HighsModelStatus SCIPStatusToHighs(const SCIP_STATUS _status)
+{
+  switch (_status)
+  {
+  case SCIP_STATUS_OPTIMAL:
+    return HighsModelStatus::kOptimal;
+  case SCIP_STATUS_INFEASIBLE:
+    return HighsModelStatus::kInfeasible;
+  case SCIP_STATUS_INFORUNBD:
+    return HighsModelStatus::kUnboundedOrInfeasible;
+  case SCIP_STATUS_UNBOUNDED:
+    return HighsModelStatus::kUnbounded;
+  case SCIP_STATUS_TIMELIMIT:
+    return HighsModelStatus::kTimeLimit;
+  case SCIP_STATUS_MEMLIMIT:
+    return HighsModelStatus::kMemoryLimit;
+  case SCIP_STATUS_USERINTERRUPT:
+    return HighsModelStatus::kInterrupt;
+  default:
+    return HighsModelStatus::kUnknown;
+  }
+}
\ No newline at end of file
@@ -16,10 +16,19 @@
 #pragma once
 #include "../Scheduler/Scheduler.h"
 #include "../utils/header.h"
+#include "Profiler/Profiler.h"
+#include "Remote/Channel.h"
+#include "Worker/ModelReuse.h"
 
 class Scheduler;
 class MIPNode;
 
+/* Builds a node model as the problem of _scip, which must have none. */
+void BuildSCIPProblem(
+    SCIP *_scip, const HighsLp &_lp, const string &_name,
+    vector<SCIP_VAR *> &_scipVars, vector<SCIP_CONS *> &_scipCons);
+HighsModelStatus SCIPStatusToHighs(const SCIP_STATUS _status);
+
 class Worker
 {
 public:
@@ -27,14 +36,23 @@ public:
   virtual void Terminate();
   virtual bool HaveIncumbent() = 0;
   virtual double GetIncumbent() = 0;
+  virtual void SyncSolution(const SCIP_EVENTTYPE _eventType) = 0;
   Worker(int _tid, Scheduler *_scheduler);
-  ~Worker();
+  virtual ~Worker();
   inline size_t GetTid() { return tid_; }
   inline bool IsFeasible() { return SCIPgetBestSol(scip_) != nullptr; }
 
 protected:
   void SetPrecision();
+  void CreateSCIP();
+  void HighsToSCIP(const HighsModel &_highsmodel);
   void ReleaseSCIP();
+  void ReleaseProblem();
+  bool FetchPoolSolution(vector<double> &_colValue);
+  void SubmitBestSolution(MIPNode *_node);
+  void AddSolution(const vector<double> &_colValue);
+  void AddPoolSolution(const vector<double> &_colValue);
+  size_t poolVersion_;
   WorkerStatus workerStatus_;
   SCIP *scip_;
   size_t tid_;
@@ -50,8 +68,7 @@ class RootWorker : public Worker
 {
 private:
   double solveTime_;
-  void HighsToSCIP(const HighsModel &_highsmodel);
-  Highs highs_;
+  vector<double> poolSolution_;
 
 public:
   void Run();
@@ -63,6 +80,7 @@ public:
   double GetFinalBestObj();
   bool HaveIncumbent();
   double GetIncumbent();
+  void SyncSolution(const SCIP_EVENTTYPE _eventType);
   double GetSolveTime() const { return solveTime_; }
   void PrintResult();
   inline bool IsDone() { return workerStatus_ == WorkerStatus::Idle; }
@@ -80,18 +98,67 @@ public:
   void Idle();
   bool HaveIncumbent();
   double GetIncumbent();
-  inline bool IsIdle() { return workerStatus_ == WorkerStatus::Idle; }
-  inline void SetPhase2() { phase2_.store(true); }
+  void SyncSolution(const SCIP_EVENTTYPE _eventType);
+  virtual bool IsIdle() { return workerStatus_ == WorkerStatus::Idle; }
+  void SetPhase2();
+  inline double GetSetupTime() const { return setupTime_; }
+  inline double GetSolveTime() const { return solveTime_; }
+  inline size_t GetNodeNum() const { return nodeNum_; }
+  inline size_t GetReuseNum() const { return reuseNum_; }
 
-private:
-  bool terminated_;
+protected:
+  atomic<bool> terminated_;
   MIPNode *node_;
   atomic<bool> endRuning;
   atomic<bool> phase2_;
+  boost::mutex mutexWakeUp_;
+  boost::condition_variable condWakeUp_;
+  double idleStartTime_;
+  vector<double> poolSolution_;
+  vector<double> warmStart_;
+  /* The model currently loaded into scip_. */
+  HighsLp loadedLp_;
+  double setupTime_;
+  double solveTime_;
+  size_t nodeNum_;
+  size_t reuseNum_;
 
+  void WaitWakeUp();
+  void RequestNode();
+  bool PresolveNode();
   void DealResult();
-  void HighsToSCIP(const Highs &_highs);
+  void LoadModel(const HighsModel &_highsmodel);
   void ObjCut();
   void SetCallback();
   void SetParameter();
+  bool FetchSolution(vector<double> &_colValue);
+};
+
+/* Stands in for a worker process that connected to the coordinator's
+   socket. It takes nodes from the tree like a thread worker and has the
+   worker process solve them. A worker process that goes away leaves its
+   node to be run again, and the slot waits for the next one to connect. */
+class RemoteWorker : public GeneralWorker
+{
+public:
+  void Run();
+  RemoteWorker(int _tid, Scheduler *_scheduler, const int _listenFd);
+  bool IsIdle() { return connected_ && GeneralWorker::IsIdle(); }
+  inline size_t GetConnectNum() const { return connectNum_; }
+  inline size_t GetLostNum() const { return lostNum_; }
+  inline size_t GetBytes() const { return channel_.GetBytesSent() + channel_.GetBytesReceived(); }
+
+private:
+  int listenFd_;
+  Channel channel_;
+  atomic<bool> connected_;
+  size_t connectNum_;
+  size_t lostNum_;
+
+  bool Handshake();
+  double GetObjLimit();
+  bool SolveRemote(
+      HighsModelStatus &_status, bool &_haveIncumbent,
+      HighsSolution &_solution, double &_obj);
+  void Disconnect();
 };
\ No newline at end of file
@@ -83,7 +83,7 @@ enum NodeStatus
   End
 };
 
-inline const double ElapsedTime()
+inline double ElapsedTime()
 {
   return std::chrono::duration_cast<std::chrono::duration<double>>(
              std::chrono::steady_clock::now() - timeStart)
@@ -92,3 +92,5 @@ inline const double ElapsedTime()
 void RecreateDirectory(const string &_path);
 const char *NodeStatusToString(const NodeStatus &_nodeStatus);
 const char *ProblemStatusToString(const ProblemStatus &_problemStatus);
+uint64_t MixHash(uint64_t _hash);
+uint64_t HashBytes(const char *_data, const size_t _size);
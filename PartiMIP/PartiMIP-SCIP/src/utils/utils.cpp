@@ -14,6 +14,7 @@
 
 =====================================================================================*/
 #include "header.h"
+#include <cstring>
 
 void RecreateDirectory(const string &_path)
 {
@@ -58,4 +59,31 @@ const char *ProblemStatusToString(const ProblemStatus &_problemStatus)
   default:
     return "Unknown";
   }
+}
+
+uint64_t MixHash(uint64_t _hash)
+{
+  _hash ^= _hash >> 33;
+  _hash *= 0xff51afd7ed558ccdULL;
+  _hash ^= _hash >> 33;
+  _hash *= 0xc4ceb9fe1a85ec53ULL;
+  _hash ^= _hash >> 33;
+  return _hash;
+}
+
+/* Fast and well mixed, but not cryptographic. */
+uint64_t HashBytes(const char *_data, const size_t _size)
+{
+  uint64_t hash = MixHash(_size + 1);
+  size_t pos = 0;
+  for (; pos + 8 <= _size; pos += 8)
+  {
+    uint64_t word;
+    memcpy(&word, _data + pos, 8);
+    hash = (hash ^ word) * 0x9e3779b97f4a7c15ULL;
+    hash = (hash << 31) | (hash >> 33);
+  }
+  uint64_t word = 0;
+  memcpy(&word, _data + pos, _size - pos);
+  return MixHash(hash ^ word);
 }
\ No newline at end of file